@@ -45,15 +45,22 @@ DEFINES += QT_DEPRECATED_WARNINGS
 CONFIG += c++1z
 
 SOURCES += \
+    src/assessmentsnapshot.cpp \
     src/asset.cpp \
     src/assetview.cpp \
     src/cci.cpp \
+    src/ccilookup.cpp \
     src/cklcheck.cpp \
     src/common.cpp \
     src/control.cpp \
+    src/dbconnections.cpp \
     src/dbmanager.cpp \
+    src/dbquery.cpp \
+    src/dbtransaction.cpp \
+    src/entitycache.cpp \
     src/family.cpp \
     src/help.cpp \
+    src/logwriter.cpp \
     src/main.cpp \
     src/stig.cpp \
     src/stigcheck.cpp \
@@ -61,6 +68,7 @@ SOURCES += \
     src/stigqter.cpp \
     src/supplement.cpp \
     src/tabviewwidget.cpp \
+    src/vulndescriptionscanner.cpp \
     src/worker.cpp \
     src/workerassetadd.cpp \
     src/workerassetdelete.cpp \
@@ -82,24 +90,33 @@ SOURCES += \
     src/workerpoamreport.cpp \
     src/workerstigadd.cpp \
     src/workerstigdelete.cpp \
-    src/workerstigdownload.cpp
+    src/workerstigdownload.cpp \
+    src/ziparchive.cpp
 
 HEADERS += \
+    src/assessmentsnapshot.h \
     src/asset.h \
     src/assetview.h \
     src/cci.h \
+    src/ccilookup.h \
     src/cklcheck.h \
     src/common.h \
     src/control.h \
+    src/dbconnections.h \
     src/dbmanager.h \
+    src/dbquery.h \
+    src/dbtransaction.h \
+    src/entitycache.h \
     src/family.h \
     src/help.h \
+    src/logwriter.h \
     src/stig.h \
     src/stigcheck.h \
     src/stigedit.h \
     src/stigqter.h \
     src/supplement.h \
     src/tabviewwidget.h \
+    src/vulndescriptionscanner.h \
     src/worker.h \
     src/workerassetadd.h \
     src/workerassetdelete.h \
@@ -121,7 +138,8 @@ HEADERS += \
     src/workerpoamreport.h \
     src/workerstigadd.h \
     src/workerstigdelete.h \
-    src/workerstigdownload.h
+    src/workerstigdownload.h \
+    src/ziparchive.h
 
 FORMS += \
     src/assetview.ui \
@@ -134,6 +152,15 @@ qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = $${PREFIX}/bin
 !isEmpty(target.path): INSTALLS += target
 
+# Query timing and the slow-query log (Help > Query Diagnostics).
+# Enable with: qmake CONFIG+=query_stats
+CONFIG(query_stats) {
+    DEFINES += STIGQTER_QUERY_STATS
+    SOURCES += src/querydiagnostics.cpp src/querystats.cpp
+    HEADERS += src/querydiagnostics.h src/querystats.h
+    FORMS += src/querydiagnostics.ui
+}
+
 LIBS += -lzip -lxlsxwriter -lz
 
 INCLUDEPATH = src
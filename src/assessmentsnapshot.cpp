@@ -0,0 +1,195 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "assessmentsnapshot.h"
+
+/**
+ * @class AssessmentSnapshot
+ * @brief A read-only copy of the assessment (the @a Assets, their
+ * @a STIGs and @a CKLChecks, and the RMF @a Controls and @a CCIs the
+ * checks map to) for building reports.
+ *
+ * DbManager::GetAssessmentSnapshot() loads it in one read
+ * transaction with a few bulk queries. A report that walks the
+ * Asset → STIG → rule → CCI → Control graph through the snapshot
+ * does not query the database at all. Only the rules of STIGs mapped
+ * to an asset are loaded.
+ *
+ * The eMASS and CMRS reports are built from a snapshot, and one
+ * snapshot may be shared when several are built from the same data.
+ * The findings and POA&M reports stream from the database instead.
+ *
+ * The small tables are kept as rows of their entity types. The
+ * @a STIGChecks and @a CKLChecks are kept as columns indexed by row,
+ * with their text interned in @a strings so that repeated finding
+ * details and comments are stored once. Relationships are
+ * @a SnapshotAdjacency lists between rows.
+ *
+ * The snapshot is never modified after it is loaded, so one snapshot
+ * may be read by several report workers on different threads.
+ */
+
+/**
+ * @class SnapshotAdjacency
+ * @brief A one-to-many relationship between the rows of two
+ * @a AssessmentSnapshot tables, in compressed sparse row form.
+ *
+ * The targets of source row @c r are
+ * targets[offsets[r]] … targets[offsets[r + 1] - 1].
+ */
+
+/**
+ * @brief SnapshotAdjacency::At
+ * @param row
+ * @return The target rows of the source @a row.
+ */
+SnapshotAdjacency::Range SnapshotAdjacency::At(int row) const
+{
+    const int *data = targets.constData();
+    return {data + offsets.at(row), data + offsets.at(row + 1)};
+}
+
+/**
+ * @brief SnapshotAdjacency::FromPairs
+ * @param rows
+ * @param pairs
+ * @return The relationship from each of the @a rows source rows to
+ * the targets in @a pairs of (source, target).
+ *
+ * The targets of each source keep their order in @a pairs.
+ */
+SnapshotAdjacency SnapshotAdjacency::FromPairs(int rows, const QVector<QPair<int, int>> &pairs)
+{
+    SnapshotAdjacency ret;
+    ret.offsets.fill(0, rows + 1);
+    for (const auto &pair : pairs)
+        ret.offsets[pair.first + 1]++;
+    for (int i = 0; i < rows; i++)
+        ret.offsets[i + 1] += ret.offsets.at(i);
+
+    ret.targets.resize(pairs.count());
+    QVector<int> next = ret.offsets;
+    for (const auto &pair : pairs)
+        ret.targets[next[pair.first]++] = pair.second;
+    return ret;
+}
+
+/**
+ * @brief AssessmentSnapshot::String
+ * @param index
+ * @return The interned text at @a index.
+ */
+const QString &AssessmentSnapshot::String(int index) const
+{
+    return strings.at(index);
+}
+
+/**
+ * @brief AssessmentSnapshot::ControlAt
+ * @param control
+ * @return The @a Control at row @a control, or the default
+ * @a Control for a @a CCI without one (row -1).
+ */
+const Control &AssessmentSnapshot::ControlAt(int control) const
+{
+    static const Control unmapped;
+    return control < 0 ? unmapped : controls.at(control);
+}
+
+/**
+ * @brief AssessmentSnapshot::ControlName
+ * @param control
+ * @return PrintControl() of ControlAt(@a control).
+ */
+const QString &AssessmentSnapshot::ControlName(int control) const
+{
+    return String(control < 0 ? unmappedControlName : controlNames.at(control));
+}
+
+/**
+ * @brief AssessmentSnapshot::CKLCheckSTIG
+ * @param row
+ * @return The row of the @a STIG of the @a CKLCheck at @a row.
+ */
+int AssessmentSnapshot::CKLCheckSTIG(int row) const
+{
+    return stigChecks.stig.at(cklChecks.stigCheck.at(row));
+}
+
+/**
+ * @brief AssessmentSnapshot::CKLCheckLessThan
+ * @param left
+ * @param right
+ * @return @c True when the @a CKLCheck at row @a left sorts before
+ * the one at row @a right: highest severity first, then by rule, as
+ * CKLCheck::operator<() orders them.
+ */
+bool AssessmentSnapshot::CKLCheckLessThan(int left, int right) const
+{
+    const quint8 l = cklChecks.severity.at(left);
+    const quint8 r = cklChecks.severity.at(right);
+    if (l == r)
+        return String(stigChecks.rule.at(cklChecks.stigCheck.at(left))).compare(String(stigChecks.rule.at(cklChecks.stigCheck.at(right)))) < 0;
+    return r < l;
+}
+
+/**
+ * @brief AssessmentSnapshot::CKLCheckAt
+ * @param row
+ * @return The @a CKLCheck at @a row, carrying the severity and rule
+ * of its @a STIGCheck.
+ */
+CKLCheck AssessmentSnapshot::CKLCheckAt(int row) const
+{
+    CKLCheck ret;
+    ret.id = cklChecks.id.at(row);
+    ret.assetId = assets.at(cklChecks.asset.at(row)).id;
+    ret.stigCheckId = stigChecks.id.at(cklChecks.stigCheck.at(row));
+    ret.status = static_cast<Status>(cklChecks.status.at(row));
+    ret.findingDetails = String(cklChecks.findingDetails.at(row));
+    ret.comments = String(cklChecks.comments.at(row));
+    ret.severityOverride = static_cast<Severity>(cklChecks.severityOverride.at(row));
+    ret.severityJustification = String(cklChecks.severityJustification.at(row));
+    const int check = cklChecks.stigCheck.at(row);
+    ret.SetSTIGCheckKey(static_cast<Severity>(stigChecks.severity.at(check)), String(stigChecks.rule.at(check)));
+    return ret;
+}
+
+/**
+ * @brief AssessmentSnapshot::STIGCheckAt
+ * @param row
+ * @return The @a STIGCheck at @a row. Only the fields held by the
+ * snapshot (the ones the reports print) and the @a CCI ids are set.
+ */
+STIGCheck AssessmentSnapshot::STIGCheckAt(int row) const
+{
+    STIGCheck ret;
+    ret.id = stigChecks.id.at(row);
+    ret.stigId = stigs.at(stigChecks.stig.at(row)).id;
+    ret.severity = static_cast<Severity>(stigChecks.severity.at(row));
+    ret.rule = String(stigChecks.rule.at(row));
+    ret.ruleVersion = String(stigChecks.ruleVersion.at(row));
+    ret.vulnNum = String(stigChecks.vulnNum.at(row));
+    ret.title = String(stigChecks.title.at(row));
+    ret.vulnDiscussion = String(stigChecks.vulnDiscussion.at(row));
+    ret.fix = String(stigChecks.fix.at(row));
+    for (int cci : stigCheckCCIs.At(row))
+        ret.cciIds.append(ccis.at(cci).id);
+    return ret;
+}
@@ -0,0 +1,113 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASSESSMENTSNAPSHOT_H
+#define ASSESSMENTSNAPSHOT_H
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include "asset.h"
+#include "cci.h"
+#include "cklcheck.h"
+#include "control.h"
+#include "stig.h"
+#include "stigcheck.h"
+
+struct SnapshotAdjacency
+{
+    struct Range
+    {
+        const int *first;
+        const int *last;
+        [[nodiscard]] const int *begin() const { return first; }
+        [[nodiscard]] const int *end() const { return last; }
+        [[nodiscard]] int count() const { return static_cast<int>(last - first); }
+        [[nodiscard]] bool isEmpty() const { return first == last; }
+    };
+
+    QVector<int> offsets; /**< One more entry than there are source rows */
+    QVector<int> targets; /**< Target rows, grouped by source row */
+
+    [[nodiscard]] Range At(int row) const;
+    [[nodiscard]] static SnapshotAdjacency FromPairs(int rows, const QVector<QPair<int, int>> &pairs);
+};
+
+struct SnapshotSTIGChecks
+{
+    QVector<int> id;
+    QVector<int> stig; /**< Row in AssessmentSnapshot::stigs */
+    QVector<quint8> severity;
+    QVector<int> rule; /**< Index in AssessmentSnapshot::strings, as are the other text columns */
+    QVector<int> ruleVersion;
+    QVector<int> vulnNum;
+    QVector<int> title;
+    QVector<int> vulnDiscussion;
+    QVector<int> fix;
+    QVector<int> same; /**< First row that compares equal (same rule and rule version) */
+    [[nodiscard]] int Count() const { return static_cast<int>(id.count()); }
+};
+
+struct SnapshotCKLChecks
+{
+    QVector<int> id;
+    QVector<int> asset; /**< Row in AssessmentSnapshot::assets */
+    QVector<int> stigCheck; /**< Row in AssessmentSnapshot::stigChecks */
+    QVector<quint8> status;
+    QVector<quint8> severityOverride;
+    QVector<quint8> severity; /**< Effective severity */
+    QVector<int> findingDetails; /**< Index in AssessmentSnapshot::strings, as are the other text columns */
+    QVector<int> comments;
+    QVector<int> severityJustification;
+    [[nodiscard]] int Count() const { return static_cast<int>(id.count()); }
+};
+
+class AssessmentSnapshot
+{
+public:
+    [[nodiscard]] const QString &String(int index) const;
+    [[nodiscard]] const Control &ControlAt(int control) const;
+    [[nodiscard]] const QString &ControlName(int control) const;
+    [[nodiscard]] int CKLCheckSTIG(int row) const;
+    [[nodiscard]] bool CKLCheckLessThan(int left, int right) const;
+    [[nodiscard]] CKLCheck CKLCheckAt(int row) const;
+    [[nodiscard]] STIGCheck STIGCheckAt(int row) const;
+
+    QVector<QString> strings; /**< Interned text */
+
+    QVector<Asset> assets; /**< In the order of DbManager::GetAssets() */
+    QVector<STIG> stigs; /**< In the order of DbManager::GetSTIGs() */
+    QVector<Control> controls; /**< In the order of DbManager::GetControls() */
+    QVector<int> controlNames; /**< PrintControl() of each control */
+    QVector<CCI> ccis; /**< In the order of DbManager::GetCCIs() */
+    QVector<int> cciControls; /**< Row of each CCI's control, or -1 */
+    SnapshotSTIGChecks stigChecks; /**< Of the STIGs mapped to an Asset, ordered by id */
+    SnapshotCKLChecks cklChecks; /**< Ordered by id */
+    int unmappedControlName{-1};
+    bool emassImport{false};
+
+    SnapshotAdjacency assetSTIGs; /**< Asset → mapped STIGs */
+    SnapshotAdjacency assetCKLChecks; /**< Asset → CKLChecks, by STIG and then id */
+    SnapshotAdjacency controlCCIs; /**< Control → CCIs */
+    SnapshotAdjacency cciCKLChecks; /**< CCI → CKLChecks of the STIGChecks mapped to it */
+    SnapshotAdjacency stigCheckCCIs; /**< STIGCheck → CCIs */
+};
+
+#endif // ASSESSMENTSNAPSHOT_H
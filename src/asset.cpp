@@ -42,95 +42,13 @@
 
 /**
  * @brief Asset::Asset
- * @param parent
  *
  * The default constructor sets up an empty Asset.
  */
-Asset::Asset(QObject *parent) : QObject(parent)
+Asset::Asset()
 {
 }
 
-/**
- * @brief Asset::Asset
- * @param asset
- *
- * Copy constructor.
- */
-Asset::Asset(const Asset &asset) : Asset(asset.parent())
-{
-    *this = asset;
-}
-
-/**
- * @brief Asset::Asset
- * @param asset
- *
- * Move constructor.
- */
-Asset::Asset(Asset &&orig) noexcept :
-    id(orig.id),
-    assetType(std::move(orig.assetType)),
-    hostName(std::move(orig.hostName)),
-    hostIP(std::move(orig.hostIP)),
-    hostMAC(std::move(orig.hostMAC)),
-    hostFQDN(std::move(orig.hostFQDN)),
-    techArea(std::move(orig.techArea)),
-    targetKey(std::move(orig.targetKey)),
-    marking(std::move(orig.marking)),
-    targetComment(std::move(orig.targetComment)),
-    webOrDB(orig.webOrDB),
-    webDbSite(std::move(orig.webDbSite)),
-    webDbInstance(std::move(orig.webDbInstance))
-{
-}
-
-/**
- * @brief Asset::operator=
- * @param right
- * @return copied Asset
- */
-Asset &Asset::operator=(const Asset &right)
-{
-    if (this != &right)
-    {
-        id = right.id;
-        assetType = right.assetType;
-        hostName = right.hostName;
-        hostIP = right.hostIP;
-        hostMAC = right.hostMAC;
-        hostFQDN = right.hostFQDN;
-        techArea = right.techArea;
-        targetKey = right.targetKey;
-        marking = right.marking;
-        targetComment = right.targetComment;
-        webOrDB = right.webOrDB;
-        webDbSite = right.webDbSite;
-        webDbInstance = right.webDbInstance;
-    }
-    return *this;
-}
-
-Asset &Asset::operator=(Asset &&orig) noexcept
-{
-    if (this != &orig)
-    {
-        id = orig.id;
-        assetType = std::move(orig.assetType);
-        hostName = std::move(orig.hostName);
-        hostIP = std::move(orig.hostIP);
-        hostMAC = std::move(orig.hostMAC);
-        hostFQDN = std::move(orig.hostFQDN);
-        techArea = std::move(orig.techArea);
-        targetKey = std::move(orig.targetKey);
-        marking = std::move(orig.marking);
-        targetComment = std::move(orig.targetComment);
-        webOrDB = orig.webOrDB;
-        webDbSite = std::move(orig.webDbSite);
-        webDbInstance = std::move(orig.webDbInstance);
-    }
-    return *this;
-}
-
 /**
  * @brief Asset::GetSTIGs
  * @return list of STIGs associated with this Asset
@@ -21,23 +21,18 @@
 #define ASSET_H
 
 #include <QList>
-#include <QObject>
+#include <QMetaType>
 #include <QString>
+#include <QVector>
 
 #include "stig.h"
 
 class CKLCheck;
 
-class Asset : public QObject
+class Asset
 {
-    Q_OBJECT
 public:
-    Asset(const Asset &asset);
-    Asset(Asset &&orig) noexcept;
-    ~Asset() override = default;
-    explicit Asset(QObject *parent = nullptr);
-    Asset& operator=(const Asset &right);
-    Asset& operator=(Asset &&orig) noexcept;
+    Asset();
     QVector<STIG> GetSTIGs() const;
     QVector<CKLCheck> GetCKLChecks(const STIG *stig = nullptr) const;
     int id{-1}; /**< Database ID */
@@ -79,6 +74,7 @@ public:
     bool operator==(const Asset &right) const;
 };
 
+Q_DECLARE_TYPEINFO(Asset, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(Asset);
 
 [[nodiscard]] QString PrintAsset(const Asset &asset);
@@ -66,7 +66,8 @@ AssetView::AssetView(Asset &asset, QWidget *parent) :
     _asset(std::move(asset)),
     _justification(),
     _updateStatus(false),
-    _isFiltered(false)
+    _isFiltered(false),
+    _isSearched(false)
 {
     ui->setupUi(this);
 
@@ -92,6 +93,13 @@ AssetView::AssetView(Asset &asset, QWidget *parent) :
     _timerChecks.setSingleShot(true);
     connect(&_timerChecks, SIGNAL(timeout()), this, SLOT(CountChecks()));
 
+    /*
+     * The check search runs once the user stops typing, as defined in
+     * SearchChecks()
+     */
+    _timerSearch.setSingleShot(true);
+    connect(&_timerSearch, SIGNAL(timeout()), this, SLOT(SearchChecksHelper()));
+
     /*
      * Shortcuts for quickly setting compliance state of selected
      * check(s):
@@ -134,6 +142,7 @@ void AssetView::DisableInput()
     ui->txtFQDN->setEnabled(false);
     ui->txtMarking->setEnabled(false);
     ui->txtSTIGFilter->setEnabled(false);
+    ui->txtCheckSearch->setEnabled(false);
     ui->lstSTIGs->setEnabled(false);
     ui->cboBoxFilterStatus->setEnabled(false);
     ui->cboBoxFilterSeverity->setEnabled(false);
@@ -179,6 +188,7 @@ void AssetView::EnableInput()
     ui->txtFQDN->setEnabled(true);
     ui->txtMarking->setEnabled(true);
     ui->txtSTIGFilter->setEnabled(true);
+    ui->txtCheckSearch->setEnabled(true);
     ui->lstSTIGs->setEnabled(true);
     ui->cboBoxFilterStatus->setEnabled(true);
     ui->cboBoxFilterSeverity->setEnabled(true);
@@ -250,11 +260,16 @@ void AssetView::CountChecks()
  */
 void AssetView::ShowChecks(bool countOnly)
 {
-    if (!countOnly)
-        ui->lstChecks->clear();
-    int total = 0; //total checks
-    int open = 0; //findings
-    int closed = 0; //passed checks
+    //the counts come from the compliance summary rather than from the checks
+    DbManager db;
+    const ComplianceCounts counts = db.GetComplianceCounts(&_asset);
+    ui->lblTotalChecks->setText(QString::number(counts.Total()));
+    ui->lblOpen->setText(QString::number(counts.Count(Status::Open)));
+    ui->lblNotAFinding->setText(QString::number(counts.Count(Status::NotAFinding)));
+    if (countOnly)
+        return;
+
+    ui->lstChecks->clear();
 
     QString filterSeverityText = ui->cboBoxFilterSeverity->currentText();
     Severity filterSeverity = GetSeverity(ui->cboBoxFilterSeverity->currentText());
@@ -263,40 +278,27 @@ void AssetView::ShowChecks(bool countOnly)
 
     for (const CKLCheck &c : _asset.GetCKLChecks())
     {
-        total++;
-        switch (c.status)
-        {
-        case Status::NotAFinding:
-            closed++;
-            break;
-        case Status::Open:
-            open++;
-            break;
-        default:
-            break;
-        }
         //update the list of CKL checks
         if (
-                !countOnly //perform filtering
-                && //severity filter
+                //severity filter
                 ((filterSeverityText == QStringLiteral("All")) ||
                  (filterSeverity == c.GetSeverity()))
                 && //status filter
                 ((filterStatusText == QStringLiteral("All")) ||
                  (filterStatus == c.status))
+                && //text search
+                (!_isSearched || _searchHits.contains(c.id))
             )
         {
             QListWidgetItem *i = new QListWidgetItem(PrintCKLCheck(c));
             ui->lstChecks->addItem(i);
+            if (_isSearched)
+                i->setToolTip(_searchHits.value(c.id));
             i->setData(Qt::UserRole, QVariant::fromValue<CKLCheck>(c));
-            SetItemColor(i, c.status, (c.severityOverride == Severity::none) ? c.GetSTIGCheck().severity : c.severityOverride);
+            SetItemColor(i, c.status, c.GetSeverity());
         }
     }
-    ui->lblTotalChecks->setText(QString::number(total));
-    ui->lblOpen->setText(QString::number(open));
-    ui->lblNotAFinding->setText(QString::number(closed));
-    if (!countOnly)
-        ui->lstChecks->sortItems();
+    ui->lstChecks->sortItems();
 }
 
 /**
@@ -525,6 +527,47 @@ void AssetView::FilterSTIGs(const QString &text)
     ui->lstSTIGs->blockSignals(false);
 }
 
+/**
+ * @brief AssetView::SearchChecks
+ * @param text
+ *
+ * Detects when the user has changed the search text and been idle
+ * for a while.
+ */
+void AssetView::SearchChecks(const QString &text)
+{
+    Q_UNUSED(text)
+    //avoid a full-text search for every keypress. Wait for 3/10 of a second before searching
+    _timerSearch.start(300);
+}
+
+/**
+ * @brief AssetView::SearchChecksHelper
+ *
+ * Filter the check list to every check whose rule text or answers
+ * contain the search text. The matching passage is shown as each
+ * check's tool tip.
+ */
+void AssetView::SearchChecksHelper()
+{
+    const QString text = ui->txtCheckSearch->text();
+    if (text.length() > 2)
+    {
+        DbManager db;
+        _isSearched = true;
+        _searchHits.clear();
+        for (const SearchHit &hit : db.Search(text, -1, &_asset))
+            _searchHits.insert(hit.cklCheckId, hit.snippet);
+        ShowChecks();
+    }
+    else if (_isSearched)
+    {
+        _isSearched = false;
+        _searchHits.clear();
+        ShowChecks();
+    }
+}
+
 /**
  * @brief AssetView::ImportXCCDF
  *
@@ -912,8 +955,7 @@ void AssetView::UpdateCKLStatus(const QString &val)
         for (QListWidgetItem *i : selectedItems)
         {
             auto cc = i->data(Qt::UserRole).value<CKLCheck>();
-            STIGCheck sc = cc.GetSTIGCheck();
-            SetItemColor(i, stat, (cc.severityOverride == Severity::none) ? sc.severity : cc.severityOverride);
+            SetItemColor(i, stat, cc.GetSeverity());
         }
         _updateStatus = true;
         UpdateCKL();
@@ -25,6 +25,7 @@
 #include "stigcheck.h"
 #include "stigqter.h"
 
+#include <QHash>
 #include <QLabel>
 #include <QListWidget>
 #include <QProgressBar>
@@ -71,6 +72,8 @@ private Q_SLOTS:
     void RenameAsset(const QString &name = QString());
     void SaveCKL(const QString &name = QString());
     void SaveCKLs(const QString &dir = QString());
+    void SearchChecks(const QString &text);
+    void SearchChecksHelper();
     void UpdateChecks();
     void UpdateCKL();
     void UpdateCKLHelper();
@@ -85,11 +88,14 @@ private:
     QString _justification;
     QTimer _timer;
     QTimer _timerChecks;
+    QTimer _timerSearch;
     QList<QShortcut*> _shortcuts;
     bool _updateStatus;
     void KeyShortcut(Status action);
     void SetItemColor(QListWidgetItem *i, Status stat, Severity sev);
     bool _isFiltered;
+    bool _isSearched;
+    QHash<int, QString> _searchHits;
 };
 
 #endif // ASSETVIEW_H
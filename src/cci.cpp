@@ -36,11 +36,10 @@
 
 /**
  * @brief CCI::CCI
- * @param parent
  *
  * Default constructor.
  */
-CCI::CCI(QObject *parent) : QObject(parent),
+CCI::CCI() :
     id(-1),
     controlId(-1),
     cci(0),
@@ -65,18 +64,6 @@ CCI::CCI(QObject *parent) : QObject(parent),
 {
 }
 
-/**
- * @overload CCI::CCI(const CCI &right)
- * @brief CCI::CCI
- * @param right
- *
- * Copy constructor.
- */
-CCI::CCI(const CCI &right) : CCI(right.parent())
-{
-    *this = right;
-}
-
 /**
  * @brief CCI::GetControl
  * @return the RMF control associated with this CCI
@@ -110,42 +97,6 @@ QVector<STIGCheck> CCI::GetSTIGChecks() const
     return db.GetSTIGChecks(*this);
 }
 
-/**
- * @brief CCI::operator=
- * @param right
- * @return This @a CCI, copied from the assignee.
- *
- * Deep copy assignment operator.
- */
-CCI& CCI::operator=(const CCI &right)
-{
-    if (this != &right)
-    {
-        id = right.id;
-        controlId = right.controlId;
-        cci = right.cci;
-        definition = right.definition;
-        isImport = right.isImport;
-        importCompliance = right.importCompliance;
-        importDateTested = right.importDateTested;
-        importTestedBy = right.importTestedBy;
-        importTestResults = right.importTestResults;
-        importCompliance2 = right.importCompliance2;
-        importDateTested2 = right.importDateTested2;
-        importTestedBy2 = right.importTestedBy2;
-        importTestResults2 = right.importTestResults2;
-        importControlImplementationStatus = right.importControlImplementationStatus;
-        importSecurityControlDesignation = right.importSecurityControlDesignation;
-        importInherited = right.importInherited;
-        importRemoteInheritanceInstance = right.importRemoteInheritanceInstance;
-        importApNum = right.importApNum;
-        importImplementationGuidance = right.importImplementationGuidance;
-        importAssessmentProcedures = right.importAssessmentProcedures;
-        importNarrative = right.importNarrative;
-    }
-    return *this;
-}
-
 /**
  * @brief CCI::operator==
  * @param right
@@ -20,21 +20,19 @@
 #ifndef CCI_H
 #define CCI_H
 
-#include <QObject>
+#include <QMetaType>
 #include <QString>
+#include <QVector>
 
 class CKLCheck;
 class Control;
 class STIGCheck;
 
-class CCI : public QObject
+class CCI
 {
-    Q_OBJECT
 
 public:
-    CCI(const CCI &right);
-    explicit CCI(QObject *parent = nullptr);
-    ~CCI() override = default;
+    CCI();
     int id;
     Control GetControl() const;
     QVector<CKLCheck> GetCKLChecks() const;
@@ -63,10 +61,10 @@ public:
     {
         return left.cci < right.cci;
     }
-    CCI& operator=(const CCI &right);
     bool operator==(const CCI &right) const;
 };
 
+Q_DECLARE_TYPEINFO(CCI, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(CCI);
 
 [[nodiscard]] QString PrintCCI(int cci);
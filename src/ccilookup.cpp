@@ -0,0 +1,87 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ccilookup.h"
+
+/**
+ * @class CCILookup
+ * @brief The database id of every @a CCI, by CCI number.
+ *
+ * Importing a STIG resolves every CCI reference of every rule to the
+ * id of its @a CCI. The table is loaded with one query (see
+ * DbManager::GetCCILookup()) and is not changed after that, so the
+ * STIG parser threads share it without locking.
+ *
+ * CCI numbers are small integers (CCI-000001 through a few
+ * thousand), so the ids are kept in an array indexed by the number.
+ */
+
+namespace {
+    //larger CCI numbers than this are not kept in the array
+    constexpr int maxDenseCCI = 1 << 20;
+}
+
+/**
+ * @brief CCILookup::Insert
+ * @param cci
+ * @param id
+ *
+ * Records that CCI number @a cci has the database @a id.
+ */
+void CCILookup::Insert(int cci, int id)
+{
+    if (cci < 0)
+        return;
+    if (cci < maxDenseCCI)
+    {
+        if (cci >= _ids.count())
+            _ids.resize(cci + 1, -1);
+        if (_ids.at(cci) < 0)
+            _count++;
+        _ids[cci] = id;
+    }
+    else
+    {
+        if (!_sparse.contains(cci))
+            _count++;
+        _sparse.insert(cci, id);
+    }
+}
+
+/**
+ * @brief CCILookup::Id
+ * @param cci
+ * @return The database id of CCI number @a cci, or -1 when there is
+ * no such @a CCI.
+ */
+int CCILookup::Id(int cci) const
+{
+    if (cci >= 0 && cci < _ids.count())
+        return _ids.at(cci);
+    return _sparse.value(cci, -1);
+}
+
+/**
+ * @brief CCILookup::Count
+ * @return The number of CCIs in the table.
+ */
+int CCILookup::Count() const
+{
+    return _count;
+}
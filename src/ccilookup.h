@@ -0,0 +1,39 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CCILOOKUP_H
+#define CCILOOKUP_H
+
+#include <QHash>
+#include <QVector>
+
+class CCILookup
+{
+public:
+    void Insert(int cci, int id);
+    [[nodiscard]] int Id(int cci) const;
+    [[nodiscard]] int Count() const;
+
+private:
+    QVector<int> _ids; //database id by CCI number, or -1
+    QHash<int, int> _sparse; //CCI numbers too large for _ids
+    int _count{0};
+};
+
+#endif // CCILOOKUP_H
@@ -46,11 +46,10 @@
 
 /**
  * @brief CKLCheck::CKLCheck
- * @param parent
  *
  * Default constructor.
  */
-CKLCheck::CKLCheck(QObject *parent) : QObject(parent),
+CKLCheck::CKLCheck() :
     id(-1),
     assetId(-1),
     stigCheckId(-1),
@@ -58,22 +57,13 @@ CKLCheck::CKLCheck(QObject *parent) : QObject(parent),
     findingDetails(),
     comments(),
     severityOverride(),
-    severityJustification()
+    severityJustification(),
+    _keyCheckId(-1),
+    _keySeverity(Severity::none),
+    _keyRule()
 {
 }
 
-/**
- * @overload CKLCheck::CKLCheck(const CKLCheck &right)
- * @brief CKLCheck::CKLCheck
- * @param right
- *
- * Copy constructor.
- */
-CKLCheck::CKLCheck(const CKLCheck &right) : CKLCheck(right.parent())
-{
-    *this = right;
-}
-
 /**
  * @brief CKLCheck::GetAsset
  * @return The @a Asset associated with this check.
@@ -113,31 +103,51 @@ STIGCheck CKLCheck::GetSTIGCheck() const
 Severity CKLCheck::GetSeverity() const
 {
     if (severityOverride == Severity::none)
-        return GetSTIGCheck().severity;
+        return HasSTIGCheckKey() ? _keySeverity : GetSTIGCheck().severity;
     return severityOverride;
 }
 
 /**
- * @brief CKLCheck::operator =
- * @param right
- * @return This @a CKLCheck, copied from the assignee.
+ * @brief CKLCheck::SortKey
+ * @return The effective @a Severity and the rule of this check, the
+ * fields that order checks (highest severity first, then by rule).
  *
- * Deep copy assignment operator.
+ * Checks read by DbManager::GetCKLChecks() carry their
+ * @a STIGCheck's severity and rule, so comparing them does not query
+ * the database. Otherwise, the @a STIGCheck is looked up.
  */
-CKLCheck &CKLCheck::operator=(const CKLCheck &right)
+CKLCheckSortKey CKLCheck::SortKey() const
 {
-    if (this != &right)
-    {
-        id = right.id;
-        assetId = right.assetId;
-        stigCheckId = right.stigCheckId;
-        status = right.status;
-        findingDetails = right.findingDetails;
-        comments = right.comments;
-        severityOverride = right.severityOverride;
-        severityJustification = right.severityJustification;
-    }
-    return *this;
+    if (HasSTIGCheckKey())
+        return {(severityOverride == Severity::none) ? _keySeverity : severityOverride, _keyRule};
+    const STIGCheck sc = GetSTIGCheck();
+    return {(severityOverride == Severity::none) ? sc.severity : severityOverride, sc.rule};
+}
+
+/**
+ * @brief CKLCheck::SetSTIGCheckKey
+ * @param severity
+ * @param rule
+ *
+ * Attaches the default @a severity and the @a rule of the current
+ * @a STIGCheck to this check. They are ignored once @a stigCheckId
+ * changes.
+ */
+void CKLCheck::SetSTIGCheckKey(Severity severity, const QString &rule)
+{
+    _keyCheckId = stigCheckId;
+    _keySeverity = severity;
+    _keyRule = rule;
+}
+
+/**
+ * @brief CKLCheck::HasSTIGCheckKey
+ * @return @c True when the @a STIGCheck severity and rule attached by
+ * SetSTIGCheckKey() belong to the current @a stigCheckId.
+ */
+bool CKLCheck::HasSTIGCheckKey() const
+{
+    return _keyCheckId > 0 && _keyCheckId == stigCheckId;
 }
 
 /**
@@ -215,5 +225,6 @@ QString GetCMRSStatus(Status status)
  */
 [[nodiscard]] QString PrintCKLCheck(const CKLCheck &cklCheck)
 {
-    return PrintSTIGCheck(cklCheck.GetSTIGCheck());
+    //the rule read with the check, so that lists do not load each STIGCheck
+    return cklCheck.SortKey().rule;
 }
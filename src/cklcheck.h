@@ -20,7 +20,7 @@
 #ifndef CKLCHECK_H
 #define CKLCHECK_H
 
-#include <QObject>
+#include <QMetaType>
 #include <QString>
 
 #include "asset.h"
@@ -38,20 +38,24 @@ Status GetStatus(const QString &status);
 QString GetStatus(Status status, bool xmlFormat = false);
 QString GetCMRSStatus(Status status);
 
-class CKLCheck : public QObject
+struct CKLCheckSortKey
 {
-    Q_OBJECT
+    Severity severity{Severity::none}; //effective severity
+    QString rule;
+};
 
+class CKLCheck
+{
 public:
-    CKLCheck(const CKLCheck &right);
-    explicit CKLCheck(QObject *parent = nullptr);
-    ~CKLCheck() override = default;
+    CKLCheck();
     int id;
     int assetId;
     int stigCheckId;
     Asset GetAsset() const;
     STIGCheck GetSTIGCheck() const;
     Severity GetSeverity() const;
+    CKLCheckSortKey SortKey() const;
+    void SetSTIGCheckKey(Severity severity, const QString &rule);
     Status status;
     QString findingDetails;
     QString comments;
@@ -59,15 +63,22 @@ public:
     QString severityJustification;
     friend bool operator<(const CKLCheck &left, const CKLCheck &right)
     {
-        Severity l = left.GetSeverity();
-        Severity r = right.GetSeverity();
-        if (l == r)
-            return (left.GetSTIGCheck().rule.compare(right.GetSTIGCheck().rule) < 0);
-        return r < l;
+        const CKLCheckSortKey l = left.SortKey();
+        const CKLCheckSortKey r = right.SortKey();
+        if (l.severity == r.severity)
+            return (l.rule.compare(r.rule) < 0);
+        return r.severity < l.severity;
     }
-    CKLCheck& operator=(const CKLCheck &right);
+
+private:
+    [[nodiscard]] bool HasSTIGCheckKey() const;
+    //the STIGCheck's severity and rule, read with the check (see SortKey())
+    int _keyCheckId;
+    Severity _keySeverity;
+    QString _keyRule;
 };
 
+Q_DECLARE_TYPEINFO(CKLCheck, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(CKLCheck);
 
 [[nodiscard]] QString PrintCKLCheck(const CKLCheck &cklCheck);
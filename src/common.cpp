@@ -22,8 +22,6 @@
 
 bool IgnoreWarnings = false;
 
-#include <zip.h>
-
 #include <QApplication>
 #include <QDebug>
 #include <QEventLoop>
@@ -68,32 +66,20 @@ void MessageHandler(QtMsgType type, const QMessageLogContext &context, const QSt
         severity = 0;
         break;
     }
-    DbManager db;
-    db.Log(severity, context.file + QStringLiteral(":") + QString::number(context.line) + QStringLiteral(" ") + context.function, msg);
+    DbManager::Log(severity, context.file + QStringLiteral(":") + QString::number(context.line) + QStringLiteral(" ") + context.function, msg);
 }
 
 /**
  * @brief DownloadFile
  * @param url
- * @param file
+ * @param data
  * @return @c True when the file is successfully downloaded.
  * Otherwise, @c false.
  *
- * Given a @a url, the contents of that URL are written to the handle
- * supplied in the @a file parameter.
+ * Given a @a url, the contents of that URL are read into @a data.
  */
-bool DownloadFile(const QUrl &url, QFile *file)
+bool DownloadFile(const QUrl &url, QByteArray *data)
 {
-    bool close = false;
-
-    //check if the file is currently open
-    if (!file->isOpen())
-    {
-        file->open(QIODevice::WriteOnly);
-        if (!file->isOpen())
-            return false;
-        close = true;
-    }
     QNetworkAccessManager manager;
     QNetworkRequest req = QNetworkRequest(url);
     req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
@@ -115,33 +101,59 @@ bool DownloadFile(const QUrl &url, QFile *file)
         QObject::connect(response,SIGNAL(finished()),&event,SLOT(quit()));
         event.exec();
 
-        //read entire contents to memory before saving it to the file
-        QByteArray tmpArray = response->readAll();
+        //read entire contents to memory
+        *data = response->readAll();
+        delete response;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @overload DownloadFile(const QUrl &url, QFile *file)
+ * @brief DownloadFile
+ * @param url
+ * @param file
+ * @return @c True when the file is successfully downloaded.
+ * Otherwise, @c false.
+ *
+ * Given a @a url, the contents of that URL are written to the handle
+ * supplied in the @a file parameter.
+ */
+bool DownloadFile(const QUrl &url, QFile *file)
+{
+    bool close = false;
+
+    //check if the file is currently open
+    if (!file->isOpen())
+    {
+        file->open(QIODevice::WriteOnly);
+        if (!file->isOpen())
+            return false;
+        close = true;
+    }
 
+    //read entire contents to memory before saving it to the file
+    QByteArray tmpArray;
+    const bool ret = DownloadFile(url, &tmpArray);
+    if (ret)
+    {
         //save contents of the response to the file
         file->write(tmpArray, tmpArray.size());
         file->flush();
-        delete response;
-
-        /*
-         * If the file was already open, seek back to the beginning of
-         * the file. Otherwise, close it. This preserves the state of the
-         * file before this function ran.
-         */
-        if (close)
-            file->close();
-        else
-            file->seek(0);
-
-        return true;
     }
 
+    /*
+     * If the file was already open, seek back to the beginning of
+     * the file. Otherwise, close it. This preserves the state of the
+     * file before this function ran.
+     */
     if (close)
         file->close();
     else
         file->seek(0);
 
-    return false;
+    return ret;
 }
 
 /**
@@ -198,71 +210,6 @@ int GetCCINumber(QString cci)
     return cci.toInt();
 }
 
-/**
- * @brief GetFilesFromZip
- * @param fileName
- * @param fileNameFilter
- * @return A map of the extracted files in the zip.
- *
- * Extracts a zip file and stores the contents in memory.
- *
- * When fileNameFilter is set, only the files that end with the
- * provided filter are extracted and returned (case-insensitive).
- */
-QMap<QString, QByteArray> GetFilesFromZip(const QString &fileName, const QString &fileNameFilter)
-{
-    //map to return
-    QMap<QString, QByteArray> ret;
-
-    //open the zip with libzip
-    struct zip *za;
-    int err;
-    struct zip_stat sb;
-    zip_stat_init(&sb); //initializes sb
-    za = zip_open(fileName.toStdString().c_str(), 0, &err);
-    if (za != nullptr)
-    {
-        //cycle through each zip file entry
-        for (unsigned int i = 0; i < zip_get_num_entries(za, 0); i++)
-        {
-            if (zip_stat_index(za, i, 0, &sb) == 0)
-            {
-                //zip bomb protection
-                //if file is > 4GB extracted, do not read it
-                if (sb.size > 4294967295)
-                    continue;
-
-                QString name(QString::fromLatin1(sb.name));
-                if (!fileNameFilter.isNull() && !fileNameFilter.isEmpty() && !name.endsWith(fileNameFilter, Qt::CaseInsensitive))
-                {
-                    continue;
-                }
-
-                QByteArray todo;
-                struct zip_file *zf = zip_fopen_index(za, i, 0);
-                if (zf)
-                {
-                    unsigned int sum = 0;
-                    while (sum < sb.size)
-                    {
-                        char buf[1024];
-                        zip_int64_t len = zip_fread(zf, static_cast<void*>(buf), 1024);
-                        if (len > 0)
-                        {
-                            todo.append(static_cast<const char*>(buf), static_cast<int>(len));
-                            sum += len;
-                        }
-                    }
-                    zip_fclose(zf);
-                }
-                ret.insert(name, todo);
-            }
-        }
-        zip_close(za);
-    }
-    return ret;
-}
-
 /**
  * @brief GetReleaseNumber
  * @param release
@@ -382,8 +329,7 @@ QString TrimFileName(const QString &fileName)
  */
 void Warning(const QString &title, const QString &message, const bool quiet, const int level)
 {
-    DbManager db;
-    db.Log(level, QString(), title + ": " + message);
+    DbManager::Log(level, QString(), title + ": " + message);
     if (!IgnoreWarnings && !quiet && (QThread::currentThread() == QApplication::instance()->thread())) //make sure we're in the GUI thread before popping a message box
     {
         int ret = QMessageBox::warning(nullptr, title, message, QMessageBox::Ignore | QMessageBox::Ok);
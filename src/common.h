@@ -32,11 +32,11 @@
 [[maybe_unused]] extern bool IgnoreWarnings;
 
 void MessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg);
+bool DownloadFile(const QUrl &url, QByteArray *data);
 bool DownloadFile(const QUrl &url, QFile *file);
 QString DownloadPage(const QUrl &url);
 QString Excelify(const QString &s);
 int GetCCINumber(QString cci);
-QMap<QString, QByteArray> GetFilesFromZip(const QString &fileName, const QString &fileNameFilter = QLatin1String(""));
 int GetReleaseNumber(const QString &release);
 QString GetUserAgent();
 QString Pluralize(const int count, const QString &plural = QStringLiteral("s"), const QString &singular = QLatin1String(""));
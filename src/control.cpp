@@ -37,11 +37,10 @@
 
 /**
  * @brief Control::Control
- * @param parent
  *
  * Default constructor.
  */
-Control::Control(QObject *parent) : QObject(parent),
+Control::Control() :
     id(-1),
     familyId(-1),
     number(0),
@@ -58,17 +57,6 @@ Control::Control(QObject *parent) : QObject(parent),
 {
 }
 
-/**
- * @brief Control::Control
- * @param right
- *
- * Copy constructor.
- */
-Control::Control(const Control &right) : Control(right.parent())
-{
-    *this = right;
-}
-
 /**
  * @brief Control::GetFamily
  * @return The @a Family associated with this @a Control
@@ -85,34 +73,6 @@ QVector<CCI> Control::GetCCIs() const
     return db.GetCCIs(*this);
 }
 
-/**
- * @brief Control::operator=
- * @param right
- * @return This @a Control, copied from the assignee.
- *
- * Deep copy assignment operator.
- */
-Control& Control::operator=(const Control &right)
-{
-    if (this != &right)
-    {
-        id = right.id;
-        familyId = right.familyId;
-        number = right.number;
-        enhancement = right.enhancement;
-        title = right.title;
-        description = right.description;
-	importSeverity = right.importSeverity;
-	importRelevanceOfThreat = right.importRelevanceOfThreat;
-	importLikelihood = right.importLikelihood;
-	importImpact = right.importImpact;
-	importImpactDescription = right.importImpactDescription;
-	importResidualRiskLevel = right.importResidualRiskLevel;
-	importRecommendations = right.importRecommendations;
-    }
-    return *this;
-}
-
 /**
  * @brief Control::IsImport
  * @return @c True when a CCI has been imported under this control.
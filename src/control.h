@@ -22,18 +22,16 @@
 
 #include "family.h"
 
-#include <QObject>
+#include <QMetaType>
 #include <QString>
+#include <QVector>
 
 class CCI;
 
-class Control : public QObject
+class Control
 {
-    Q_OBJECT
 public:
-    Control(const Control &right);
-    explicit Control(QObject *parent = nullptr);
-    ~Control() override = default;
+    Control();
     int id;
     int familyId;
     Family GetFamily() const;
@@ -49,7 +47,6 @@ public:
     QString importImpactDescription;
     QString importResidualRiskLevel;
     QString importRecommendations;
-    Control& operator=(const Control &right);
     friend bool operator<(const Control &left, const Control &right)
     {
         if (left.familyId == right.familyId)
@@ -67,6 +64,7 @@ public:
 
 bool operator==(Control const& lhs, Control const& rhs);
 
+Q_DECLARE_TYPEINFO(Control, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(Control);
 
 [[nodiscard]] QString PrintControl(const Control &control);
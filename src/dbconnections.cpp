@@ -0,0 +1,347 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dbconnections.h"
+#include "dbquery.h"
+
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QSqlQuery>
+#include <QThread>
+#include <QWaitCondition>
+
+/**
+ * @class DbConnections
+ * @brief The registry of the per-thread database connections.
+ *
+ * DbManager names each connection after the thread that uses it.
+ * Every @a Worker runs on a new thread, so without the registry a
+ * long session accumulates one open SQLite connection (with its file
+ * descriptors, page cache, and prepared statements) per worker, and
+ * a new thread that is given a finished thread's id inherits its
+ * connection.
+ *
+ * A connection is registered by the thread that creates it and is
+ * closed and removed when that thread finishes. Only the registering
+ * thread owns the connection; DbManager replaces a connection it
+ * does not own.
+ *
+ * The number of open connections is capped. A worker that needs a
+ * connection above the cap waits for one to close, for at most the
+ * SQLite busy timeout, and then opens it anyway so that a worker
+ * waiting on another can never deadlock. The main thread and the
+ * @a LogWriter are never delayed.
+ */
+
+namespace {
+    //matches QSQLITE_BUSY_TIMEOUT
+    constexpr int openTimeout = 30000;
+
+    struct ConnectionEntry
+    {
+        QString thread;
+        bool open{false};
+        qint64 cacheBytes{0};
+    };
+
+    QMutex registryMutex;
+    QWaitCondition slotAvailable;
+    QHash<QString, ConnectionEntry> connections;
+    int openConnections = 0;
+    //two workers per core, plus the main thread and the LogWriter
+    int connectionLimit = std::max(8, QThread::idealThreadCount() * 2 + 2);
+
+    void ReleaseNames(QSet<QString> &names)
+    {
+        for (const QString &name : std::as_const(names))
+            DbConnections::Remove(name);
+        names.clear();
+    }
+
+    //the connections registered by this thread
+    struct ThreadConnections
+    {
+        QSet<QString> names;
+        bool exempt{false};
+        bool main{false};
+        bool watching{false};
+
+        ~ThreadConnections()
+        {
+            //threads that are not QThreads end without a finished() signal
+            if (!main)
+                ReleaseNames(names);
+        }
+    };
+
+    ThreadConnections &Local()
+    {
+        thread_local ThreadConnections local;
+        return local;
+    }
+
+    bool IsMainThread()
+    {
+        return QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread();
+    }
+
+    void MarkClosed(const QString &connectionName, bool remove)
+    {
+        QMutexLocker locker(&registryMutex);
+        auto it = connections.find(connectionName);
+        if (it == connections.end())
+            return;
+        if (it->open)
+        {
+            it->open = false;
+            openConnections--;
+            slotAvailable.wakeOne();
+        }
+        if (remove)
+            connections.erase(it);
+    }
+
+    /**
+     * @brief CacheBytes
+     * @param db
+     * @return The most memory the connection's page cache may hold.
+     */
+    qint64 CacheBytes(const QSqlDatabase &db)
+    {
+        QSqlQuery q(db);
+        const qint64 pageSize = q.exec(QStringLiteral("PRAGMA page_size")) && q.next() ? q.value(0).toLongLong() : 0;
+        const qint64 cacheSize = q.exec(QStringLiteral("PRAGMA cache_size")) && q.next() ? q.value(0).toLongLong() : 0;
+        //a negative cache size is in KiB rather than pages
+        return cacheSize < 0 ? -cacheSize * 1024 : cacheSize * pageSize;
+    }
+}
+
+/**
+ * @brief DbConnections::Register
+ * @param connectionName
+ *
+ * Records that the calling thread has added @a connectionName. The
+ * connection is removed when the thread finishes.
+ */
+void DbConnections::Register(const QString &connectionName)
+{
+    ThreadConnections &local = Local();
+    local.names.insert(connectionName);
+    local.main = IsMainThread();
+
+    QThread *thread = QThread::currentThread();
+    if (!local.main && !local.watching)
+    {
+        local.watching = true;
+        //emitted on the ending thread, before QThread::wait() returns
+        QObject::connect(thread, &QThread::finished, thread, &DbConnections::Release, Qt::DirectConnection);
+    }
+
+    QMutexLocker locker(&registryMutex);
+    ConnectionEntry &entry = connections[connectionName];
+    entry.thread = thread->objectName().isEmpty() ? connectionName : thread->objectName();
+}
+
+/**
+ * @brief DbConnections::Owns
+ * @param connectionName
+ * @return @c True when the calling thread registered
+ * @a connectionName.
+ */
+bool DbConnections::Owns(const QString &connectionName)
+{
+    return Local().names.contains(connectionName);
+}
+
+/**
+ * @brief DbConnections::Open
+ * @param db
+ * @return @c True when the connection @a db is opened.
+ *
+ * Waits while the cap on open connections is reached (see the class
+ * description).
+ */
+bool DbConnections::Open(QSqlDatabase &db)
+{
+    const QString connectionName = db.connectionName();
+    const bool wait = !IsMainThread() && !Local().exempt;
+    {
+        QMutexLocker locker(&registryMutex);
+        if (!connections.value(connectionName).open)
+        {
+            if (wait)
+            {
+                QElapsedTimer timer;
+                timer.start();
+                while (openConnections >= connectionLimit && timer.elapsed() < openTimeout)
+                    slotAvailable.wait(&registryMutex, 100);
+            }
+            connections[connectionName].open = true;
+            openConnections++;
+        }
+    }
+
+    if (!db.open())
+    {
+        MarkClosed(connectionName, false);
+        return false;
+    }
+
+    const qint64 cacheBytes = CacheBytes(db);
+    QMutexLocker locker(&registryMutex);
+    connections[connectionName].cacheBytes = cacheBytes;
+    return true;
+}
+
+/**
+ * @brief DbConnections::Close
+ * @param db
+ *
+ * Finalizes the cached statements of @a db and closes it. The
+ * connection stays registered and is reopened on its next use.
+ */
+void DbConnections::Close(QSqlDatabase &db)
+{
+    const QString connectionName = db.connectionName();
+    DbQuery::ClearCache(connectionName);
+    db.close();
+    MarkClosed(connectionName, false);
+}
+
+/**
+ * @brief DbConnections::Remove
+ * @param connectionName
+ *
+ * Closes and removes the connection. It must not be in use by its
+ * thread.
+ */
+void DbConnections::Remove(const QString &connectionName)
+{
+    DbQuery::ClearCache(connectionName);
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        if (db.isOpen())
+            db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    MarkClosed(connectionName, true);
+}
+
+/**
+ * @brief DbConnections::Release
+ *
+ * Closes and removes the connections registered by the calling
+ * thread. Called when the thread finishes.
+ */
+void DbConnections::Release()
+{
+    ReleaseNames(Local().names);
+}
+
+/**
+ * @brief DbConnections::Exempt
+ *
+ * The calling thread's connections are opened without waiting for
+ * the cap. Used by threads that other threads wait on.
+ */
+void DbConnections::Exempt()
+{
+    Local().exempt = true;
+}
+
+/**
+ * @brief DbConnections::SetLimit
+ * @param limit
+ *
+ * Sets the number of open connections above which workers wait. The
+ * default is twice the number of processor cores plus two (for the
+ * main thread and the @a LogWriter), and at least 8.
+ */
+void DbConnections::SetLimit(int limit)
+{
+    QMutexLocker locker(&registryMutex);
+    connectionLimit = std::max(1, limit);
+    slotAvailable.wakeAll();
+}
+
+/**
+ * @brief DbConnections::Limit
+ * @return The cap on open connections.
+ */
+int DbConnections::Limit()
+{
+    QMutexLocker locker(&registryMutex);
+    return connectionLimit;
+}
+
+/**
+ * @brief DbConnections::Count
+ * @return The number of registered connections, open or not.
+ */
+int DbConnections::Count()
+{
+    QMutexLocker locker(&registryMutex);
+    return static_cast<int>(connections.count());
+}
+
+/**
+ * @brief DbConnections::OpenCount
+ * @return The number of open connections.
+ */
+int DbConnections::OpenCount()
+{
+    QMutexLocker locker(&registryMutex);
+    return openConnections;
+}
+
+/**
+ * @brief DbConnections::Connections
+ * @return Each registered connection with its thread, whether it is
+ * open, the size of its page cache, and the number of prepared
+ * statements cached for it.
+ */
+QVector<DbConnectionInfo> DbConnections::Connections()
+{
+    QVector<DbConnectionInfo> ret;
+    {
+        QMutexLocker locker(&registryMutex);
+        ret.reserve(connections.count());
+        for (auto it = connections.cbegin(); it != connections.cend(); ++it)
+        {
+            DbConnectionInfo info;
+            info.name = it.key();
+            info.thread = it->thread;
+            info.open = it->open;
+            info.cacheBytes = it->open ? it->cacheBytes : 0;
+            ret.append(info);
+        }
+    }
+    for (DbConnectionInfo &info : ret)
+        info.statements = DbQuery::CacheSize(info.name);
+    std::sort(ret.begin(), ret.end(), [](const DbConnectionInfo &a, const DbConnectionInfo &b) {
+        return a.name < b.name;
+    });
+    return ret;
+}
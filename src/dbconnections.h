@@ -0,0 +1,54 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DBCONNECTIONS_H
+#define DBCONNECTIONS_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+struct DbConnectionInfo
+{
+    QString name;
+    QString thread;
+    bool open{false};
+    qint64 cacheBytes{0};
+    int statements{0};
+};
+
+class DbConnections
+{
+public:
+    static void Register(const QString &connectionName);
+    [[nodiscard]] static bool Owns(const QString &connectionName);
+    static bool Open(QSqlDatabase &db);
+    static void Close(QSqlDatabase &db);
+    static void Remove(const QString &connectionName);
+    static void Release();
+    static void Exempt();
+
+    static void SetLimit(int limit);
+    [[nodiscard]] static int Limit();
+    [[nodiscard]] static int Count();
+    [[nodiscard]] static int OpenCount();
+    [[nodiscard]] static QVector<DbConnectionInfo> Connections();
+};
+
+#endif // DBCONNECTIONS_H
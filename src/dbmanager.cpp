@@ -18,24 +18,562 @@
  */
 
 #include "dbmanager.h"
+#include "assessmentsnapshot.h"
+#include "ccilookup.h"
 #include "cklcheck.h"
 #include "common.h"
-
+#include "dbconnections.h"
+#include "dbquery.h"
+#include "dbtransaction.h"
+#include "entitycache.h"
+#include "logwriter.h"
+
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <QCryptographicHash>
+#include <QDataStream>
 #include <QFile>
+#include <QSaveFile>
+#include <QTemporaryFile>
+#include <QHash>
 #include <QMap>
 #include <QRegularExpression>
+#include <QSet>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QThread>
+#include <QtEndian>
 #include <QSqlField>
+#include <QSqlRecord>
 #include <QSqlDriver>
 #include <QStandardPaths>
 #include <QFileInfo>
 #include <QDir>
 #include <QCoreApplication>
 
+namespace {
+    //the "loglevel" variable, read once per database
+    std::atomic<int> cachedLogLevel{-1};
+
+    /**
+     * @brief ConfigureConnection
+     * @param db
+     *
+     * Per-connection settings applied whenever a connection is opened.
+     * The database file is kept in write-ahead-log mode so that
+     * readers on other threads see the last committed snapshot while
+     * a worker thread holds a write transaction.
+     */
+    void ConfigureConnection(QSqlDatabase &db)
+    {
+        QSqlQuery q(db);
+        q.exec(QStringLiteral("PRAGMA journal_mode = WAL"));
+        //durable at each checkpoint; a crash can lose the last commits but not corrupt the file
+        q.exec(QStringLiteral("PRAGMA synchronous = NORMAL"));
+        //bulk imports checkpoint explicitly when they commit
+        q.exec(QStringLiteral("PRAGMA wal_autocheckpoint = 4000"));
+        q.exec(QStringLiteral("PRAGMA journal_size_limit = 67108864"));
+    }
+
+    /**
+     * @brief CheckpointDatabase
+     * @param db
+     * @return @c True when every committed change in the write-ahead
+     * log has been copied into the database file.
+     *
+     * Needed before the database file itself is read.
+     */
+    bool CheckpointDatabase(QSqlDatabase &db)
+    {
+        QSqlQuery q(db);
+        //the first column is 1 when the checkpoint could not complete
+        return q.exec(QStringLiteral("PRAGMA wal_checkpoint(TRUNCATE)")) && q.next() && q.value(0).toInt() == 0;
+    }
+
+    /**
+     * @brief ReleaseDatabaseFile
+     * @param db
+     * @param path
+     * @return @c True when the database file at @a path can be
+     * replaced. Otherwise, @c false, and the connection stays open.
+     *
+     * Checkpoints the write-ahead log, leaves WAL mode, and closes the
+     * thread's connection so that the database file can be replaced.
+     * The connection is reopened (and WAL mode restored) by the next
+     * DbManager::CheckDatabase().
+     *
+     * SQLite only leaves WAL mode when no other connection has the
+     * file open. Otherwise, the -wal and -shm files remain, and
+     * SQLite would replay the old log into a replaced database.
+     */
+    bool ReleaseDatabaseFile(QSqlDatabase &db, const QString &path)
+    {
+        if (!CheckpointDatabase(db))
+            return false;
+        {
+            QSqlQuery q(db);
+            if (!q.exec(QStringLiteral("PRAGMA journal_mode = DELETE")) || !q.next() || q.value(0).toString().compare(QStringLiteral("delete"), Qt::CaseInsensitive) != 0)
+                return false;
+        }
+        //cached statements reference the old database
+        DbQuery::ClearCache(db.connectionName());
+        DbConnections::Close(db);
+        //left behind by a connection that did not close cleanly
+        QFile::remove(path + QStringLiteral("-wal"));
+        QFile::remove(path + QStringLiteral("-shm"));
+        return true;
+    }
+
+    /**
+     * @brief EffectiveSeverity
+     * @param row
+     * @param severity
+     * @return SQL for the @a Severity of the CKLCheck @a row: its
+     * override, or else the STIGCheck @a severity.
+     *
+     * AddSTIGToAsset() stores an empty override until the check is
+     * first saved.
+     */
+    QString EffectiveSeverity(const QString &row, const QString &severity)
+    {
+        return "COALESCE(NULLIF(CAST(IFNULL(" + row + ".`severityOverride`, 0) AS INTEGER), 0), " + severity + ", 0)";
+    }
+
+    /**
+     * @brief ComplianceSummaryQuery
+     * @param count
+     * @return SQL computing the ComplianceSummary rows from the
+     * checklists, with @a count as the number of checks.
+     */
+    QString ComplianceSummaryQuery(const QString &count)
+    {
+        return "SELECT `CKLCheck`.`AssetId`, `STIGCheck`.`STIGId`, " + EffectiveSeverity(QStringLiteral("`CKLCheck`"), QStringLiteral("`STIGCheck`.`severity`")) + ", IFNULL(`CKLCheck`.`status`, 0), " + count + " FROM `CKLCheck` JOIN `STIGCheck` ON `STIGCheck`.`id` = `CKLCheck`.`STIGCheckId` GROUP BY 1, 2, 3, 4";
+    }
+
+    //the chunked .stigqter format; older files are one qCompress() block
+    const QByteArray saveFileMagic = QByteArrayLiteral("STQZ");
+    constexpr quint32 saveFileVersion = 2;
+    constexpr qint64 saveChunkSize = 4 * 1024 * 1024;
+    //zlib can expand incompressible input slightly
+    constexpr quint32 maxCompressedChunk = saveChunkSize + saveChunkSize / 16 + 1024;
+    //size of the SHA3-256 trailer
+    constexpr int saveHashSize = 32;
+
+    /**
+     * @brief WriteChunkedSave
+     * @param source
+     * @param dest
+     * @param hash
+     * @param progress
+     * @return @c True when all of @a source is compressed into
+     * @a dest. Otherwise, @c false.
+     *
+     * The file is the magic number and version, then each chunk as
+     * its compressed length followed by the qCompress() data, then a
+     * zero length and the @a hash of the database when it was saved.
+     * Only one chunk is held in memory at a time.
+     */
+    bool WriteChunkedSave(QIODevice &source, QIODevice &dest, const QByteArray &hash, const std::function<void (qint64, qint64)> &progress)
+    {
+        QDataStream out(&dest);
+        out.writeRawData(saveFileMagic.constData(), saveFileMagic.size());
+        out << saveFileVersion;
+        const qint64 total = source.size();
+        qint64 done = 0;
+        while (!source.atEnd())
+        {
+            const QByteArray chunk = source.read(saveChunkSize);
+            if (chunk.isEmpty())
+                return false;
+            const QByteArray compressed = qCompress(chunk, 9);
+            out << static_cast<quint32>(compressed.size());
+            out.writeRawData(compressed.constData(), static_cast<int>(compressed.size()));
+            done += chunk.size();
+            if (progress)
+                progress(done, total);
+        }
+        out << static_cast<quint32>(0);
+        out.writeRawData(hash.constData(), static_cast<int>(hash.size()));
+        return out.status() == QDataStream::Ok;
+    }
+
+    /**
+     * @brief ReadChunkedSave
+     * @param source
+     * @param dest
+     * @param progress
+     * @return @c True when every chunk of @a source is decompressed
+     * into @a dest. Otherwise, @c false.
+     */
+    bool ReadChunkedSave(QIODevice &source, QIODevice &dest, const std::function<void (qint64, qint64)> &progress)
+    {
+        QDataStream in(&source);
+        QByteArray magic(saveFileMagic.size(), Qt::Uninitialized);
+        quint32 version = 0;
+        if (in.readRawData(magic.data(), static_cast<int>(magic.size())) != magic.size() || magic != saveFileMagic)
+            return false;
+        in >> version;
+        if (version != saveFileVersion)
+        {
+            Warning(QStringLiteral("Unsupported File"), "The save file format " + QString::number(version) + " is newer than this version of STIGQter supports.");
+            return false;
+        }
+
+        const qint64 total = source.size();
+        QByteArray compressed;
+        for (;;)
+        {
+            quint32 length = 0;
+            in >> length;
+            if (in.status() != QDataStream::Ok)
+                return false;
+            if (length == 0)
+                return true;
+            //the 4-byte prefix of each block is its uncompressed size
+            if (length > maxCompressedChunk || length < 4)
+                return false;
+            compressed.resize(length);
+            if (in.readRawData(compressed.data(), static_cast<int>(length)) != static_cast<int>(length))
+                return false;
+            const quint32 expectedSize = qFromBigEndian<quint32>(compressed.constData());
+            if (expectedSize > saveChunkSize)
+                return false;
+            const QByteArray chunk = qUncompress(compressed);
+            if (chunk.size() != static_cast<qsizetype>(expectedSize) || dest.write(chunk) != chunk.size())
+                return false;
+            if (progress)
+                progress(source.pos(), total);
+        }
+    }
+
+    /**
+     * @brief HashQuery
+     * @param hash
+     * @param q
+     * @return @c True when every row of @a q is added to @a hash.
+     * Otherwise, @c false.
+     *
+     * Each value is added with a null marker and its length so that
+     * different rows can never produce the same byte stream.
+     */
+    bool HashQuery(QCryptographicHash &hash, QSqlQuery &q)
+    {
+        if (!q.exec())
+            return false;
+        const int columns = q.record().count();
+        while (q.next())
+        {
+            for (int i = 0; i < columns; i++)
+            {
+                const QVariant value = q.value(i);
+                const QByteArray bytes = value.isNull() ? QByteArray() : value.toString().toUtf8();
+                char header[5];
+                header[0] = value.isNull() ? 0 : 1;
+                qToBigEndian<quint32>(static_cast<quint32>(bytes.size()), header + 1);
+                hash.addData(QByteArray::fromRawData(header, sizeof(header)));
+                hash.addData(bytes);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief HashAssessment
+     * @param hash
+     * @param db
+     * @return @c True when the @a Assets, their @a STIGs, and their
+     * @a CKLCheck results in @a db are added to @a hash. Otherwise,
+     * @c false.
+     */
+    bool HashAssessment(QCryptographicHash &hash, const QSqlDatabase &db)
+    {
+        bool ret = true;
+        QSqlQuery q(db);
+        q.setForwardOnly(true);
+        q.prepare(QStringLiteral("SELECT assetType, hostName, hostIP, hostMAC, hostFQDN, techArea, targetKey, marking, targetComment, webOrDatabase, webDBSite, webDBInstance FROM Asset ORDER BY hostName"));
+        ret = HashQuery(hash, q) && ret;
+        q.prepare(QStringLiteral("SELECT Asset.hostName, STIG.title, STIG.version, STIG.release FROM AssetSTIG JOIN Asset ON Asset.id = AssetSTIG.AssetId JOIN STIG ON STIG.id = AssetSTIG.STIGId ORDER BY 1, 2, 3, 4"));
+        ret = HashQuery(hash, q) && ret;
+        q.prepare(QStringLiteral("SELECT Asset.hostName, STIG.title, STIG.version, STIG.release, STIGCheck.rule, CKLCheck.status, CKLCheck.findingDetails, CKLCheck.comments, CKLCheck.severityOverride, CKLCheck.severityJustification FROM CKLCheck JOIN Asset ON Asset.id = CKLCheck.AssetId JOIN STIGCheck ON STIGCheck.id = CKLCheck.STIGCheckId JOIN STIG ON STIG.id = STIGCheck.STIGId ORDER BY 1, 2, 3, 4, 5"));
+        ret = HashQuery(hash, q) && ret;
+        DbManager::Log(6, QStringLiteral("HashAssessment"), q);
+        return ret;
+    }
+
+    /**
+     * @brief HashAssessmentFile
+     * @param path
+     * @return The assessment hash of the database file at @a path, or
+     * an empty array when it cannot be read.
+     *
+     * The file is opened on its own connection, which is removed
+     * again before returning.
+     */
+    QByteArray HashAssessmentFile(const QString &path)
+    {
+        const QString connectionName = QStringLiteral("hash-") + QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()));
+        QByteArray ret;
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+            db.setDatabaseName(path);
+            if (db.open())
+            {
+                QCryptographicHash hash(QCryptographicHash::Sha3_256);
+                if (HashAssessment(hash, db))
+                    ret = hash.result();
+                db.close();
+            }
+        }
+        QSqlDatabase::removeDatabase(connectionName);
+        return ret;
+    }
+
+    /**
+     * @brief ReadSTIGCheck
+     * @param q
+     * @return The @a STIGCheck in the current row of @a q, without
+     * its CCI and legacy ID mappings.
+     */
+    STIGCheck ReadSTIGCheck(const QSqlQuery &q)
+    {
+        STIGCheck c;
+        c.id = q.value(0).toInt();
+        c.stigId = q.value(1).toInt();
+        c.rule = q.value(2).toString();
+        c.vulnNum = q.value(3).toString();
+        c.groupTitle = q.value(4).toString();
+        c.ruleVersion = q.value(5).toString();
+        c.severity = static_cast<Severity>(q.value(6).toInt());
+        c.weight = q.value(7).toDouble();
+        c.title = q.value(8).toString();
+        c.vulnDiscussion = q.value(9).toString();
+        c.falsePositives = q.value(10).toString();
+        c.falseNegatives = q.value(11).toString();
+        c.fix = q.value(12).toString();
+        c.check = q.value(13).toString();
+        c.documentable = q.value(14).toBool();
+        c.mitigations = q.value(15).toString();
+        c.severityOverrideGuidance = q.value(16).toString();
+        c.checkContentRef = q.value(17).toString();
+        c.potentialImpact = q.value(18).toString();
+        c.thirdPartyTools = q.value(19).toString();
+        c.mitigationControl = q.value(20).toString();
+        c.responsibility = q.value(21).toString();
+        c.iaControls = q.value(22).toString();
+        c.targetKey = q.value(23).toString();
+        c.isRemap = q.value(24).toBool();
+        return c;
+    }
+
+    /**
+     * @brief ReadSTIGCheckHeader
+     * @param q
+     * @return The @a STIGCheckHeader in the current row of @a q.
+     */
+    STIGCheckHeader ReadSTIGCheckHeader(const QSqlQuery &q)
+    {
+        STIGCheckHeader c;
+        c.id = q.value(0).toInt();
+        c.stigId = q.value(1).toInt();
+        c.rule = q.value(2).toString();
+        c.ruleVersion = q.value(3).toString();
+        c.vulnNum = q.value(4).toString();
+        c.title = q.value(5).toString();
+        c.severity = static_cast<Severity>(q.value(6).toInt());
+        return c;
+    }
+
+    /**
+     * @brief GetByIds
+     * @param ids
+     * @param idColumn
+     * @param getter
+     * @return The records identified by @a ids, in the order of @a ids.
+     *
+     * Loads records by database ID using chunked IN (...) lists
+     * rather than one query per ID. Chunks are padded to a power of
+     * two so that only a handful of distinct statements are prepared
+     * for the statement cache. IDs that are not in the database are
+     * skipped, and repeated IDs are repeated in the result.
+     */
+    template<typename T, typename Getter>
+    QVector<T> GetByIds(const QVector<int> &ids, const QString &idColumn, Getter getter)
+    {
+        constexpr int maxChunk = 512; //well below SQLITE_MAX_VARIABLE_NUMBER
+        QVector<T> ret;
+        if (ids.isEmpty())
+            return ret;
+
+        QVector<int> unique;
+        unique.reserve(ids.count());
+        {
+            QSet<int> seen;
+            for (int id : ids)
+            {
+                if (!seen.contains(id))
+                {
+                    seen.insert(id);
+                    unique.append(id);
+                }
+            }
+        }
+
+        QHash<int, T> found;
+        for (int start = 0; start < unique.count(); start += maxChunk)
+        {
+            int remaining = qMin(maxChunk, unique.count() - start);
+            int chunk = 1;
+            while (chunk < remaining)
+                chunk *= 2;
+
+            QString whereClause = "WHERE " + idColumn + " IN (";
+            QVector<std::tuple<QString, QVariant>> variables;
+            variables.reserve(chunk);
+            for (int i = 0; i < chunk; i++)
+            {
+                QString key = ":id" + QString::number(i);
+                if (i > 0)
+                    whereClause.append(QStringLiteral(", "));
+                whereClause.append(key);
+                //pad the chunk by repeating the last ID
+                variables.append(std::make_tuple<QString, QVariant>(std::move(key), unique.at(start + qMin(i, remaining - 1))));
+            }
+            whereClause.append(')');
+
+            for (const T &record : getter(whereClause, variables))
+                found.insert(record.id, record);
+        }
+
+        ret.reserve(ids.count());
+        for (int id : ids)
+        {
+            auto it = found.constFind(id);
+            if (it != found.constEnd())
+                ret.append(it.value());
+        }
+        return ret;
+    }
+
+    /**
+     * @brief SearchTerms
+     * @param text
+     * @return The words of a user's search, in order.
+     */
+    QStringList SearchTerms(const QString &text)
+    {
+        const QString simplified = text.simplified();
+        if (simplified.isEmpty())
+            return {};
+        return simplified.split(QLatin1Char(' '));
+    }
+
+    /**
+     * @brief MatchQuery
+     * @param terms
+     * @return An FTS5 query matching every term as a prefix. Each term
+     * is quoted so that punctuation and the FTS5 operators a user
+     * types ("AND", "-", "*", ...) are matched literally.
+     */
+    QString MatchQuery(const QStringList &terms)
+    {
+        QStringList ret;
+        ret.reserve(terms.count());
+        for (QString term : terms)
+            ret.append('"' + term.replace('"', QStringLiteral("\"\"")) + "\"*");
+        return ret.join(' ');
+    }
+
+    /**
+     * @brief The SearchClauses struct holds the sources and conditions
+     * that match a user's search against the rules (STIGCheck) and the
+     * checklist answers (CKLCheck), and the variables they bind.
+     */
+    struct SearchClauses
+    {
+        QString ruleSource;
+        QString ruleMatch;
+        QString ruleRank;
+        QString findingSource;
+        QString findingMatch;
+        QString findingRank;
+        QVector<std::tuple<QString, QVariant>> variables;
+    };
+
+    /**
+     * @brief IsSearchIndexed
+     * @param q
+     * @return @c True when the full-text search tables exist.
+     * Otherwise, @c false.
+     */
+    bool IsSearchIndexed(DbQuery &q)
+    {
+        q.prepare(QStringLiteral("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name IN ('STIGCheckSearch', 'CKLCheckSearch')"));
+        return q.exec() && q.next() && q.value(0).toInt() == 2;
+    }
+
+    /**
+     * @brief BuildSearchClauses
+     * @param terms
+     * @param indexed
+     * @return The clauses matching every one of @a terms, served by
+     * the full-text indexes when @a indexed is @c true and by scanning
+     * the tables otherwise. Scanned matches all have a rank of 0.
+     */
+    SearchClauses BuildSearchClauses(const QStringList &terms, bool indexed)
+    {
+        SearchClauses ret;
+        ret.ruleSource = indexed ? QStringLiteral("STIGCheckSearch JOIN STIGCheck ON STIGCheck.id = STIGCheckSearch.rowid") : QStringLiteral("STIGCheck");
+        ret.findingSource = indexed ? QStringLiteral("CKLCheckSearch JOIN CKLCheck ON CKLCheck.id = CKLCheckSearch.rowid") : QStringLiteral("CKLCheck");
+        ret.ruleRank = indexed ? QStringLiteral("STIGCheckSearch.rank") : QStringLiteral("0");
+        ret.findingRank = indexed ? QStringLiteral("CKLCheckSearch.rank") : QStringLiteral("0");
+        if (indexed)
+        {
+            ret.ruleMatch = QStringLiteral("STIGCheckSearch MATCH :match");
+            ret.findingMatch = QStringLiteral("CKLCheckSearch MATCH :match");
+            ret.variables.append(std::make_tuple<QString, QVariant>(QStringLiteral(":match"), MatchQuery(terms)));
+        }
+        else
+        {
+            QStringList ruleTerms;
+            QStringList findingTerms;
+            for (int i = 0; i < terms.count(); i++)
+            {
+                const QString key = ":term" + QString::number(i);
+                ruleTerms.append("(STIGCheck.rule LIKE " + key + " OR STIGCheck.vulnNum LIKE " + key + " OR STIGCheck.title LIKE " + key + " OR STIGCheck.vulnDiscussion LIKE " + key + " OR STIGCheck.`check` LIKE " + key + " OR STIGCheck.fix LIKE " + key + ")");
+                findingTerms.append("(CKLCheck.findingDetails LIKE " + key + " OR CKLCheck.comments LIKE " + key + ")");
+                ret.variables.append(std::make_tuple<QString, QVariant>(QString(key), QVariant("%" + terms.at(i) + "%")));
+            }
+            ret.ruleMatch = ruleTerms.join(QStringLiteral(" AND "));
+            ret.findingMatch = findingTerms.join(QStringLiteral(" AND "));
+        }
+        return ret;
+    }
+
+    /**
+     * @brief ReadSearchHits
+     * @param q
+     * @param ret
+     *
+     * Appends the rows of an executed search query (CKLCheck id,
+     * STIGCheck id, STIG id, Asset id, snippet, rank) to @a ret.
+     */
+    void ReadSearchHits(QSqlQuery &q, QVector<SearchHit> &ret)
+    {
+        while (q.next())
+        {
+            SearchHit hit;
+            hit.cklCheckId = q.value(0).toInt();
+            hit.stigCheckId = q.value(1).toInt();
+            hit.stigId = q.value(2).toInt();
+            hit.assetId = q.value(3).toInt();
+            hit.snippet = q.value(4).toString();
+            hit.rank = q.value(5).toDouble();
+            ret.append(hit);
+        }
+    }
+}
+
 /**
  * @class DbManager
  * @brief DbManager::DbManager represents the data layer for the
@@ -98,11 +636,16 @@ DbManager::DbManager(const QString& connectionName) : DbManager(
  * connection already provided.
  */
 DbManager::DbManager(const QString& path, const QString& connectionName) :
-    _dbPath(path),
-    _delayCommit(false),
-    _logLevel(-1)
+    _dbPath(path)
 {
-    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+
+    if (db.isValid() && !DbConnections::Owns(connectionName))
+    {
+        //left behind by a finished thread whose id has been reused
+        db = QSqlDatabase();
+        DbConnections::Remove(connectionName);
+    }
 
     if (!db.isValid())
     {
@@ -120,6 +663,9 @@ DbManager::DbManager(const QString& path, const QString& connectionName) :
 
         db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
         db.setDatabaseName(path);
+        //writers wait on each other instead of failing while a bulk import commits
+        db.setConnectOptions(QStringLiteral("QSQLITE_BUSY_TIMEOUT=30000"));
+        DbConnections::Register(connectionName);
 
         if (initialize)
             UpdateDatabaseFromVersion(0);
@@ -128,7 +674,10 @@ DbManager::DbManager(const QString& path, const QString& connectionName) :
         UpdateDatabaseFromVersion(version);
     }
 
-    if (!db.open())
+    if (!db.isOpen() && DbConnections::Open(db))
+        ConfigureConnection(db);
+
+    if (!db.isOpen())
     {
         Warning(QStringLiteral("Unable to Open DB"), "Unable to open DB " + path);
     }
@@ -153,8 +702,7 @@ DbManager::DbManager(const DbManager &db)
  */
 DbManager::DbManager(DbManager &&orig) noexcept :
     _dbPath(std::move(orig._dbPath)),
-    _delayCommit(orig._delayCommit),
-    _logLevel(orig._logLevel)
+    _delayCommit(std::move(orig._delayCommit))
 {
 }
 
@@ -166,14 +714,7 @@ DbManager::DbManager(DbManager &&orig) noexcept :
  */
 DbManager::~DbManager()
 {
-    if (_delayCommit)
-    {
-        QSqlDatabase db;
-        if (CheckDatabase(db))
-        {
-            db.commit();
-        }
-    }
+    _delayCommit.reset();
 }
 
 /**
@@ -181,15 +722,15 @@ DbManager::~DbManager()
  * @param right
  * @return this
  *
- * Copy Operator
+ * Copy Operator. A pending delayed commit is not copied; it stays
+ * with @a right.
  */
 DbManager &DbManager::operator=(const DbManager &right)
 {
     if (this != &right)
     {
-        _delayCommit = right._delayCommit;
+        _delayCommit.reset();
         _dbPath = right._dbPath;
-        _logLevel = right._logLevel;
     }
     return *this;
 }
@@ -205,9 +746,8 @@ DbManager &DbManager::operator=(DbManager &&orig) noexcept
 {
     if (this != &orig)
     {
-        _delayCommit = orig._delayCommit;
+        _delayCommit = std::move(orig._delayCommit);
         _dbPath = std::move(orig._dbPath);
-        _logLevel = orig._logLevel;
     }
     return *this;
 }
@@ -216,44 +756,24 @@ DbManager &DbManager::operator=(DbManager &&orig) noexcept
  * @brief DbManager::DelayCommit
  * @param delay
  *
- * When engaging in a large quantity of writes, the data may be
- * buffered in memory without committing the changes to the database
- * temporarily by setting @a delay to @c true. Setting @a delay to
- * @c false or destructing the database connection will commit the
- * changes that have been buffered.
+ * When engaging in a large quantity of writes, the writes may be
+ * grouped into a single transaction by setting @a delay to @c true.
+ * Setting @a delay to @c false or destructing the @a DbManager
+ * commits the transaction.
  *
- * Developers should be cautious: buffered changes may not show up in
- * parallel threads or in threads that are executing and need the
- * data that have not yet been committed.
+ * This is a @a DbTransaction owned by the @a DbManager; new code
+ * should declare a @a DbTransaction in the scope of the bulk
+ * operation instead. Since the database is in write-ahead-log mode,
+ * readers on other threads continue to see the last committed data
+ * until the transaction commits. Writers on other threads wait for
+ * the transaction to finish.
  */
 void DbManager::DelayCommit(bool delay)
 {
-    if (delay)
-    {
-        QSqlDatabase db;
-        if (CheckDatabase(db))
-        {
-            QSqlQuery q(db);
-            q.prepare(QStringLiteral("PRAGMA journal_mode = OFF"));
-            q.exec();
-            q.prepare(QStringLiteral("PRAGMA synchronous = OFF"));
-            q.exec();
-        }
-    }
-    else
-    {
-        QSqlDatabase db;
-        if (CheckDatabase(db))
-        {
-            QSqlQuery q(db);
-            q.prepare(QStringLiteral("PRAGMA journal_mode = ON"));
-            q.exec();
-            q.prepare(QStringLiteral("PRAGMA synchronous = ON"));
-            q.exec();
-            db.commit();
-        }
-    }
-    _delayCommit = delay;
+    if (delay && !_delayCommit)
+        _delayCommit = std::make_unique<DbTransaction>();
+    else if (!delay)
+        _delayCommit.reset();
 }
 
 /**
@@ -287,7 +807,7 @@ bool DbManager::AddAsset(Asset &asset)
     bool ret = false;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
 
         //check if Asset exists in the database
         q.prepare(QStringLiteral("SELECT count(*) FROM Asset WHERE hostName = :hostName"));
@@ -312,7 +832,6 @@ bool DbManager::AddAsset(Asset &asset)
         q.bindValue(QStringLiteral(":webDBSite"), asset.webDbSite);
         q.bindValue(QStringLiteral(":webDBInstance"), asset.webDbInstance);
         ret = q.exec();
-        db.commit();
         asset.id = q.lastInsertId().toInt();
         Log(6, QStringLiteral("AddAsset"), q);
     }
@@ -340,7 +859,7 @@ bool DbManager::AddCCI(CCI &cci, bool check)
     bool ret = false;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
 
         if (check)
         {
@@ -360,12 +879,9 @@ bool DbManager::AddCCI(CCI &cci, bool check)
         q.bindValue(QStringLiteral(":CCI"), cci.cci);
         q.bindValue(QStringLiteral(":definition"), cci.definition);
         ret = q.exec();
-        if (!_delayCommit)
-        {
-            db.commit();
-            cci.id = q.lastInsertId().toInt();
-        }
+        cci.id = q.lastInsertId().toInt();
         Log(6, QStringLiteral("AddCCI"), q);
+        EntityCache::InvalidateCCILookupTable();
     }
     return ret;
 }
@@ -439,7 +955,7 @@ bool DbManager::AddControl(const QString &control, const QString &title, const Q
             QSqlDatabase db;
             if (CheckDatabase(db))
             {
-                QSqlQuery q(db);
+                DbQuery q(db);
 
                 q.prepare(QStringLiteral("INSERT INTO Control (FamilyId, number, enhancement, title, description, importSeverity, importRelevanceOfThreat, importLikelihood, importImpact, importImpactDescription, importResidualRiskLevel, importRecommendations) VALUES(:FamilyId, :number, :enhancement, :title, :description, :importSeverity, :importRelevanceOfThreat, :importLikelihood, :importImpact, :importImpactDescription, :importResidualRiskLevel, :importRecommendations)"));
                 q.bindValue(QStringLiteral(":FamilyId"), f.id);
@@ -455,8 +971,6 @@ bool DbManager::AddControl(const QString &control, const QString &title, const Q
                 q.bindValue(QStringLiteral(":importResidualRiskLevel"), importResidualRiskLevel);
                 q.bindValue(QStringLiteral(":importRecommendations"), importRecommendations);
                 ret = q.exec();
-                if (!_delayCommit)
-                    db.commit();
                 Log(6, QStringLiteral("AddControl"), q);
             }
         }
@@ -510,13 +1024,11 @@ bool DbManager::AddFamily(const QString &acronym, const QString &description)
     bool ret = false;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         q.prepare(QStringLiteral("INSERT INTO Family (Acronym, Description) VALUES(:acronym, :description)"));
         q.bindValue(QStringLiteral(":acronym"), acronym);
         q.bindValue(QStringLiteral(":description"), Sanitize(description));
         ret = q.exec();
-        if (!_delayCommit)
-            db.commit();
         Log(6, QStringLiteral("AddFamily"), q);
     }
     return ret;
@@ -535,6 +1047,10 @@ bool DbManager::AddFamily(const QString &acronym, const QString &description)
  * When @a stigExists is @c true, the @a STIGChecks are added to the
  * existing @a STIG already in the database. Otherwise, if the
  * @a STIG already exists, the @a STIGChecks are not added.
+ *
+ * The @a STIGChecks, their @a CCI and legacy ID mappings, and the
+ * @a Supplements are written set-wise through BulkInsert() in a
+ * single transaction.
  */
 bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVector<Supplement> &supplements, bool stigExists)
 {
@@ -544,8 +1060,11 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
 
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        //the STIG and its checks are added as one unit
+        DbTransaction transaction;
+        DbQuery q(db);
         QVector<CCI> remapCCIs = GetRemapCCIs();
+        bool newSTIG = false;
 
         if (stig.id <= 0)
         {
@@ -573,8 +1092,7 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
                 q.bindValue(QStringLiteral(":fileName"), stig.fileName);
                 ret = q.exec();
                 stig.id = q.lastInsertId().toInt();
-                //do not delay this commit; the STIG should be added to the DB to prevent inconsistencies with adding the checks.
-                db.commit();
+                newSTIG = true;
                 Log(6, QStringLiteral("AddSTIG"), q);
             }
         }
@@ -584,104 +1102,65 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
             return ret;
         }
         ret = true; // we have a valid STIG
-        bool newChecks = false;
-        //store the old value of the "delay commit" feature. The STIGCheck additions will always be a delayed commit.
-        bool delayed = _delayCommit;
-        if (!delayed)
-            this->DelayCommit(true);
-
-        for (STIGCheck c : checks)
-        {
-            newChecks = true;
-            q.prepare(QStringLiteral("INSERT INTO STIGCheck (`STIGId`, `rule`, `vulnNum`, `groupTitle`, `ruleVersion`, `severity`, `weight`, `title`, `vulnDiscussion`, `falsePositives`, `falseNegatives`, `fix`, `check`, `documentable`, `mitigations`, `severityOverrideGuidance`, `checkContentRef`, `potentialImpact`, `thirdPartyTools`, `mitigationControl`, `responsibility`, `IAControls`, `targetKey`, `isRemap`) VALUES(:STIGId, :rule, :vulnNum, :groupTitle, :ruleVersion, :severity, :weight, :title, :vulnDiscussion, :falsePositives, :falseNegatives, :fix, :check, :documentable, :mitigations, :severityOverrideGuidance, :checkContentRef, :potentialImpact, :thirdPartyTools, :mitigationControl, :responsibility, :IAControls, :targetKey, :isRemap)"));
-            q.bindValue(QStringLiteral(":STIGId"), stig.id);
-            q.bindValue(QStringLiteral(":rule"), c.rule);
-            q.bindValue(QStringLiteral(":vulnNum"), c.vulnNum);
-            q.bindValue(QStringLiteral(":groupTitle"), c.groupTitle);
-            q.bindValue(QStringLiteral(":ruleVersion"), c.ruleVersion);
-            q.bindValue(QStringLiteral(":severity"), c.severity);
-            q.bindValue(QStringLiteral(":weight"), c.weight);
-            q.bindValue(QStringLiteral(":title"), c.title);
-            q.bindValue(QStringLiteral(":vulnDiscussion"), c.vulnDiscussion);
-            q.bindValue(QStringLiteral(":falsePositives"), c.falsePositives);
-            q.bindValue(QStringLiteral(":falseNegatives"), c.falseNegatives);
-            q.bindValue(QStringLiteral(":fix"), c.fix);
-            q.bindValue(QStringLiteral(":check"), c.check);
-            q.bindValue(QStringLiteral(":documentable"), c.documentable ? 1 : 0);
-            q.bindValue(QStringLiteral(":mitigations"), c.mitigations);
-            q.bindValue(QStringLiteral(":severityOverrideGuidance"), c.severityOverrideGuidance);
-            q.bindValue(QStringLiteral(":checkContentRef"), c.checkContentRef);
-            q.bindValue(QStringLiteral(":potentialImpact"), c.potentialImpact);
-            q.bindValue(QStringLiteral(":thirdPartyTools"), c.thirdPartyTools);
-            q.bindValue(QStringLiteral(":mitigationControl"), c.mitigationControl);
-            q.bindValue(QStringLiteral(":responsibility"), c.responsibility);
-            q.bindValue(QStringLiteral(":IAControls"), c.iaControls);
-            q.bindValue(QStringLiteral(":targetKey"), c.targetKey);
-            q.bindValue(QStringLiteral(":isRemap"), (c.isRemap || c.cciIds.isEmpty()) ? 1 : 0);
-            bool tmpRet = q.exec();
-            stigCheckRet = stigCheckRet && tmpRet;
-            if (!tmpRet)
+
+        //checks that are not mapped to at least one CCI are remapped
+        QVector<int> remapCCIIds;
+        QString remapCCIsStr = QString();
+        for (const CCI &cci : remapCCIs)
+        {
+            if (!remapCCIsStr.isEmpty())
+                remapCCIsStr = remapCCIsStr + QStringLiteral(", ");
+            remapCCIsStr = remapCCIsStr + PrintCCI(cci);
+            remapCCIIds.append(cci.id);
+        }
+
+        QVector<QVariantList> checkRows;
+        checkRows.reserve(checks.count());
+        for (const STIGCheck &c : checks)
+        {
+            checkRows.append({stig.id, c.rule, c.vulnNum, c.groupTitle, c.ruleVersion, c.severity, c.weight, c.title, c.vulnDiscussion, c.falsePositives, c.falseNegatives, c.fix, c.check, c.documentable ? 1 : 0, c.mitigations, c.severityOverrideGuidance, c.checkContentRef, c.potentialImpact, c.thirdPartyTools, c.mitigationControl, c.responsibility, c.iaControls, c.targetKey, (c.isRemap || c.cciIds.isEmpty()) ? 1 : 0});
+        }
+        QVector<int> checkIds;
+        stigCheckRet = BulkInsert(QStringLiteral("STIGCheck"), {QStringLiteral("STIGId"), QStringLiteral("rule"), QStringLiteral("vulnNum"), QStringLiteral("groupTitle"), QStringLiteral("ruleVersion"), QStringLiteral("severity"), QStringLiteral("weight"), QStringLiteral("title"), QStringLiteral("vulnDiscussion"), QStringLiteral("falsePositives"), QStringLiteral("falseNegatives"), QStringLiteral("fix"), QStringLiteral("check"), QStringLiteral("documentable"), QStringLiteral("mitigations"), QStringLiteral("severityOverrideGuidance"), QStringLiteral("checkContentRef"), QStringLiteral("potentialImpact"), QStringLiteral("thirdPartyTools"), QStringLiteral("mitigationControl"), QStringLiteral("responsibility"), QStringLiteral("IAControls"), QStringLiteral("targetKey"), QStringLiteral("isRemap")}, checkRows, &checkIds);
+
+        QVector<QVariantList> cciRows;
+        QVector<QVariantList> legacyIdRows;
+        for (int i = 0; i < checks.count(); i++)
+        {
+            const STIGCheck &c = checks.at(i);
+            int STIGCheckId = checkIds.value(i, -1);
+            if (STIGCheckId <= 0)
             {
                 //for every check that can't be added, pop a warning.
                 Warning(QStringLiteral("Unable to Add STIGCheck"), "The STIGCheck " + PrintSTIGCheck(c) + " could not be added to STIG " + PrintSTIG(stig) + ".");
+                continue;
             }
-            int STIGCheckId = q.lastInsertId().toInt();
-            Log(6, QStringLiteral("AddSTIG-check"), q);
-            if (STIGCheckId > 0)
-            {
-                //check if the STIG is mapped to at least one CCI
-                if (c.cciIds.isEmpty())
-                {
-                    c.isRemap = true;
-                    QString remapCCIsStr = QString();
-                    for (CCI cci : remapCCIs)
-                    {
-                        if (!remapCCIsStr.isEmpty())
-                            remapCCIsStr = remapCCIsStr + QStringLiteral(", ");
-                        remapCCIsStr = remapCCIsStr + PrintCCI(cci);
-                        c.cciIds.append(cci.id);
-                    }
-                    Warning(QStringLiteral("Broken CCI"), "The STIGCheck rule " + c.rule + " is not mapped against a known CCI. If you are importing a STIG, please file a bug with the STIG author (probably DISA, disa.stig_spt@mail.mil) and let them know that their CCI mapping for the STIG you are trying to import is broken. For now, this broken STIG check is being remapped to " + remapCCIsStr + ". <a href=\"mailto:disa.stig_spt@mail.mil?subject=Incorrectly%20Mapped%20STIG%20Check&body=DISA,%0d" + PrintSTIG(stig) + "%20contains%20rule%20" + c.rule + "%20mapped%20against%20an%20unknown%20CCI%20which%20does%20not%20exist%20in%20the%20current%20version%20of%20NIST%20800-53r4.\">Click here</a> to file this bug with DISA automatically.");
-                }
-
-                for (int cciId : c.cciIds)
-                {
-                    q.prepare(QStringLiteral("INSERT INTO STIGCheckCCI (`STIGCheckId`, `CCIId`) VALUES(:STIGCheckId, :CCIId)"));
-                    q.bindValue(QStringLiteral(":STIGCheckId"), STIGCheckId);
-                    q.bindValue(QStringLiteral(":CCIId"), cciId);
-                    ret = q.exec() && ret;
-                    Log(6, QStringLiteral("AddAsset-CCI"), q);
-                }
 
-                for (QString legacyId : c.legacyIds)
-                {
-                    q.prepare(QStringLiteral("INSERT INTO STIGCheckLegacyId (`STIGCheckId`, `LegacyId`) VALUES(:STIGCheckId, :LegacyId)"));
-                    q.bindValue(QStringLiteral(":STIGCheckId"), STIGCheckId);
-                    q.bindValue(QStringLiteral(":LegacyId"), legacyId);
-                    ret = q.exec() && ret;
-                    Log(6, QStringLiteral("AddAsset-LegacyIds"), q);
-                }
+            const QVector<int> &cciIds = c.cciIds.isEmpty() ? remapCCIIds : c.cciIds;
+            if (c.cciIds.isEmpty())
+            {
+                Warning(QStringLiteral("Broken CCI"), "The STIGCheck rule " + c.rule + " is not mapped against a known CCI. If you are importing a STIG, please file a bug with the STIG author (probably DISA, disa.stig_spt@mail.mil) and let them know that their CCI mapping for the STIG you are trying to import is broken. For now, this broken STIG check is being remapped to " + remapCCIsStr + ". <a href=\"mailto:disa.stig_spt@mail.mil?subject=Incorrectly%20Mapped%20STIG%20Check&body=DISA,%0d" + PrintSTIG(stig) + "%20contains%20rule%20" + c.rule + "%20mapped%20against%20an%20unknown%20CCI%20which%20does%20not%20exist%20in%20the%20current%20version%20of%20NIST%20800-53r4.\">Click here</a> to file this bug with DISA automatically.");
             }
+            for (int cciId : cciIds)
+                cciRows.append({STIGCheckId, cciId});
+            for (const QString &legacyId : c.legacyIds)
+                legacyIdRows.append({STIGCheckId, legacyId});
         }
-
-        for (auto supplement : supplements)
-        {
-            newChecks = true;
-            q.prepare(QStringLiteral("INSERT INTO Supplement (`STIGId`, `path`, `contents`) VALUES(:STIGId, :path, :contents)"));
-            q.bindValue(QStringLiteral(":STIGId"), stig.id);
-            q.bindValue(QStringLiteral(":path"), supplement.path);
-            q.bindValue(QStringLiteral(":contents"), supplement.contents);
-            ret = q.exec() && ret;
-            Log(6, QStringLiteral("AddAsset-Supplement"), q);
-        }
-
-        //restore the old value of the "delayed commit" feature
-        if (!delayed)
+        ret = BulkInsert(QStringLiteral("STIGCheckCCI"), {QStringLiteral("STIGCheckId"), QStringLiteral("CCIId")}, cciRows) && ret;
+        ret = BulkInsert(QStringLiteral("STIGCheckLegacyId"), {QStringLiteral("STIGCheckId"), QStringLiteral("LegacyId")}, legacyIdRows) && ret;
+
+        QVector<QVariantList> supplementRows;
+        supplementRows.reserve(supplements.count());
+        for (const Supplement &supplement : supplements)
+            supplementRows.append({stig.id, supplement.path, supplement.contents});
+        ret = BulkInsert(QStringLiteral("Supplement"), {QStringLiteral("STIGId"), QStringLiteral("path"), QStringLiteral("contents")}, supplementRows) && ret;
+        //the STIG is not kept without its mappings
+        if (!ret)
         {
-            this->DelayCommit(false);
+            transaction.Rollback();
+            if (newSTIG)
+                stig.id = -1;
         }
-        if (newChecks)
-            db.commit();
     }
     return ret && stigCheckRet;
 }
@@ -711,23 +1190,168 @@ bool DbManager::AddSTIGToAsset(const STIG &stig, const Asset &asset)
         //if so, attempt to add the relationship to the DB
         if (tmpAsset.id > 0 && tmpSTIG.id > 0)
         {
-            QSqlQuery q(db);
-                q.prepare(QStringLiteral("INSERT INTO AssetSTIG (`AssetId`, `STIGId`) VALUES(:AssetId, :STIGId)"));
+            DbTransaction transaction;
+            DbQuery q(db);
+            q.prepare(QStringLiteral("INSERT INTO AssetSTIG (`AssetId`, `STIGId`) VALUES(:AssetId, :STIGId)"));
+            q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
+            q.bindValue(QStringLiteral(":STIGId"), tmpSTIG.id);
+            ret = q.exec();
+            Log(6, QStringLiteral("AddSTIGToAsset"), q);
+            if (ret)
+            {
+                q.prepare(QStringLiteral("INSERT INTO CKLCheck (AssetId, STIGCheckId, status, findingDetails, comments, severityOverride, severityJustification) SELECT :AssetId, id, :status, '', '', '', '' FROM STIGCheck WHERE STIGId = :STIGId"));
                 q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
+                q.bindValue(QStringLiteral(":status"), Status::NotReviewed);
                 q.bindValue(QStringLiteral(":STIGId"), tmpSTIG.id);
                 ret = q.exec();
-                Log(6, QStringLiteral("AddSTIGToAsset"), q);
-                if (ret)
-                {
-                    q.prepare(QStringLiteral("INSERT INTO CKLCheck (AssetId, STIGCheckId, status, findingDetails, comments, severityOverride, severityJustification) SELECT :AssetId, id, :status, '', '', '', '' FROM STIGCheck WHERE STIGId = :STIGId"));
-                    q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
-                    q.bindValue(QStringLiteral(":status"), Status::NotReviewed);
-                    q.bindValue(QStringLiteral(":STIGId"), tmpSTIG.id);
-                    ret = q.exec();
-                    db.commit();
-                    Log(6, QStringLiteral("AddSTIGToAsset-2"), q);
-                }
+                Log(6, QStringLiteral("AddSTIGToAsset-2"), q);
+            }
+            if (!ret)
+                transaction.Rollback();
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::BulkInsert
+ * @param table
+ * @param columns
+ * @param rows
+ * @param ids
+ * @return @c True when every row is inserted into @a table.
+ * Otherwise, @c false.
+ *
+ * Inserts @a rows (each holding one value per column in @a columns)
+ * using multi-row INSERT statements. The number of rows in each
+ * statement keeps the bound values below SQLite's default variable
+ * limit and their text and BLOB payload below 4 MiB, so that large
+ * @a Supplement files are not bound hundreds at a time. A statement
+ * shortened by its payload holds a power of two rows, which keeps
+ * the number of distinct statements in the statement cache small.
+ * The insert joins the open @a DbTransaction or runs in its own.
+ *
+ * When @a ids is provided, it receives the database ID of each row
+ * in the order of @a rows, or -1 for a row that could not be
+ * inserted. The rows of one statement receive consecutive IDs since
+ * the tables use AUTOINCREMENT and the transaction holds the write
+ * lock. If a statement fails, its rows are retried one at a time so
+ * that a single bad row does not discard its neighbors.
+ */
+bool DbManager::BulkInsert(const QString &table, const QStringList &columns, const QVector<QVariantList> &rows, QVector<int> *ids)
+{
+    constexpr int maxVariables = 999; //SQLITE_MAX_VARIABLE_NUMBER before SQLite 3.32
+    constexpr qint64 maxPayloadBytes = 4 * 1024 * 1024;
+    QSqlDatabase db;
+    bool ret = true;
+    if (ids)
+        ids->fill(-1, rows.count());
+    if (rows.isEmpty() || columns.isEmpty())
+        return ret;
+    if (!CheckDatabase(db))
+        return false;
+
+    DbTransaction transaction;
+    DbQuery q(db);
+    const QString insert = "INSERT INTO `" + table + "` (`" + columns.join(QStringLiteral("`, `")) + "`) VALUES ";
+    QStringList placeholders;
+    for (int i = 0; i < columns.count(); i++)
+        placeholders.append(QStringLiteral("?"));
+    const QString valueRow = "(" + placeholders.join(QStringLiteral(", ")) + ")";
+    const int rowsPerStatement = qMax(1, maxVariables / static_cast<int>(columns.count()));
+
+    auto payloadBytes = [&rows](int row) {
+        qint64 bytes = 0;
+        for (const QVariant &value : rows.at(row))
+        {
+            if (value.userType() == QMetaType::QByteArray)
+                bytes += value.toByteArray().size();
+            else if (value.userType() == QMetaType::QString)
+                bytes += value.toString().size() * static_cast<qint64>(sizeof(QChar));
+        }
+        return bytes;
+    };
+
+    auto insertRows = [&](int start, int count) {
+        QString sql = insert;
+        sql.reserve(insert.size() + count * (valueRow.size() + 2));
+        for (int i = 0; i < count; i++)
+        {
+            if (i > 0)
+                sql.append(QStringLiteral(", "));
+            sql.append(valueRow);
         }
+        q.prepare(sql);
+        for (int i = start; i < start + count; i++)
+        {
+            for (const QVariant &value : rows.at(i))
+                q.addBindValue(value);
+        }
+        bool tmpRet = q.exec();
+        if (tmpRet && ids)
+        {
+            int lastId = q.lastInsertId().toInt();
+            for (int i = 0; i < count; i++)
+                (*ids)[start + i] = lastId - count + 1 + i;
+        }
+        Log(6, "BulkInsert-" + table, q);
+        return tmpRet;
+    };
+
+    for (int start = 0; start < rows.count();)
+    {
+        int count = qMin(rowsPerStatement, static_cast<int>(rows.count()) - start);
+        qint64 bytes = payloadBytes(start);
+        int fit = 1;
+        while (fit < count)
+        {
+            bytes += payloadBytes(start + fit);
+            if (bytes > maxPayloadBytes)
+                break;
+            fit++;
+        }
+        if (fit < count)
+        {
+            count = 1;
+            while (count * 2 <= fit)
+                count *= 2;
+        }
+        bool tmpRet = insertRows(start, count);
+        if (!tmpRet && count > 1)
+        {
+            tmpRet = true;
+            for (int i = start; i < start + count; i++)
+                tmpRet = insertRows(i, 1) && tmpRet;
+        }
+        ret = tmpRet && ret;
+        start += count;
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::CheckComplianceSummary
+ * @return The number of (Asset, STIG, severity, status) counts in the
+ * ComplianceSummary table that differ from the checklists, or -1 when
+ * the check cannot run.
+ *
+ * The summary is maintained by triggers on the CKLCheck and
+ * STIGCheck tables, so it only drifts if the database is edited
+ * outside of STIGQter with the triggers dropped. A mismatch is
+ * logged; RebuildComplianceSummary() corrects it.
+ */
+int DbManager::CheckComplianceSummary()
+{
+    QSqlDatabase db;
+    int ret = -1;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        //the stored counts minus the counted checks; every key that does not cancel out is wrong
+        q.prepare("SELECT COUNT(*) FROM (SELECT 1 FROM (SELECT `AssetId`, `STIGId`, `severity`, `status`, `checks` FROM `ComplianceSummary` UNION ALL " + ComplianceSummaryQuery(QStringLiteral("-COUNT(*)")) + ") GROUP BY `AssetId`, `STIGId`, `severity`, `status` HAVING SUM(`checks`) <> 0)");
+        if (q.exec() && q.next())
+            ret = q.value(0).toInt();
+        Log(ret == 0 ? 6 : 4, QStringLiteral("CheckComplianceSummary"), q);
     }
     return ret;
 }
@@ -758,12 +1382,10 @@ bool DbManager::DeleteAsset(const Asset &asset)
         QSqlDatabase db;
         if (CheckDatabase(db))
         {
-            QSqlQuery q(db);
+            DbQuery q(db);
             q.prepare(QStringLiteral("DELETE FROM Asset WHERE id = :AssetId"));
             q.bindValue(QStringLiteral(":AssetId"), asset.id);
             ret = q.exec();
-            if (!_delayCommit)
-                db.commit();
             Log(6, QStringLiteral("DeleteAsset"), q);
         }
     }
@@ -789,7 +1411,8 @@ bool DbManager::DeleteCCIs()
     if (CheckDatabase(db))
     {
         ret = true; //assume success until one of the queries fails.
-        QSqlQuery q(db);
+        DbTransaction transaction;
+        DbQuery q(db);
         q.prepare(QStringLiteral("DELETE FROM Family"));
         ret = q.exec() && ret; //q.exec() first to avoid short-circuit evaluation
         Log(6, QStringLiteral("DeleteCCIs-Family"), q);
@@ -798,9 +1421,13 @@ bool DbManager::DeleteCCIs()
         Log(6, QStringLiteral("DeleteCCIs-Control"), q);
         q.prepare(QStringLiteral("DELETE FROM CCI"));
         ret = q.exec() && ret;
-        if (!_delayCommit)
-            db.commit();
         Log(6, QStringLiteral("DeleteCCIs-CCI"), q);
+        if (!ret)
+            transaction.Rollback();
+        EntityCache::Families().Clear();
+        EntityCache::Controls().Clear();
+        EntityCache::CCIs().Clear();
+        EntityCache::InvalidateCCILookupTable();
     }
     return ret;
 }
@@ -812,14 +1439,28 @@ bool DbManager::DeleteCCIs()
  */
 bool DbManager::DeleteDB()
 {
+    //the log writer's connection must not see the file being replaced
+    LogWriter::Instance()->Suspend();
+    QSqlDatabase db;
+    if (CheckDatabase(db) && !ReleaseDatabaseFile(db, _dbPath))
+    {
+        LogWriter::Instance()->Resume();
+        Warning(QStringLiteral("Database In Use"), "The database " + _dbPath + " is still in use; wait for running tasks to finish and try again.");
+        return false;
+    }
+    EntityCache::Clear();
+    cachedLogLevel = -1;
+
+    bool ret = false;
     QFile dest(_dbPath);
     if (dest.open(QFile::WriteOnly))
     {
         dest.write("", 0);
         dest.close();
-        return UpdateDatabaseFromVersion(0);
+        ret = UpdateDatabaseFromVersion(0);
     }
-    return false;
+    LogWriter::Instance()->Resume();
+    return ret;
 }
 
 /**
@@ -833,12 +1474,11 @@ bool DbManager::DeleteEmassImport()
     bool ret = false;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         q.prepare(QStringLiteral("UPDATE CCI SET isImport = 0, importCompliance = NULL, importDateTested = NULL, importTestedBy = NULL, importTestResults = NULL, importCompliance2 = NULL, importDateTested2 = NULL, importTestedBy2 = NULL, importTestResults2 = NULL, importControlImplementationStatus = NULL, importSecurityControlDesignation = NULL, importInherited = NULL, importRemoteInheritanceInstance = NULL, importApNum = NULL, importImplementationGuidance = NULL, importAssessmentProcedures = NULL, importNarrative = NULL"));
         ret = q.exec();
-        if (!_delayCommit)
-            db.commit();
         Log(6, QStringLiteral("DeleteEmassImport"), q);
+        EntityCache::CCIs().Clear();
     }
     return ret;
 }
@@ -869,7 +1509,8 @@ bool DbManager::DeleteSTIG(int id)
             Warning(QStringLiteral("STIG In Use"), "The Asset" + Pluralize(tmpCount) + tmpAssetStr + " " + Pluralize(tmpCount, QStringLiteral("are"), QStringLiteral("is")) + " currently using the selected STIG.");
             return ret;
         }
-        QSqlQuery q(db);
+        DbTransaction transaction;
+        DbQuery q(db);
         ret = true; //assume success from here.
         q.prepare(QStringLiteral("DELETE FROM STIGCheckCCI WHERE STIGCheckId IN (SELECT id FROM STIGCheck WHERE STIGId = :STIGId)"));
         q.bindValue(QStringLiteral(":STIGId"), id);
@@ -889,9 +1530,11 @@ bool DbManager::DeleteSTIG(int id)
         q.prepare(QStringLiteral("DELETE FROM STIG WHERE id = :id"));
         q.bindValue(QStringLiteral(":id"), id);
         ret = q.exec() && ret;
-        if (!_delayCommit)
-            db.commit();
         Log(6, QStringLiteral("DeleteSTIG-STIG"), q);
+        if (!ret)
+            transaction.Rollback();
+        EntityCache::STIGs().Remove(id);
+        EntityCache::STIGChecks().Clear();
     }
     return ret;
 }
@@ -927,7 +1570,8 @@ bool DbManager::DeleteSTIGFromAsset(const STIG &stig, const Asset &asset)
 
         if (tmpSTIG.id > 0 && tmpAsset.id > 0)
         {
-            QSqlQuery q(db);
+            DbTransaction transaction;
+            DbQuery q(db);
             ret = true; //assume success from this point
             q.prepare(QStringLiteral("DELETE FROM AssetSTIG WHERE AssetId = :AssetId AND STIGId = :STIGId"));
             q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
@@ -938,19 +1582,202 @@ bool DbManager::DeleteSTIGFromAsset(const STIG &stig, const Asset &asset)
             q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
             q.bindValue(QStringLiteral(":STIGId"), tmpSTIG.id);
             ret = q.exec() && ret;
-            db.commit();
             Log(6, QStringLiteral("DeleteSTIGFromAsset-CKLCheck"), q);
+            if (!ret)
+                transaction.Rollback();
         }
     }
     return ret;
 }
 
 /**
- * @brief DbManager::GetAsset
- * @param hostName
- * @return The @a Asset object associated with the supplied
- * @a hostName. If the hostname does not exist, the @a Asset that is
- * returned is the default empty one with an ID of -1.
+ * @brief DbManager::GetAssessmentSnapshot
+ * @return A read-only @a AssessmentSnapshot of the assessment for
+ * building reports. When the database cannot be opened, the snapshot
+ * is empty.
+ *
+ * The snapshot is read in one read transaction, so it is consistent
+ * even while other threads write checklists, with one bulk query per
+ * table instead of a query per entity. Only the @a STIGChecks of
+ * STIGs mapped to an @a Asset are loaded; the rest of the STIG
+ * library is not part of the assessment.
+ */
+std::shared_ptr<const AssessmentSnapshot> DbManager::GetAssessmentSnapshot()
+{
+    auto ret = std::make_shared<AssessmentSnapshot>();
+    QSqlDatabase db;
+    if (!CheckDatabase(db))
+        return ret;
+
+    //a deferred read transaction; the snapshot takes no write lock
+    const bool readTransaction = !DbTransaction::Active() && db.transaction();
+    QHash<QString, int> interned;
+    auto intern = [&ret, &interned](const QString &text) {
+        auto it = interned.constFind(text);
+        if (it != interned.constEnd())
+            return it.value();
+        const int index = static_cast<int>(ret->strings.count());
+        ret->strings.append(text);
+        interned.insert(text, index);
+        return index;
+    };
+    auto rowsById = [](const auto &entities) {
+        QHash<int, int> rows;
+        rows.reserve(entities.count());
+        for (int i = 0; i < entities.count(); i++)
+            rows.insert(entities.at(i).id, i);
+        return rows;
+    };
+
+    ret->assets = GetAssets();
+    ret->stigs = GetSTIGs();
+    ret->controls = GetControls();
+    ret->ccis = GetCCIs();
+    const QHash<int, int> assetRows = rowsById(ret->assets);
+    const QHash<int, int> stigRows = rowsById(ret->stigs);
+    const QHash<int, int> controlRows = rowsById(ret->controls);
+    const QHash<int, int> cciRows = rowsById(ret->ccis);
+
+    ret->controlNames.reserve(ret->controls.count());
+    for (const Control &control : std::as_const(ret->controls))
+        ret->controlNames.append(intern(PrintControl(control)));
+    ret->unmappedControlName = intern(PrintControl(Control()));
+
+    QVector<QPair<int, int>> controlCCIs;
+    ret->cciControls.reserve(ret->ccis.count());
+    for (int i = 0; i < ret->ccis.count(); i++)
+    {
+        const CCI &cci = ret->ccis.at(i);
+        const int control = controlRows.value(cci.controlId, -1);
+        ret->cciControls.append(control);
+        if (control >= 0)
+            controlCCIs.append(qMakePair(control, i));
+        if (cci.isImport)
+            ret->emassImport = true;
+    }
+    ret->controlCCIs = SnapshotAdjacency::FromPairs(static_cast<int>(ret->controls.count()), controlCCIs);
+
+    DbQuery q(db);
+    q.setForwardOnly(true);
+
+    //the STIGs mapped to each asset, in the order of the STIGs
+    QVector<QPair<int, int>> assetSTIGs;
+    q.prepare(QStringLiteral("SELECT AssetId, STIGId FROM AssetSTIG"));
+    q.exec();
+    while (q.next())
+    {
+        const int asset = assetRows.value(q.value(0).toInt(), -1);
+        const int stig = stigRows.value(q.value(1).toInt(), -1);
+        if (asset >= 0 && stig >= 0)
+            assetSTIGs.append(qMakePair(asset, stig));
+    }
+    std::sort(assetSTIGs.begin(), assetSTIGs.end());
+    assetSTIGs.erase(std::unique(assetSTIGs.begin(), assetSTIGs.end()), assetSTIGs.end());
+    ret->assetSTIGs = SnapshotAdjacency::FromPairs(static_cast<int>(ret->assets.count()), assetSTIGs);
+
+    //STIGChecks, with the text the reports print
+    SnapshotSTIGChecks &checks = ret->stigChecks;
+    QHash<int, int> checkRows;
+    QHash<QString, int> sameRows;
+    q.prepare(QStringLiteral("SELECT id, STIGId, severity, rule, ruleVersion, vulnNum, title, vulnDiscussion, fix FROM STIGCheck WHERE STIGId IN (SELECT STIGId FROM AssetSTIG) ORDER BY id"));
+    q.exec();
+    while (q.next())
+    {
+        const int stig = stigRows.value(q.value(1).toInt(), -1);
+        if (stig < 0)
+            continue;
+        const int row = checks.Count();
+        const QString rule = q.value(3).toString();
+        const QString ruleVersion = q.value(4).toString();
+        checkRows.insert(q.value(0).toInt(), row);
+        checks.id.append(q.value(0).toInt());
+        checks.stig.append(stig);
+        checks.severity.append(static_cast<quint8>(q.value(2).toInt()));
+        checks.rule.append(intern(rule));
+        checks.ruleVersion.append(intern(ruleVersion));
+        checks.vulnNum.append(intern(q.value(5).toString()));
+        checks.title.append(intern(q.value(6).toString()));
+        checks.vulnDiscussion.append(intern(q.value(7).toString()));
+        checks.fix.append(intern(q.value(8).toString()));
+        //STIGChecks compare equal when their rules and rule versions match, ignoring case
+        const QString sameKey = rule.toCaseFolded() + QChar(0) + ruleVersion.toCaseFolded();
+        const int same = sameRows.value(sameKey, row);
+        if (same == row)
+            sameRows.insert(sameKey, row);
+        checks.same.append(same);
+    }
+
+    //the CCIs of each STIGCheck, in mapping order
+    QVector<QPair<int, int>> checkCCIs;
+    q.prepare(QStringLiteral("SELECT STIGCheckId, CCIId FROM STIGCheckCCI WHERE STIGCheckId IN (SELECT id FROM STIGCheck WHERE STIGId IN (SELECT STIGId FROM AssetSTIG)) ORDER BY id"));
+    q.exec();
+    while (q.next())
+    {
+        const int check = checkRows.value(q.value(0).toInt(), -1);
+        const int cci = cciRows.value(q.value(1).toInt(), -1);
+        if (check >= 0 && cci >= 0)
+            checkCCIs.append(qMakePair(check, cci));
+    }
+    ret->stigCheckCCIs = SnapshotAdjacency::FromPairs(checks.Count(), checkCCIs);
+
+    //CKLChecks; the finding details and comments repeat often, so they are interned
+    SnapshotCKLChecks &findings = ret->cklChecks;
+    q.prepare(QStringLiteral("SELECT id, AssetId, STIGCheckId, status, severityOverride, findingDetails, comments, severityJustification FROM CKLCheck ORDER BY id"));
+    q.exec();
+    while (q.next())
+    {
+        const int asset = assetRows.value(q.value(1).toInt(), -1);
+        const int check = checkRows.value(q.value(2).toInt(), -1);
+        if (asset < 0 || check < 0)
+            continue;
+        const auto severityOverride = static_cast<quint8>(q.value(4).toInt());
+        findings.id.append(q.value(0).toInt());
+        findings.asset.append(asset);
+        findings.stigCheck.append(check);
+        findings.status.append(static_cast<quint8>(q.value(3).toInt()));
+        findings.severityOverride.append(severityOverride);
+        findings.severity.append(severityOverride == static_cast<quint8>(Severity::none) ? checks.severity.at(check) : severityOverride);
+        findings.findingDetails.append(intern(q.value(5).toString()));
+        findings.comments.append(intern(q.value(6).toString()));
+        findings.severityJustification.append(intern(q.value(7).toString()));
+    }
+    q.finish();
+    if (readTransaction)
+        db.commit();
+
+    QVector<QPair<int, int>> assetFindings;
+    QVector<QPair<int, int>> cciFindings;
+    assetFindings.reserve(findings.Count());
+    for (int i = 0; i < findings.Count(); i++)
+    {
+        assetFindings.append(qMakePair(findings.asset.at(i), i));
+        const auto mapped = ret->stigCheckCCIs.At(findings.stigCheck.at(i));
+        for (const int *cci = mapped.begin(); cci != mapped.end(); cci++)
+        {
+            //a CCI mapped twice to the same rule lists the check once
+            if (std::find(mapped.begin(), cci, *cci) == cci)
+                cciFindings.append(qMakePair(*cci, i));
+        }
+    }
+    //each asset's checks are grouped by STIG, in the order of its mapped STIGs
+    std::stable_sort(assetFindings.begin(), assetFindings.end(), [&ret](const QPair<int, int> &left, const QPair<int, int> &right) {
+        if (left.first != right.first)
+            return left.first < right.first;
+        return ret->CKLCheckSTIG(left.second) < ret->CKLCheckSTIG(right.second);
+    });
+    ret->assetCKLChecks = SnapshotAdjacency::FromPairs(static_cast<int>(ret->assets.count()), assetFindings);
+    ret->cciCKLChecks = SnapshotAdjacency::FromPairs(static_cast<int>(ret->ccis.count()), cciFindings);
+
+    ret->strings.squeeze();
+    return ret;
+}
+
+/**
+ * @brief DbManager::GetAsset
+ * @param hostName
+ * @return The @a Asset object associated with the supplied
+ * @a hostName. If the hostname does not exist, the @a Asset that is
+ * returned is the default empty one with an ID of -1.
  */
 Asset DbManager::GetAsset(const QString &hostName)
 {
@@ -1054,7 +1881,7 @@ QVector<Asset> DbManager::GetAssets(const QString &whereClause, const QVector<st
     QVector<Asset> ret;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         QString toPrep = QStringLiteral("SELECT Asset.`id`, Asset.`assetType`, Asset.`hostName`, Asset.`hostIP`, Asset.`hostMAC`, Asset.`hostFQDN`, Asset.`techArea`, Asset.`targetKey`, Asset.`marking`, Asset.`targetComment`, Asset.`webOrDatabase`, Asset.`webDBSite`, Asset.`webDBInstance`");
         toPrep.append(QStringLiteral(" FROM Asset"));
         if (!whereClause.isNull() && !whereClause.isEmpty())
@@ -1091,6 +1918,23 @@ QVector<Asset> DbManager::GetAssets(const QString &whereClause, const QVector<st
     return ret;
 }
 
+/**
+ * @overload DbManager::GetAssets(const QVector<int> &ids)
+ * @brief DbManager::GetAssets
+ * @param ids
+ * @return The @a Assets specified by the provided database ids, in
+ * the order of @a ids. IDs that do not exist in the database are
+ * skipped.
+ *
+ * The @a Assets are loaded in batches rather than one query per ID.
+ */
+QVector<Asset> DbManager::GetAssets(const QVector<int> &ids)
+{
+    return GetByIds<Asset>(ids, QStringLiteral("Asset.id"), [this](const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables) {
+        return GetAssets(whereClause, variables);
+    });
+}
+
 /**
  * @overload DbManager::GetAssets(const STIG &stig)
  * @brief DbManager::GetAssets
@@ -1109,31 +1953,38 @@ QVector<Asset> DbManager::GetAssets(const STIG &stig)
  * @return The @a CCI specified by the provided database id. If the
  * @a CCI does not exist in the database, the default @a CCI with an
  * ID of -1 is returned.
+ *
+ * The @a CCI is read through the @a EntityCache.
  */
 CCI DbManager::GetCCI(int id)
 {
+    CCI ret;
+    if (EntityCache::CCIs().Find(id, ret))
+        return ret;
+    const quint64 generation = EntityCache::CCIs().Generation();
     QVector<CCI> ccis = GetCCIs(QStringLiteral("WHERE CCI.id = :id"), {std::make_tuple<QString, QVariant>(QStringLiteral(":id"), id)});
     if (!ccis.isEmpty())
+    {
+        EntityCache::CCIs().Insert(id, ccis.first(), generation);
         return ccis.first();
-    CCI ret;
+    }
     return ret;
 }
 
 /**
  * @brief DbManager::GetCCIs
  * @param ccis
- * @return The @a CCIs specified by the provided database ids. If a
- * @a CCI does not exist in the database, the default @a CCI with an
- * ID of -1 is returned.
+ * @return The @a CCIs specified by the provided database ids, in the
+ * order of @a ccis. IDs that do not exist in the database are
+ * skipped.
+ *
+ * The @a CCIs are loaded in batches rather than one query per ID.
  */
 QVector<CCI> DbManager::GetCCIs(const QVector<int> &ccis)
 {
-    QVector<CCI> ret;
-    for (int cci : ccis)
-    {
-        ret.append(GetCCIs(QStringLiteral("WHERE CCI.id = :id"), {std::make_tuple<QString, QVariant>(QStringLiteral(":id"), cci)}));
-    }
-    return ret;
+    return GetByIds<CCI>(ccis, QStringLiteral("CCI.id"), [this](const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables) {
+        return GetCCIs(whereClause, variables);
+    });
 }
 
 /**
@@ -1159,7 +2010,7 @@ QVector<CCI> DbManager::GetCCIs(int STIGCheckId)
     QSqlDatabase db;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         q.prepare(QStringLiteral("SELECT CCIId FROM STIGCheckCCI WHERE STIGCheckCCI.STIGCheckId = :STIGCheckId"));
         q.bindValue(QStringLiteral(":STIGCheckId"), STIGCheckId);
         q.exec();
@@ -1210,6 +2061,39 @@ CCI DbManager::GetCCIByCCI(int cci, const STIG *stig)
     return ret;
 }
 
+/**
+ * @brief DbManager::GetCCILookup
+ * @return The database id of every @a CCI by CCI number, loaded with
+ * one query.
+ *
+ * The table is cached until a @a CCI is added, renumbered, or
+ * deleted, so every STIG imported between CCI imports shares one
+ * table. It is read-only and may be used from any thread.
+ */
+std::shared_ptr<const CCILookup> DbManager::GetCCILookup()
+{
+    std::shared_ptr<const CCILookup> cached = EntityCache::CCILookupTable();
+    if (cached)
+        return cached;
+
+    const quint64 generation = EntityCache::CCILookupGeneration();
+    auto ret = std::make_shared<CCILookup>();
+    QSqlDatabase db;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        q.setForwardOnly(true);
+        q.prepare(QStringLiteral("SELECT id, cci FROM CCI"));
+        if (q.exec())
+        {
+            while (q.next())
+                ret->Insert(q.value(1).toInt(), q.value(0).toInt());
+            EntityCache::SetCCILookupTable(ret, generation);
+        }
+    }
+    return ret;
+}
+
 /**
  * @overload GetCCI
  * @brief DbManager::GetCCI
@@ -1228,6 +2112,72 @@ CCI DbManager::GetCCI(const CCI &cci, const STIG *stig)
     return GetCCI(cci.id);
 }
 
+/**
+ * @brief DbManager::ForEachCCI
+ * @param callback
+ * @param whereClause
+ * @param variables
+ * @return @c True when the query runs. Otherwise, @c false.
+ *
+ * Streams the @a CCIs selected by the optional @a whereClause to
+ * @a callback one row at a time from a forward-only query, so only
+ * one @a CCI is held in memory. Returning @c false from @a callback
+ * stops the iteration. The @a callback must not modify the CCI
+ * table. See GetCCIs() for the parameter conventions.
+ */
+bool DbManager::ForEachCCI(const std::function<bool (const CCI &)> &callback, const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    QSqlDatabase db;
+    bool ret = false;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        q.setForwardOnly(true);
+        QString toPrep = QStringLiteral("SELECT id, ControlId, cci, definition, isImport, importCompliance, importDateTested, importTestedBy, importTestResults, importCompliance2, importDateTested2, importTestedBy2, importTestResults2, importControlImplementationStatus, importSecurityControlDesignation, importInherited, importRemoteInheritanceInstance, importApNum, importImplementationGuidance, importAssessmentProcedures, importNarrative FROM CCI");
+        if (!whereClause.isNull() && !whereClause.isEmpty())
+            toPrep.append(" " + whereClause);
+        toPrep.append(QStringLiteral(" ORDER BY cci"));
+        q.prepare(toPrep);
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
+        ret = q.exec();
+        while (q.next())
+        {
+            CCI c;
+            c.id = q.value(0).toInt();
+            c.controlId = q.value(1).toInt();
+            c.cci = q.value(2).toInt();
+            c.definition = q.value(3).toString();
+            c.isImport = q.value(4).toBool();
+            c.importCompliance = q.value(5).toString();
+            c.importDateTested = q.value(6).toString();
+            c.importTestedBy = q.value(7).toString();
+            c.importTestResults = q.value(8).toString();
+            c.importCompliance2 = q.value(9).toString();
+            c.importDateTested2 = q.value(10).toString();
+            c.importTestedBy2 = q.value(11).toString();
+            c.importTestResults2 = q.value(12).toString();
+            c.importControlImplementationStatus = q.value(13).toString();
+            c.importSecurityControlDesignation = q.value(14).toString();
+            c.importInherited = q.value(15).toString();
+            c.importRemoteInheritanceInstance = q.value(16).toString();
+            c.importApNum = q.value(17).toString();
+            c.importImplementationGuidance = q.value(18).toString();
+            c.importAssessmentProcedures = q.value(19).toString();
+            c.importNarrative = q.value(20).toString();
+
+            if (!callback(c))
+                break;
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::GetCCIs
  * @param whereClause
@@ -1278,52 +2228,11 @@ CCI DbManager::GetCCI(const CCI &cci, const STIG *stig)
  */
 QVector<CCI> DbManager::GetCCIs(const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables)
 {
-    QSqlDatabase db;
     QVector<CCI> ret;
-    if (CheckDatabase(db))
-    {
-        QSqlQuery q(db);
-        QString toPrep = QStringLiteral("SELECT id, ControlId, cci, definition, isImport, importCompliance, importDateTested, importTestedBy, importTestResults, importCompliance2, importDateTested2, importTestedBy2, importTestResults2, importControlImplementationStatus, importSecurityControlDesignation, importInherited, importRemoteInheritanceInstance, importApNum, importImplementationGuidance, importAssessmentProcedures, importNarrative FROM CCI");
-        if (!whereClause.isNull() && !whereClause.isEmpty())
-            toPrep.append(" " + whereClause);
-        toPrep.append(QStringLiteral(" ORDER BY cci"));
-        q.prepare(toPrep);
-        for (const auto &variable : variables)
-        {
-            QString key;
-            QVariant val;
-            std::tie(key, val) = variable;
-            q.bindValue(key, val);
-        }
-        q.exec();
-        while (q.next())
-        {
-            CCI c;
-            c.id = q.value(0).toInt();
-            c.controlId = q.value(1).toInt();
-            c.cci = q.value(2).toInt();
-            c.definition = q.value(3).toString();
-            c.isImport = q.value(4).toBool();
-            c.importCompliance = q.value(5).toString();
-            c.importDateTested = q.value(6).toString();
-            c.importTestedBy = q.value(7).toString();
-            c.importTestResults = q.value(8).toString();
-            c.importCompliance2 = q.value(9).toString();
-            c.importDateTested2 = q.value(10).toString();
-            c.importTestedBy2 = q.value(11).toString();
-            c.importTestResults2 = q.value(12).toString();
-            c.importControlImplementationStatus = q.value(13).toString();
-            c.importSecurityControlDesignation = q.value(14).toString();
-            c.importInherited = q.value(15).toString();
-            c.importRemoteInheritanceInstance = q.value(16).toString();
-            c.importApNum = q.value(17).toString();
-            c.importImplementationGuidance = q.value(18).toString();
-            c.importAssessmentProcedures = q.value(19).toString();
-            c.importNarrative = q.value(20).toString();
-
-            ret.append(c);
-        }
-    }
+    ForEachCCI([&ret](const CCI &cci) {
+        ret.append(cci);
+        return true;
+    }, whereClause, variables);
     return ret;
 }
 
@@ -1384,7 +2293,7 @@ CKLCheck DbManager::GetCKLCheck(const CKLCheck &ckl)
  */
 CKLCheck DbManager::GetCKLCheckByDISAId(int assetId, const QString &disaId)
 {
-    QVector<CKLCheck> ret = GetCKLChecks(QStringLiteral("JOIN STIGCheck ON CKLCheck.STIGCheckId = STIGCheck.id WHERE AssetId = :AssetId AND rule = :DISAId"), {
+    QVector<CKLCheck> ret = GetCKLChecks(QStringLiteral("JOIN STIGCheck ON CKLCheck.STIGCheckId = STIGCheck.id WHERE CKLCheck.AssetId = :AssetId AND STIGCheck.rule = :DISAId"), {
                         std::make_tuple<QString, QVariant>(QStringLiteral(":AssetId"), assetId),
                         std::make_tuple<QString, QVariant>(QStringLiteral(":DISAId"), disaId)
                     });
@@ -1442,6 +2351,93 @@ QVector<CKLCheck> DbManager::GetCKLChecks(const CCI &cci)
     return GetCKLChecks(QStringLiteral("WHERE STIGCheckId IN (SELECT STIGCheckId FROM STIGCheckCCI WHERE CCIId = :CCIId)"), {std::make_tuple<QString, QVariant>(QStringLiteral(":CCIId"), cci.id)});
 }
 
+/**
+ * @brief DbManager::CountCKLChecks
+ * @param whereClause
+ * @param variables
+ * @return The number of @a CKLChecks selected by the optional
+ * @a whereClause, without loading them.
+ */
+int DbManager::CountCKLChecks(const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    QSqlDatabase db;
+    int ret = 0;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        QString toPrep = QStringLiteral("SELECT COUNT(*) FROM CKLCheck");
+        if (!whereClause.isNull() && !whereClause.isEmpty())
+            toPrep.append(" " + whereClause);
+        q.prepare(toPrep);
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
+        if (q.exec() && q.next())
+            ret = q.value(0).toInt();
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::ForEachCKLCheck
+ * @param callback
+ * @param whereClause
+ * @param variables
+ * @return @c True when the query runs. Otherwise, @c false.
+ *
+ * Streams the @a CKLChecks selected by the optional @a whereClause
+ * to @a callback one row at a time from a forward-only query, so
+ * peak memory does not grow with the number of findings. Returning
+ * @c false from @a callback stops the iteration. The @a callback
+ * must not modify the CKLCheck table. See GetCKLChecks() for the
+ * parameter conventions.
+ */
+bool DbManager::ForEachCKLCheck(const std::function<bool (const CKLCheck &)> &callback, const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    QSqlDatabase db;
+    bool ret = false;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        q.setForwardOnly(true);
+        QString toPrep = QStringLiteral("SELECT CKLCheck.id, CKLCheck.AssetId, CKLCheck.STIGCheckId, CKLCheck.status, CKLCheck.findingDetails, CKLCheck.comments, CKLCheck.severityOverride, CKLCheck.severityJustification, CKLCheckRule.severity, CKLCheckRule.rule FROM CKLCheck LEFT JOIN STIGCheck AS CKLCheckRule ON CKLCheckRule.id = CKLCheck.STIGCheckId");
+        if (!whereClause.isNull() && !whereClause.isEmpty())
+            toPrep.append(" " + whereClause);
+        q.prepare(toPrep);
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
+        ret = q.exec();
+        while (q.next())
+        {
+            CKLCheck c;
+            c.id = q.value(0).toInt();
+            c.assetId = q.value(1).toInt();
+            c.stigCheckId = q.value(2).toInt();
+            c.status = static_cast<Status>(q.value(3).toInt());
+            c.findingDetails = q.value(4).toString();
+            c.comments = q.value(5).toString();
+            c.severityOverride = static_cast<Severity>(q.value(6).toInt());
+            c.severityJustification = q.value(7).toString();
+            //sorting and severity lookups use the joined rule instead of querying per check
+            if (!q.value(9).isNull())
+                c.SetSTIGCheckKey(static_cast<Severity>(q.value(8).toInt()), q.value(9).toString());
+
+            if (!callback(c))
+                break;
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::GetCKLChecks
  * @param whereClause
@@ -1451,6 +2447,11 @@ QVector<CKLCheck> DbManager::GetCKLChecks(const CCI &cci)
  * @a whereClause. SQL parameters are bound by supplying them in a
  * list of tuples in the @a variables parameter.
  *
+ * The rule and default severity of each check's @a STIGCheck are
+ * joined in (as CKLCheckRule), so sorting the checks does not query
+ * the database. Columns in @a whereClause that STIGCheck also has,
+ * such as id, must be qualified.
+ *
  * @example GetCKLChecks
  * @title default
  *
@@ -1492,37 +2493,92 @@ QVector<CKLCheck> DbManager::GetCKLChecks(const CCI &cci)
  */
 QVector<CKLCheck> DbManager::GetCKLChecks(const QString &whereClause, const QVector<std::tuple<QString, QVariant> > &variables)
 {
-    QSqlDatabase db;
     QVector<CKLCheck> ret;
+    ForEachCKLCheck([&ret](const CKLCheck &check) {
+        ret.append(check);
+        return true;
+    }, whereClause, variables);
+    return ret;
+}
+
+/**
+ * @brief DbManager::GetComplianceCounts
+ * @param asset
+ * @param stig
+ * @return The number of @a CKLChecks of each effective @a Severity
+ * and @a Status, limited to the @a asset and @a stig when provided.
+ *
+ * The counts are read from the ComplianceSummary table, which holds
+ * at most 16 rows per mapped STIG, instead of from the checks
+ * themselves.
+ */
+ComplianceCounts DbManager::GetComplianceCounts(const Asset *asset, const STIG *stig)
+{
+    QSqlDatabase db;
+    ComplianceCounts ret;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
-        QString toPrep = QStringLiteral("SELECT CKLCheck.id, CKLCheck.AssetId, CKLCheck.STIGCheckId, CKLCheck.status, CKLCheck.findingDetails, CKLCheck.comments, CKLCheck.severityOverride, CKLCheck.severityJustification FROM CKLCheck");
-        if (!whereClause.isNull() && !whereClause.isEmpty())
-            toPrep.append(" " + whereClause);
-        q.prepare(toPrep);
-        for (const auto &variable : variables)
+        DbQuery q(db);
+        QStringList where;
+        if (asset)
+            where.append(QStringLiteral("AssetId = :AssetId"));
+        if (stig)
+            where.append(QStringLiteral("STIGId = :STIGId"));
+        q.prepare("SELECT severity, status, SUM(checks) FROM ComplianceSummary" + (where.isEmpty() ? QString() : " WHERE " + where.join(QStringLiteral(" AND "))) + " GROUP BY severity, status");
+        if (asset)
+            q.bindValue(QStringLiteral(":AssetId"), asset->id);
+        if (stig)
+            q.bindValue(QStringLiteral(":STIGId"), stig->id);
+        if (q.exec())
         {
-            QString key;
-            QVariant val;
-            std::tie(key, val) = variable;
-            q.bindValue(key, val);
+            while (q.next())
+            {
+                const int severity = q.value(0).toInt();
+                const int status = q.value(1).toInt();
+                if (severity >= 0 && severity < 4 && status >= 0 && status < 4)
+                    ret.checks[severity][status] += q.value(2).toInt();
+            }
         }
-        q.exec();
-        while (q.next())
-        {
-            CKLCheck c;
-            c.id = q.value(0).toInt();
-            c.assetId = q.value(1).toInt();
-            c.stigCheckId = q.value(2).toInt();
-            c.status = static_cast<Status>(q.value(3).toInt());
-            c.findingDetails = q.value(4).toString();
-            c.comments = q.value(5).toString();
-            c.severityOverride = static_cast<Severity>(q.value(6).toInt());
-            c.severityJustification = q.value(7).toString();
+    }
+    return ret;
+}
 
-            ret.append(c);
-        }
+/**
+ * @brief ComplianceCounts::Count
+ * @param status
+ * @return The number of checks with the @a status.
+ */
+int ComplianceCounts::Count(Status status) const
+{
+    int ret = 0;
+    for (const auto &severity : checks)
+        ret += severity[status];
+    return ret;
+}
+
+/**
+ * @brief ComplianceCounts::Count
+ * @param severity
+ * @param status
+ * @return The number of checks of the @a severity with the
+ * @a status.
+ */
+int ComplianceCounts::Count(Severity severity, Status status) const
+{
+    return checks[severity][status];
+}
+
+/**
+ * @brief ComplianceCounts::Total
+ * @return The number of checks.
+ */
+int ComplianceCounts::Total() const
+{
+    int ret = 0;
+    for (const auto &severity : checks)
+    {
+        for (int count : severity)
+            ret += count;
     }
     return ret;
 }
@@ -1532,13 +2588,21 @@ QVector<CKLCheck> DbManager::GetCKLChecks(const QString &whereClause, const QVec
  * @param id
  * @return The @a STIGCheck associated with the provided database
  * @a id.
+ *
+ * The @a STIGCheck is read through the @a EntityCache.
  */
 STIGCheck DbManager::GetSTIGCheck(int id)
 {
+    STIGCheck ret;
+    if (EntityCache::STIGChecks().Find(id, ret))
+        return ret;
+    const quint64 generation = EntityCache::STIGChecks().Generation();
     QVector<STIGCheck> tmp = GetSTIGChecks(QStringLiteral("WHERE STIGCheck.id = :id"), {std::make_tuple<QString, QVariant>(QStringLiteral(":id"), id)});
     if (!tmp.isEmpty())
+    {
+        EntityCache::STIGChecks().Insert(id, tmp.first(), generation);
         return tmp.first();
-    STIGCheck ret;
+    }
     Warning(QStringLiteral("Unable to Find STIGCheck"), "The STIGCheck of ID " + QString::number(id) + " was not found in the database.");
     return ret;
 }
@@ -1607,6 +2671,23 @@ QVector<STIGCheck> DbManager::GetSTIGChecks(const CCI &cci)
     return GetSTIGChecks(QStringLiteral("WHERE id IN (SELECT STIGCheckId FROM STIGCheckCCI WHERE CCIId = :CCIId)"), {std::make_tuple<QString, QVariant>(QStringLiteral(":CCIId"), cci.id)});
 }
 
+/**
+ * @brief DbManager::GetSTIGChecks
+ * @param ids
+ * @return The @a STIGChecks specified by the provided database ids,
+ * in the order of @a ids. IDs that do not exist in the database are
+ * skipped.
+ *
+ * The @a STIGChecks are loaded in batches rather than one query per
+ * ID.
+ */
+QVector<STIGCheck> DbManager::GetSTIGChecks(const QVector<int> &ids)
+{
+    return GetByIds<STIGCheck>(ids, QStringLiteral("STIGCheck.id"), [this](const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables) {
+        return GetSTIGChecks(whereClause, variables);
+    });
+}
+
 /**
  * @brief DbManager::GetSTIGChecks
  * @param whereClause
@@ -1616,6 +2697,10 @@ QVector<STIGCheck> DbManager::GetSTIGChecks(const CCI &cci)
  * @a whereClause. SQL parameters are bound by supplying them in a
  * list of tuples in the @a variables parameter.
  *
+ * The @a CCI and legacy ID mappings of the returned @a STIGChecks are
+ * loaded with one query each, so the number of queries does not grow
+ * with the number of checks.
+ *
  * @example GetSTIGChecks
  * @title default
  *
@@ -1661,7 +2746,141 @@ QVector<STIGCheck> DbManager::GetSTIGChecks(const QString &whereClause, const QV
     QVector<STIGCheck> ret;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
+        q.setForwardOnly(true);
+        QString toPrep = QStringLiteral("SELECT `id`, `STIGId`, `rule`, `vulnNum`, `groupTitle`, `ruleVersion`, `severity`, `weight`, `title`, `vulnDiscussion`, `falsePositives`, `falseNegatives`, `fix`, `check`, `documentable`, `mitigations`, `severityOverrideGuidance`, `checkContentRef`, `potentialImpact`, `thirdPartyTools`, `mitigationControl`, `responsibility`, `IAControls`, `targetKey`, `isRemap` FROM STIGCheck");
+        if (!whereClause.isNull() && !whereClause.isEmpty())
+            toPrep.append(" " + whereClause);
+        q.prepare(toPrep);
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
+        q.exec();
+        while (q.next())
+            ret.append(ReadSTIGCheck(q));
+
+        if (ret.isEmpty())
+            return ret;
+
+        //load the CCI and legacy ID mappings for every check in one query each instead of per-row
+        QString subQuery = QStringLiteral("SELECT STIGCheck.id FROM STIGCheck");
+        if (!whereClause.isNull() && !whereClause.isEmpty())
+            subQuery.append(" " + whereClause);
+        LoadSTIGCheckMappings(ret, subQuery, variables);
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::GetSTIGCheckHeaders
+ * @param stig
+ * @return The @a STIGCheckHeaders of the @a STIGChecks associated
+ * with the provided @a stig.
+ */
+QVector<STIGCheckHeader> DbManager::GetSTIGCheckHeaders(const STIG &stig)
+{
+    return GetSTIGCheckHeaders(QStringLiteral("WHERE STIGCheck.STIGId = :STIGId"), {std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), stig.id)});
+}
+
+/**
+ * @brief DbManager::GetSTIGCheckHeaders
+ * @param whereClause
+ * @param variables
+ * @return The identifying fields (rule, rule version, vulnerability
+ * number, title, and severity) of the @a STIGChecks selected by the
+ * optional @a whereClause. See GetSTIGChecks() for the parameter
+ * conventions.
+ *
+ * Lists that only show or match checks by these fields use the
+ * headers so that the discussion, fix, and check text (most of a
+ * check's size) and the CCI mappings are not loaded. The full
+ * @a STIGCheck can be read with GetSTIGCheck() when it is needed.
+ */
+QVector<STIGCheckHeader> DbManager::GetSTIGCheckHeaders(const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    QSqlDatabase db;
+    QVector<STIGCheckHeader> ret;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        q.setForwardOnly(true);
+        QString toPrep = QStringLiteral("SELECT `id`, `STIGId`, `rule`, `ruleVersion`, `vulnNum`, `title`, `severity` FROM STIGCheck");
+        if (!whereClause.isNull() && !whereClause.isEmpty())
+            toPrep.append(" " + whereClause);
+        q.prepare(toPrep);
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
+        q.exec();
+        while (q.next())
+            ret.append(ReadSTIGCheckHeader(q));
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::CountSTIGChecks
+ * @param whereClause
+ * @param variables
+ * @return The number of @a STIGChecks selected by the optional
+ * @a whereClause, without loading them.
+ */
+int DbManager::CountSTIGChecks(const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    QSqlDatabase db;
+    int ret = 0;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        QString toPrep = QStringLiteral("SELECT COUNT(*) FROM STIGCheck");
+        if (!whereClause.isNull() && !whereClause.isEmpty())
+            toPrep.append(" " + whereClause);
+        q.prepare(toPrep);
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
+        if (q.exec() && q.next())
+            ret = q.value(0).toInt();
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::ForEachSTIGCheck
+ * @param callback
+ * @param whereClause
+ * @param variables
+ * @return @c True when the query runs. Otherwise, @c false.
+ *
+ * Streams the @a STIGChecks selected by the optional @a whereClause
+ * to @a callback from a forward-only query. The checks are read in
+ * small batches so that their CCI and legacy ID mappings are still
+ * loaded set-based; only one batch is held in memory. Returning
+ * @c false from @a callback stops the iteration. The @a callback
+ * must not modify the STIGCheck table. See GetSTIGChecks() for the
+ * parameter conventions.
+ */
+bool DbManager::ForEachSTIGCheck(const std::function<bool (const STIGCheck &)> &callback, const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    constexpr int batchSize = 256;
+    QSqlDatabase db;
+    bool ret = false;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        q.setForwardOnly(true);
         QString toPrep = QStringLiteral("SELECT `id`, `STIGId`, `rule`, `vulnNum`, `groupTitle`, `ruleVersion`, `severity`, `weight`, `title`, `vulnDiscussion`, `falsePositives`, `falseNegatives`, `fix`, `check`, `documentable`, `mitigations`, `severityOverrideGuidance`, `checkContentRef`, `potentialImpact`, `thirdPartyTools`, `mitigationControl`, `responsibility`, `IAControls`, `targetKey`, `isRemap` FROM STIGCheck");
         if (!whereClause.isNull() && !whereClause.isEmpty())
             toPrep.append(" " + whereClause);
@@ -1673,47 +2892,97 @@ QVector<STIGCheck> DbManager::GetSTIGChecks(const QString &whereClause, const QV
             std::tie(key, val) = variable;
             q.bindValue(key, val);
         }
+        ret = q.exec();
+
+        QVector<STIGCheck> batch;
+        batch.reserve(batchSize);
+        bool more = ret;
+        while (more)
+        {
+            more = q.next();
+            if (more)
+                batch.append(ReadSTIGCheck(q));
+            if (batch.count() == batchSize || (!more && !batch.isEmpty()))
+            {
+                QString idList;
+                QVector<std::tuple<QString, QVariant>> ids;
+                ids.reserve(batch.count());
+                for (int i = 0; i < batch.count(); i++)
+                {
+                    QString key = ":id" + QString::number(i);
+                    if (i > 0)
+                        idList.append(QStringLiteral(", "));
+                    idList.append(key);
+                    ids.append(std::make_tuple<QString, QVariant>(std::move(key), batch.at(i).id));
+                }
+                LoadSTIGCheckMappings(batch, idList, ids);
+                for (const STIGCheck &c : batch)
+                {
+                    if (!callback(c))
+                        return ret;
+                }
+                batch.clear();
+            }
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::LoadSTIGCheckMappings
+ * @param checks
+ * @param idQuery
+ * @param variables
+ *
+ * Fills the CCI and legacy ID mappings of @a checks with one query
+ * each. The @a idQuery is either a sub-query or a list of bound
+ * parameters that selects the IDs of @a checks; @a variables are
+ * bound to it.
+ */
+void DbManager::LoadSTIGCheckMappings(QVector<STIGCheck> &checks, const QString &idQuery, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    QSqlDatabase db;
+    if (CheckDatabase(db))
+    {
+        QHash<int, int> checkIndex; //STIGCheck id → position in checks
+        for (int i = 0; i < checks.count(); i++)
+            checkIndex.insert(checks.at(i).id, i);
+
+        DbQuery q(db);
+        q.setForwardOnly(true);
+        //a mapping to a CCI that no longer exists is reported as the default CCI ID of -1
+        q.prepare("SELECT STIGCheckCCI.STIGCheckId, CCI.id FROM STIGCheckCCI LEFT JOIN CCI ON CCI.id = STIGCheckCCI.CCIId WHERE STIGCheckCCI.STIGCheckId IN (" + idQuery + ") ORDER BY STIGCheckCCI.id");
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
+        q.exec();
+        while (q.next())
+        {
+            auto it = checkIndex.constFind(q.value(0).toInt());
+            if (it != checkIndex.constEnd())
+                checks[it.value()].cciIds.append(q.value(1).isNull() ? -1 : q.value(1).toInt());
+        }
+
+        q.prepare("SELECT STIGCheckLegacyId.STIGCheckId, STIGCheckLegacyId.LegacyId FROM STIGCheckLegacyId WHERE STIGCheckLegacyId.STIGCheckId IN (" + idQuery + ") ORDER BY STIGCheckLegacyId.id");
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
         q.exec();
         while (q.next())
         {
-            STIGCheck c;
-            c.id = q.value(0).toInt();
-            c.stigId = q.value(1).toInt();
-            c.rule = q.value(2).toString();
-            c.vulnNum = q.value(3).toString();
-            c.groupTitle = q.value(4).toString();
-            c.ruleVersion = q.value(5).toString();
-            c.severity = static_cast<Severity>(q.value(6).toInt());
-            c.weight = q.value(7).toDouble();
-            c.title = q.value(8).toString();
-            c.vulnDiscussion = q.value(9).toString();
-            c.falsePositives = q.value(10).toString();
-            c.falseNegatives = q.value(11).toString();
-            c.fix = q.value(12).toString();
-            c.check = q.value(13).toString();
-            c.documentable = q.value(14).toBool();
-            c.mitigations = q.value(15).toString();
-            c.severityOverrideGuidance = q.value(16).toString();
-            c.checkContentRef = q.value(17).toString();
-            c.potentialImpact = q.value(18).toString();
-            c.thirdPartyTools = q.value(19).toString();
-            c.mitigationControl = q.value(20).toString();
-            c.responsibility = q.value(21).toString();
-            c.iaControls = q.value(22).toString();
-            c.targetKey = q.value(23).toString();
-            c.isRemap = q.value(24).toBool();
-            for (CCI cci : GetCCIs(c.id))
-            {
-                c.cciIds.append(cci.id);
-            }
-            for (QString legacyId : GetLegacyIds(c.id))
-            {
-                c.legacyIds.append(legacyId);
-            }
-            ret.append(c);
+            auto it = checkIndex.constFind(q.value(0).toInt());
+            if (it != checkIndex.constEnd())
+                checks[it.value()].legacyIds.append(q.value(1).toString());
         }
     }
-    return ret;
 }
 
 /**
@@ -1727,6 +2996,21 @@ QVector<STIG> DbManager::GetSTIGs(const Asset &asset)
     return GetSTIGs(QStringLiteral("WHERE STIG.id IN (SELECT STIGId FROM AssetSTIG WHERE AssetId = :AssetId)"), {std::make_tuple<QString, QVariant>(QStringLiteral(":AssetId"), asset.id)});
 }
 
+/**
+ * @brief DbManager::GetSTIGs
+ * @param ids
+ * @return The @a STIGs specified by the provided database ids, in the
+ * order of @a ids. IDs that do not exist in the database are skipped.
+ *
+ * The @a STIGs are loaded in batches rather than one query per ID.
+ */
+QVector<STIG> DbManager::GetSTIGs(const QVector<int> &ids)
+{
+    return GetByIds<STIG>(ids, QStringLiteral("STIG.id"), [this](const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables) {
+        return GetSTIGs(whereClause, variables);
+    });
+}
+
 /**
  * @brief DbManager::GetSTIGs
  * @param whereClause
@@ -1774,7 +3058,7 @@ QVector<STIG> DbManager::GetSTIGs(const QString &whereClause, const QVector<std:
     QVector<STIG> ret;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         QString toPrep = QStringLiteral("SELECT id, title, description, release, version, benchmarkId, fileName FROM STIG");
         if (!whereClause.isNull() && !whereClause.isEmpty())
             toPrep.append(" " + whereClause);
@@ -1815,7 +3099,7 @@ QVector<Supplement> DbManager::GetSupplements(const STIG &stig)
     QVector<Supplement> ret;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         QString toPrep = QStringLiteral("SELECT id, path, contents FROM Supplement WHERE STIGId = :STIGId");
         q.prepare(toPrep);
         q.bindValue(QStringLiteral(":STIGId"), stig.id);
@@ -1839,13 +3123,21 @@ QVector<Supplement> DbManager::GetSupplements(const STIG &stig)
  * @return The @a Control in the database associated with the
  * provided ID. If the @a Control does not exist in the database, the
  * default Control with an ID of -1 is returned.
+ *
+ * The @a Control is read through the @a EntityCache.
  */
 Control DbManager::GetControl(int id)
 {
+    Control ret;
+    if (EntityCache::Controls().Find(id, ret))
+        return ret;
+    const quint64 generation = EntityCache::Controls().Generation();
     QVector<Control> tmpControl = GetControls(QStringLiteral("WHERE Control.id = :id"), {std::make_tuple<QString, QVariant>(QStringLiteral(":id"), id)});
     if (!tmpControl.isEmpty())
+    {
+        EntityCache::Controls().Insert(id, tmpControl.first(), generation);
         return tmpControl.first();
-    Control ret;
+    }
     Warning(QStringLiteral("Control Not Found"), "The Control ID " + QString::number(id) + " was not found in the database.");
     return ret;
 }
@@ -1964,7 +3256,7 @@ QVector<Control> DbManager::GetControls(const QString &whereClause, const QVecto
     QVector<Control> ret;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         QString toPrep = QStringLiteral("SELECT Control.id, Control.FamilyId, Control.number, Control.enhancement, Control.title, Control.description, Control.importSeverity, Control.importRelevanceOfThreat, Control.importLikelihood, Control.importImpact, Control.importImpactDescription, Control.importResidualRiskLevel, Control.importRecommendations FROM Control JOIN Family ON Family.id = Control.FamilyId");
         if (!whereClause.isNull() && !whereClause.isEmpty())
             toPrep.append(" " + whereClause);
@@ -2015,13 +3307,21 @@ QString DbManager::GetDBPath()
  * @return The @a Family associated with the provided database @a id.
  * If the @a id is not in the database, the default @a Family with an
  * ID of -1 is returned.
+ *
+ * The @a Family is read through the @a EntityCache.
  */
 Family DbManager::GetFamily(int id)
 {
+    Family ret;
+    if (EntityCache::Families().Find(id, ret))
+        return ret;
+    const quint64 generation = EntityCache::Families().Generation();
     QVector<Family> tmpFamily = GetFamilies(QStringLiteral("WHERE Family.id = :id"), {std::make_tuple<QString, QVariant>(QStringLiteral(":id"), id)});
     if (!tmpFamily.isEmpty())
+    {
+        EntityCache::Families().Insert(id, tmpFamily.first(), generation);
         return tmpFamily.first();
-    Family ret;
+    }
     Warning(QStringLiteral("Family Not Found"), "The Family associated with ID " + QString::number(id) + " could not be found.");
     return ret;
 }
@@ -2037,7 +3337,7 @@ QVector<QString> DbManager::GetLegacyIds(int STIGCheckId)
     QSqlDatabase db;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         q.prepare(QStringLiteral("SELECT LegacyId FROM STIGCheckLegacyId WHERE STIGCheckLegacyId.STIGCheckId = :STIGCheckId"));
         q.bindValue(QStringLiteral(":STIGCheckId"), STIGCheckId);
         q.exec();
@@ -2054,12 +3354,53 @@ QVector<QString> DbManager::GetLegacyIds(int STIGCheckId)
  * @return the log level of the database
  *
  * This function is used for caching and multithreading optimization.
+ * The level is read once for the process and kept current by
+ * UpdateVariable().
  */
 int DbManager::GetLogLevel()
 {
-    if (_logLevel < 0)
-        _logLevel = GetVariable(QStringLiteral("loglevel")).toInt();
-    return _logLevel;
+    int ret = cachedLogLevel;
+    if (ret < 0)
+    {
+        DbManager db;
+        ret = db.GetVariable(QStringLiteral("loglevel")).toInt();
+        cachedLogLevel = ret;
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::GetQueryPlan
+ * @param query
+ * @param variables
+ * @return The rows of SQLite's EXPLAIN QUERY PLAN output for the
+ * supplied @a query, one detail string per row.
+ *
+ * Used to verify that the getters are served by the secondary
+ * indexes rather than full-table scans.
+ */
+QStringList DbManager::GetQueryPlan(const QString &query, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    QSqlDatabase db;
+    QStringList ret;
+    if (CheckDatabase(db))
+    {
+        DbQuery q(db);
+        q.prepare("EXPLAIN QUERY PLAN " + query);
+        for (const auto &variable : variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            q.bindValue(key, val);
+        }
+        q.exec();
+        while (q.next())
+        {
+            ret.append(q.value(3).toString());
+        }
+    }
+    return ret;
 }
 
 QVector<CCI> DbManager::GetRemapCCIs()
@@ -2145,7 +3486,7 @@ QVector<Family> DbManager::GetFamilies(const QString &whereClause, const QVector
     QVector<Family> ret;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         QString toPrep = QStringLiteral("SELECT Family.id, Family.acronym, Family.description FROM Family");
         if (!whereClause.isNull() && !whereClause.isEmpty())
             toPrep.append(" " + whereClause);
@@ -2177,13 +3518,21 @@ QVector<Family> DbManager::GetFamilies(const QString &whereClause, const QVector
  * @return The @a STIG associated with the provided database @a id.
  * If the @a STIG does not exist in the database, the default @a STIG
  * with an id of -1 is returned.
+ *
+ * The @a STIG is read through the @a EntityCache.
  */
 STIG DbManager::GetSTIG(int id)
 {
+    STIG ret;
+    if (EntityCache::STIGs().Find(id, ret))
+        return ret;
+    const quint64 generation = EntityCache::STIGs().Generation();
     QVector<STIG> tmpStigs = GetSTIGs(QStringLiteral("WHERE id = :id"), {std::make_tuple<QString, QVariant>(QStringLiteral(":id"), id)});
     if (!tmpStigs.isEmpty())
+    {
+        EntityCache::STIGs().Insert(id, tmpStigs.first(), generation);
         return tmpStigs.first();
-    STIG ret;
+    }
     Warning(QStringLiteral("Unable to Find STIG"), "The STIG of ID " + QString::number(id) + " was not found in the database.");
     return ret;
 }
@@ -2249,7 +3598,7 @@ QString DbManager::GetVariable(const QString &name)
     QString ret = QString();
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         q.prepare(QStringLiteral("SELECT value FROM variables WHERE name = :name"));
         q.bindValue(QStringLiteral(":name"), name);
         q.exec();
@@ -2271,7 +3620,7 @@ bool DbManager::IsEmassImport()
     QSqlDatabase db;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         q.prepare(QStringLiteral("SELECT COUNT(*) FROM CCI WHERE isImport > 0"));
         q.exec();
         if (q.next() && q.value(0).toInt() > 0)
@@ -2285,24 +3634,39 @@ bool DbManager::IsEmassImport()
 /**
  * @brief DbManager::LoadDB
  * @param path
+ * @param progress
  * @return @c True when the database is restored from @a path,
  * otherwise @c false.
+ *
+ * Both the chunked format written by SaveDB() and the single-block
+ * qCompress() format of earlier versions are read. A chunked file is
+ * decompressed one chunk at a time into a staging file, which only
+ * replaces the database once it is complete. @a progress, when
+ * provided, receives the bytes read so far and the size of @a path.
  */
-bool DbManager::LoadDB(const QString &path)
+bool DbManager::LoadDB(const QString &path, const std::function<void (qint64, qint64)> &progress)
 {
     QFile source(path);
-    QFile dest(_dbPath);
-    if (source.open(QFile::ReadOnly))
+    QTemporaryFile staged(_dbPath + QStringLiteral(".XXXXXX"));
+    if (!source.open(QFile::ReadOnly) || !staged.open())
+    {
+        Warning(QStringLiteral("Unable to Open File"), "The file " + path + " could not be opened for reading.");
+        return false;
+    }
+
+    bool ret = false;
+    if (source.peek(saveFileMagic.size()) == saveFileMagic)
+    {
+        ret = ReadChunkedSave(source, staged, progress);
+    }
+    else
     {
         QByteArray compressedData = source.readAll();
         if (compressedData.size() < 4)
             return false;
 
         //qUncompress expects the first 4 bytes to be the expected uncompressed size in big-endian
-        quint32 expectedSize = (static_cast<quint32>(static_cast<unsigned char>(compressedData[0])) << 24) |
-                               (static_cast<quint32>(static_cast<unsigned char>(compressedData[1])) << 16) |
-                               (static_cast<quint32>(static_cast<unsigned char>(compressedData[2])) << 8) |
-                               (static_cast<quint32>(static_cast<unsigned char>(compressedData[3])));
+        quint32 expectedSize = qFromBigEndian<quint32>(compressedData.constData());
 
         // Limit to 1GB to prevent resource exhaustion
         if (expectedSize > 1073741824)
@@ -2310,18 +3674,73 @@ bool DbManager::LoadDB(const QString &path)
             Warning(QStringLiteral("File Too Large"), "The uncompressed database size (" + QString::number(expectedSize) + " bytes) exceeds the safety limit of 1GB.");
             return false;
         }
+        const QByteArray data = qUncompress(compressedData);
+        ret = !data.isEmpty() && staged.write(data) == data.size();
+        if (progress)
+            progress(source.size(), source.size());
+    }
+    source.close();
+
+    //make sure that the file holds an SQLite database before replacing the current one
+    staged.flush();
+    staged.seek(0);
+    if (!ret || staged.read(16) != QByteArrayLiteral("SQLite format 3\0"))
+    {
+        Warning(QStringLiteral("Unable to Load File"), "The file " + path + " is not a valid STIGQter save file.");
+        return false;
+    }
+    staged.close();
+
+    //the file must not be replaced while a connection still uses it
+    LogWriter::Instance()->Suspend();
+    QSqlDatabase db;
+    if (CheckDatabase(db) && !ReleaseDatabaseFile(db, _dbPath))
+    {
+        LogWriter::Instance()->Resume();
+        Warning(QStringLiteral("Database In Use"), "The database " + _dbPath + " is still in use; wait for running tasks to finish and try again.");
+        return false;
+    }
+    EntityCache::Clear();
+    cachedLogLevel = -1;
+
+    QFile::remove(_dbPath);
+    ret = staged.rename(_dbPath);
+    if (ret)
+        staged.setAutoRemove(false);
+    LogWriter::Instance()->Resume();
+
+    if (!ret)
+        Warning(QStringLiteral("Unable to Open File"), "The database " + _dbPath + " could not be replaced.");
+    return ret;
+}
 
-        if (dest.open(QFile::WriteOnly))
+/**
+ * @brief DbManager::GetSaveHash
+ * @param path
+ * @return The value of HashDB(true) for the database saved at
+ * @a path. For save files from earlier versions, the hash of the
+ * file itself, which never matches an assessment hash.
+ */
+QByteArray DbManager::GetSaveHash(const QString &path)
+{
+    QFile source(path);
+    QByteArray ret;
+    if (source.open(QFile::ReadOnly))
+    {
+        if (source.peek(saveFileMagic.size()) == saveFileMagic && source.size() > saveFileMagic.size() + saveHashSize)
         {
-            dest.write(qUncompress(compressedData));
-            source.close();
-            dest.close();
-            return true;
+            source.seek(source.size() - saveHashSize);
+            ret = source.read(saveHashSize);
+        }
+        else
+        {
+            QCryptographicHash hash(QCryptographicHash::Sha3_256);
+            hash.addData(&source);
+            ret = hash.result();
         }
+        source.close();
     }
-
-    Warning(QStringLiteral("Unable to Open File"), "The file " + path + " could not be opened for writing.");
-    return false;
+    return ret;
 }
 
 /**
@@ -2329,7 +3748,10 @@ bool DbManager::LoadDB(const QString &path)
  * @param severity
  * @param location
  * @param query
- * @return true if the log record is written to the database; otherwise, false.
+ * @return true if the log record is queued for the database; otherwise, false.
+ *
+ * The query text is only formatted when the log level records
+ * queries.
  */
 bool DbManager::Log(int severity, const QString &location, const QSqlQuery &query)
 {
@@ -2346,27 +3768,88 @@ bool DbManager::Log(int severity, const QString &location, const QSqlQuery &quer
  * @param location
  * @param message
  * @param level
- * @return true if the log record is written to the database; otherwise, false.
+ * @return true if the log record is queued for the database;
+ * otherwise, false.
  *
- * Log events to the logging table.
+ * Log events to the logging table. The record is written in a batch
+ * by the @a LogWriter thread. When the queue is full, the record is
+ * written on this thread's connection instead.
  */
 bool DbManager::Log(int severity, const QString &location, const QString &message)
+{
+    //logging of username required by STIG rule SV-84059r1_rule
+    static const QString user = QDir::home().dirName();
+    const QDateTime now = QDateTime::currentDateTime();
+    //get ISO 8601 datestamp with timezone
+    LogRecord record{now.toOffsetFromUtc(now.offsetFromUtc()).toString(Qt::ISODate), severity, location, message, user};
+    if (LogWriter::Instance()->Enqueue(record))
+        return true;
+    return WriteLog({record});
+}
+
+/**
+ * @brief DbManager::WriteLog
+ * @param records
+ * @return @c True when the @a records are inserted in the Log table.
+ * Otherwise, @c false.
+ *
+ * Used by the @a LogWriter to write a batch in one transaction. When
+ * a @a DbTransaction is open on this thread, the records become part
+ * of it.
+ */
+bool DbManager::WriteLog(const QVector<LogRecord> &records)
 {
     bool ret = false;
     QSqlDatabase db;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
-        q.prepare(QStringLiteral("INSERT INTO Log (`when`, `severity`, `location`, `message`, `user`) VALUES(:datetime, :severity, :location, :message, :user)"));
-        //get ISO 8601 datestamp with timezone
-        q.bindValue(QStringLiteral(":datetime"), QDateTime::currentDateTime().toOffsetFromUtc(QDateTime::currentDateTime().offsetFromUtc()).toString(Qt::ISODate));
-        q.bindValue(QStringLiteral(":severity"), severity);
-        q.bindValue(QStringLiteral(":location"), location);
-        q.bindValue(QStringLiteral(":message"), message);
-        //logging of username required by STIG rule SV-84059r1_rule
-        q.bindValue(QStringLiteral(":user"), QDir::home().dirName());
-        ret = q.exec();
+        const bool ownTransaction = !DbTransaction::Active() && db.transaction();
+        DbQuery q(db);
+        ret = q.prepare(QStringLiteral("INSERT INTO Log (`when`, `severity`, `location`, `message`, `user`) VALUES(:datetime, :severity, :location, :message, :user)"));
+        for (const LogRecord &record : records)
+        {
+            q.bindValue(QStringLiteral(":datetime"), record.when);
+            q.bindValue(QStringLiteral(":severity"), record.severity);
+            q.bindValue(QStringLiteral(":location"), record.location);
+            q.bindValue(QStringLiteral(":message"), record.message);
+            q.bindValue(QStringLiteral(":user"), record.user);
+            ret = q.exec() && ret;
+        }
         //logging is not logged
+        if (ownTransaction)
+        {
+            if (ret)
+                ret = db.commit();
+            else
+                db.rollback();
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::RebuildComplianceSummary
+ * @return @c True when the ComplianceSummary table is recomputed
+ * from the checklists. Otherwise, @c false.
+ */
+bool DbManager::RebuildComplianceSummary()
+{
+    QSqlDatabase db;
+    bool ret = false;
+    if (CheckDatabase(db))
+    {
+        DbTransaction transaction;
+        DbQuery q(db);
+        ret = true; //assume success from here
+        q.prepare(QStringLiteral("DELETE FROM ComplianceSummary"));
+        ret = q.exec() && ret;
+        q.prepare("INSERT INTO ComplianceSummary (AssetId, STIGId, severity, status, checks) " + ComplianceSummaryQuery(QStringLiteral("COUNT(*)")));
+        ret = q.exec() && ret;
+        Log(6, QStringLiteral("RebuildComplianceSummary"), q);
+        if (ret)
+            transaction.Commit();
+        else
+            transaction.Rollback();
     }
     return ret;
 }
@@ -2374,20 +3857,61 @@ bool DbManager::Log(int severity, const QString &location, const QString &messag
 /**
  * @brief DbManager::SaveDB
  * @param path
+ * @param progress
  * @return @c True when the database is saved to @a path. Otherwise,
  * @c false.
+ *
+ * The database is first copied with VACUUM INTO, which reads it in a
+ * single transaction, so the saved file is a consistent snapshot
+ * even while workers are writing. The copy is then compressed in
+ * chunks, keeping memory use constant. @a progress, when provided,
+ * receives the bytes compressed so far and the size of the copy.
+ *
+ * The save file carries the assessment hash (HashDB(true)) of the
+ * copy. It does not depend on page layout, so it still matches the
+ * database after the file is loaded again. The save is abandoned if
+ * the copy cannot be made or hashed, so the hash never describes a
+ * different file than the one saved.
  */
-bool DbManager::SaveDB(const QString &path)
+bool DbManager::SaveDB(const QString &path, const std::function<void (qint64, qint64)> &progress)
 {
-    QFile source(_dbPath);
-    QFile dest(path);
+    //VACUUM INTO requires a new or empty file
+    QTemporaryFile snapshot(QFileInfo(path).absolutePath() + QStringLiteral("/XXXXXX.snapshot"));
+    QSqlDatabase db;
+    bool copied = false;
+    QString error;
+    if (snapshot.open() && CheckDatabase(db))
+    {
+        snapshot.close();
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("VACUUM INTO :path"));
+        q.bindValue(QStringLiteral(":path"), snapshot.fileName());
+        copied = q.exec();
+        error = q.lastError().text();
+    }
+    if (!copied)
+    {
+        Warning(QStringLiteral("Unable to Copy Database"), "A snapshot of the database could not be taken, so it was not saved to " + path + ". " + error);
+        return false;
+    }
+
+    //hash the copy itself so that the hash describes exactly what is saved
+    const QByteArray hash = HashAssessmentFile(snapshot.fileName());
+    if (hash.isEmpty())
+    {
+        Warning(QStringLiteral("Unable to Hash Database"), "The snapshot of the database could not be read, so it was not saved to " + path + ".");
+        return false;
+    }
+
+    QFile source(snapshot.fileName());
+    QSaveFile dest(path);
 
     if (source.open(QFile::ReadOnly) && dest.open(QFile::WriteOnly))
     {
-        dest.write(qCompress(source.readAll(), 9));
-        source.close();
-        dest.close();
-        return true;
+        //the previous save is only replaced once the new one is complete
+        if (WriteChunkedSave(source, dest, hash, progress) && dest.commit())
+            return true;
+        dest.cancelWriting();
     }
 
     Warning(QStringLiteral("Unable to Open File"), "The file " + path + " could not be opened for writing.");
@@ -2396,20 +3920,213 @@ bool DbManager::SaveDB(const QString &path)
 
 /**
  * @brief DbManager::HashDB
- * @return The SHA3_256 hash of the database file
+ * @param assessmentOnly
+ * @return The SHA3_256 hash of the database file, or of the
+ * assessment when @a assessmentOnly is @c true.
+ *
+ * The database file is hashed in fixed-size blocks, so memory use
+ * does not grow with the database.
+ *
+ * The assessment hash covers the @a Assets, the @a STIGs mapped to
+ * them, and their @a CKLCheck results. Rows are identified by host
+ * name, STIG title/version/release, and rule rather than by database
+ * id, so two analysts' databases that hold the same assessment hash
+ * the same regardless of import order or page layout.
  */
-QByteArray DbManager::HashDB()
+QByteArray DbManager::HashDB(bool assessmentOnly)
 {
+    LogWriter::Instance()->Flush();
+    QCryptographicHash hash(QCryptographicHash::Sha3_256);
+    QSqlDatabase db;
+
+    if (assessmentOnly)
+    {
+        if (!CheckDatabase(db))
+            return QByteArray();
+
+        //one read transaction so that the three queries agree
+        const bool readTransaction = !DbTransaction::Active() && db.transaction();
+        const bool ret = HashAssessment(hash, db);
+        if (readTransaction)
+            db.commit();
+        return ret ? hash.result() : QByteArray();
+    }
+
+    if (CheckDatabase(db))
+        CheckpointDatabase(db);
+
     QFile source(_dbPath);
     QByteArray ret;
     if (source.open(QFile::ReadOnly))
     {
-        ret = QCryptographicHash::hash(qCompress(source.readAll(), 9), QCryptographicHash::Sha3_256);
+        QByteArray block;
+        while (!source.atEnd())
+        {
+            block = source.read(1024 * 1024);
+            if (block.isEmpty())
+                return ret;
+            hash.addData(block);
+        }
+        ret = hash.result();
         source.close();
     }
     return ret;
 }
 
+/**
+ * @brief DbManager::Search
+ * @param text
+ * @param limit
+ * @param asset
+ * @return The STIG rules and checklist answers containing every word
+ * of @a text (as a prefix), best match first, at most @a limit hits.
+ * A negative @a limit returns every hit.
+ *
+ * Rule hits cover the rule and vulnerability numbers, title,
+ * discussion, check, and fix text; finding hits cover the finding
+ * details and comments. The snippet brackets the matched words.
+ *
+ * Without an @a asset, the whole STIG library is searched; rule hits
+ * have a @a cklCheckId and @a assetId of -1. With an @a asset, only
+ * its checks are searched, and a check whose rule and answers both
+ * match is returned once.
+ *
+ * The search is served by the STIGCheckSearch and CKLCheckSearch
+ * full-text indexes. When SQLite was built without FTS5, the tables
+ * are scanned instead and the hits are not ranked.
+ */
+QVector<SearchHit> DbManager::Search(const QString &text, int limit, const Asset *asset)
+{
+    QVector<SearchHit> ret;
+    const QStringList terms = SearchTerms(text);
+    QSqlDatabase db;
+    if (terms.isEmpty() || limit == 0 || !CheckDatabase(db))
+        return ret;
+
+    DbQuery q(db);
+    q.setForwardOnly(true);
+    const bool indexed = IsSearchIndexed(q);
+    SearchClauses clauses = BuildSearchClauses(terms, indexed);
+    clauses.variables.append(std::make_tuple<QString, QVariant>(QStringLiteral(":limit"), limit));
+    if (asset)
+        clauses.variables.append(std::make_tuple<QString, QVariant>(QStringLiteral(":AssetId"), asset->id));
+
+    const QString ruleColumns = indexed ? QStringLiteral("snippet(STIGCheckSearch, -1, '[', ']', '…', 16), STIGCheckSearch.rank") : QStringLiteral("STIGCheck.title, 0");
+    const QString findingColumns = indexed ? QStringLiteral("snippet(CKLCheckSearch, -1, '[', ']', '…', 16), CKLCheckSearch.rank") : QStringLiteral("substr(CKLCheck.findingDetails, 1, 120), 0");
+
+    QStringList queries;
+    if (asset)
+        queries.append("SELECT CKLCheck.id, STIGCheck.id, STIGCheck.STIGId, CKLCheck.AssetId, " + ruleColumns + " FROM " + clauses.ruleSource + " JOIN CKLCheck ON CKLCheck.STIGCheckId = STIGCheck.id WHERE " + clauses.ruleMatch + " AND CKLCheck.AssetId = :AssetId" + (indexed ? QStringLiteral(" ORDER BY STIGCheckSearch.rank") : QString()) + " LIMIT :limit");
+    else
+        queries.append("SELECT -1, STIGCheck.id, STIGCheck.STIGId, -1, " + ruleColumns + " FROM " + clauses.ruleSource + " WHERE " + clauses.ruleMatch + (indexed ? QStringLiteral(" ORDER BY STIGCheckSearch.rank") : QString()) + " LIMIT :limit");
+    queries.append("SELECT CKLCheck.id, CKLCheck.STIGCheckId, STIGCheck.STIGId, CKLCheck.AssetId, " + findingColumns + " FROM " + clauses.findingSource + " JOIN STIGCheck ON STIGCheck.id = CKLCheck.STIGCheckId WHERE " + clauses.findingMatch + (asset ? QStringLiteral(" AND CKLCheck.AssetId = :AssetId") : QString()) + (indexed ? QStringLiteral(" ORDER BY CKLCheckSearch.rank") : QString()) + " LIMIT :limit");
+
+    for (const QString &query : queries)
+    {
+        q.prepare(query);
+        for (const auto &variable : clauses.variables)
+        {
+            QString key;
+            QVariant val;
+            std::tie(key, val) = variable;
+            if (query.contains(key))
+                q.bindValue(key, val);
+        }
+        if (q.exec())
+            ReadSearchHits(q, ret);
+        Log(6, QStringLiteral("Search"), q);
+    }
+
+    //bm25 scores are negative; lower is better
+    std::stable_sort(ret.begin(), ret.end(), [](const SearchHit &a, const SearchHit &b) {
+        return a.rank < b.rank;
+    });
+    if (asset)
+    {
+        QSet<int> seen;
+        QVector<SearchHit> unique;
+        unique.reserve(ret.count());
+        for (const SearchHit &hit : std::as_const(ret))
+        {
+            if (!seen.contains(hit.cklCheckId))
+            {
+                seen.insert(hit.cklCheckId);
+                unique.append(hit);
+            }
+        }
+        ret = std::move(unique);
+    }
+    if (limit > 0 && ret.count() > limit)
+        ret.resize(limit);
+    return ret;
+}
+
+/**
+ * @brief DbManager::SearchAssets
+ * @param text
+ * @return The ids of every @a Asset with a checklist answer that
+ * matches @a text, ordered by its best match.
+ */
+QVector<int> DbManager::SearchAssets(const QString &text)
+{
+    return SearchOwners(text, true);
+}
+
+/**
+ * @brief DbManager::SearchSTIGs
+ * @param text
+ * @return The ids of every @a STIG with a rule or checklist answer
+ * that matches @a text, ordered by its best match.
+ */
+QVector<int> DbManager::SearchSTIGs(const QString &text)
+{
+    return SearchOwners(text, false);
+}
+
+/**
+ * @brief DbManager::SearchOwners
+ * @param text
+ * @param assets
+ * @return The ids of the @a Assets (when @a assets is @c true) or
+ * @a STIGs owning the hits of Search(), each once, ordered by its
+ * best hit.
+ *
+ * The owners are grouped in SQL, so every hit counts without loading
+ * the hits or their snippets.
+ */
+QVector<int> DbManager::SearchOwners(const QString &text, bool assets)
+{
+    QVector<int> ret;
+    const QStringList terms = SearchTerms(text);
+    QSqlDatabase db;
+    if (terms.isEmpty() || !CheckDatabase(db))
+        return ret;
+
+    DbQuery q(db);
+    q.setForwardOnly(true);
+    const SearchClauses clauses = BuildSearchClauses(terms, IsSearchIndexed(q));
+    if (assets)
+        q.prepare("SELECT CKLCheck.AssetId FROM " + clauses.findingSource + " WHERE " + clauses.findingMatch + " GROUP BY CKLCheck.AssetId ORDER BY MIN(" + clauses.findingRank + "), 1");
+    else
+        q.prepare("SELECT STIGId FROM (SELECT STIGCheck.STIGId AS STIGId, " + clauses.ruleRank + " AS score FROM " + clauses.ruleSource + " WHERE " + clauses.ruleMatch +
+                  " UNION ALL SELECT STIGCheck.STIGId, " + clauses.findingRank + " FROM " + clauses.findingSource + " JOIN STIGCheck ON STIGCheck.id = CKLCheck.STIGCheckId WHERE " + clauses.findingMatch +
+                  ") GROUP BY STIGId ORDER BY MIN(score), 1");
+    for (const auto &variable : clauses.variables)
+    {
+        QString key;
+        QVariant val;
+        std::tie(key, val) = variable;
+        q.bindValue(key, val);
+    }
+    if (q.exec())
+    {
+        while (q.next())
+            ret.append(q.value(0).toInt());
+    }
+    Log(6, QStringLiteral("SearchOwners"), q);
+    return ret;
+}
+
 /**
  * @brief DbManager::UpdateAsset
  * @param asset
@@ -2426,7 +4143,7 @@ bool DbManager::UpdateAsset(const Asset &asset)
         ret = true;
         if (CheckDatabase(db))
         {
-            QSqlQuery q(db);
+            DbQuery q(db);
             //NOTE: The new values use the provided "cci" while the WHERE clause uses the Database-identified "tmpCCI".
             q.prepare(QStringLiteral("UPDATE Asset SET assetType = :assetType, hostName = :hostName, hostIP = :hostIP, hostMAC = :hostMAC, hostFQDN = :hostFQDN, techArea = :techArea, targetKey = :targetKey, marking = :marking, targetComment = :targetComment, webOrDatabase = :webOrDatabase, webDBSite = :webDBSite, webDBInstance = :webDBInstance WHERE id = :id"));
             q.bindValue(QStringLiteral(":assetType"), asset.assetType.isEmpty() ? nullptr : asset.assetType);
@@ -2465,7 +4182,7 @@ bool DbManager::UpdateCCI(const CCI &cci)
         ret = true;
         if (CheckDatabase(db))
         {
-            QSqlQuery q(db);
+            DbQuery q(db);
             //NOTE: The new values use the provided "cci" while the WHERE clause uses the Database-identified "tmpCCI".
             q.prepare(QStringLiteral("UPDATE CCI SET ControlId = :ControlId, cci = :cci, definition = :definition, isImport = :isImport, importCompliance = :importCompliance, importDateTested = :importDateTested, importTestedBy = :importTestedBy, importTestResults = :importTestResults, importCompliance2 = :importCompliance2, importDateTested2 = :importDateTested2, importTestedBy2 = :importTestedBy2, importTestResults2 = :importTestResults2, importControlImplementationStatus = :importControlImplementationStatus, importSecurityControlDesignation = :importSecurityControlDesignation, importInherited = :importInherited, importRemoteInheritanceInstance = :importRemoteInheritanceInstance, importApNum = :importApNum, importImplementationGuidance = :importImplementationGuidance, importAssessmentProcedures = :importAssessmentProcedures, importNarrative = :importNarrative WHERE id = :id"));
             q.bindValue(QStringLiteral(":ControlId"), cci.controlId);
@@ -2491,6 +4208,9 @@ bool DbManager::UpdateCCI(const CCI &cci)
             q.bindValue(QStringLiteral(":id"), tmpCCI.id);
             ret = q.exec();
             Log(6, QStringLiteral("UpdateCCI"), q);
+            EntityCache::CCIs().Remove(tmpCCI.id);
+            if (tmpCCI.cci != cci.cci)
+                EntityCache::InvalidateCCILookupTable();
         }
     }
     return ret;
@@ -2512,7 +4232,7 @@ bool DbManager::UpdateCKLCheck(const CKLCheck &check)
         ret = true;
         if (CheckDatabase(db))
         {
-            QSqlQuery q(db);
+            DbQuery q(db);
             //NOTE: The new values use the provided "check" while the WHERE clause uses the Database-identified "tmpCheck".
             q.prepare(QStringLiteral("UPDATE CKLCheck SET status = :status, findingDetails = :findingDetails, comments = :comments, severityOverride = :severityOverride, severityJustification = :severityJustification WHERE id = :id"));
             q.bindValue(QStringLiteral(":status"), check.status);
@@ -2544,7 +4264,7 @@ bool DbManager::UpdateControl(const Control &control)
         ret = true;
         if (CheckDatabase(db))
         {
-            QSqlQuery q(db);
+            DbQuery q(db);
             q.prepare(QStringLiteral("UPDATE Control SET FamilyId = :FamilyId, number = :number, enhancement = :enhancement, title = :title, description = :description, importSeverity = :importSeverity, importRelevanceOfThreat = :importRelevanceOfThreat, importLikelihood = :importLikelihood, importImpact = :importImpact, importImpactDescription = :importImpactDescription, importResidualRiskLevel = :importResidualRiskLevel, importRecommendations = :importRecommendations WHERE id = :id"));
             q.bindValue(QStringLiteral(":FamilyId"), control.familyId);
             q.bindValue(QStringLiteral(":number"), control.number);
@@ -2561,6 +4281,7 @@ bool DbManager::UpdateControl(const Control &control)
             q.bindValue(QStringLiteral(":id"), tmpControl.id);
             ret = q.exec();
             Log(6, QStringLiteral("UpdateCKLCheck"), q);
+            EntityCache::Controls().Remove(tmpControl.id);
         }
     }
     return ret;
@@ -2583,7 +4304,7 @@ bool DbManager::UpdateSTIG(const STIG &stig)
         ret = true;
         if (CheckDatabase(db))
         {
-            QSqlQuery q(db);
+            DbQuery q(db);
             q.prepare(QStringLiteral("UPDATE STIG SET title = :title, description = :description, release = :release, version = :version, benchmarkId = :benchmarkId, fileName = :fileName WHERE id = :id"));
             q.bindValue(QStringLiteral(":title"), stig.title);
             q.bindValue(QStringLiteral(":description"), stig.description);
@@ -2594,6 +4315,7 @@ bool DbManager::UpdateSTIG(const STIG &stig)
             q.bindValue(QStringLiteral(":id"), stig.id);
             ret = q.exec();
             Log(6, QStringLiteral("UpdateSTIG"), q);
+            EntityCache::STIGs().Remove(stig.id);
         }
     }
 
@@ -2616,7 +4338,8 @@ bool DbManager::UpdateSTIGCheck(const STIGCheck &check)
         ret = true;
         if (CheckDatabase(db))
         {
-            QSqlQuery q(db);
+            DbTransaction transaction;
+            DbQuery q(db);
             //NOTE: The new values use the provided "check" while the WHERE clause uses the Database-identified "tmpCheck".
             q.prepare(QStringLiteral("UPDATE STIGCheck SET `STIGId` = :STIGId, `rule` = :rule, `vulnNum` = :vulnNum, `groupTitle` = :groupTitle, `ruleVersion` = :ruleVersion, `severity` = :severity, `weight` = :weight, `title` = :title, `vulnDiscussion` = :vulnDiscussion, `falsePositives` = :falsePositives, `falseNegatives` = :falseNegatives, `fix` = :fix, `check` = :check, `documentable` = :documentable, `mitigations` = :mitigations, `severityOverrideGuidance` = :severityOverrideGuidance, `checkContentRef` = :checkContentRef, `potentialImpact` = :potentialImpact, `thirdPartyTools` = :thirdPartyTools, `mitigationControl` = :mitigationControl, `responsibility` = :responsibility, `IAControls` = :IAControls, `targetKey` = :targetKey, `isRemap` = :isRemap WHERE `id` = :id"));
             q.bindValue(QStringLiteral(":STIGId"), check.stigId);
@@ -2670,6 +4393,10 @@ bool DbManager::UpdateSTIGCheck(const STIGCheck &check)
                 ret = q.exec() && ret;
                 Log(6, QStringLiteral("UpdateSTIGCheck-STIGCheckLegacyId2"), q);
             }
+            if (!ret)
+                transaction.Rollback();
+            EntityCache::STIGChecks().Remove(check.id);
+            EntityCache::STIGChecks().Remove(tmpCheck.id);
         }
     }
     return ret;
@@ -2688,11 +4415,13 @@ bool DbManager::UpdateVariable(const QString &name, const QString &value)
     bool ret = false;
     if (CheckDatabase(db))
     {
-        QSqlQuery q(db);
+        DbQuery q(db);
         q.prepare(QStringLiteral("UPDATE variables SET value = :value WHERE name = :name"));
         q.bindValue(QStringLiteral(":value"), value);
         q.bindValue(QStringLiteral(":name"), name);
         ret = q.exec();
+        if (ret && name == QStringLiteral("loglevel"))
+            cachedLogLevel = value.toInt();
         Log(6, QStringLiteral("UpdateVariable"), q);
     }
     return ret;
@@ -2711,9 +4440,16 @@ bool DbManager::UpdateVariable(const QString &name, const QString &value)
  */
 bool DbManager::CheckDatabase(QSqlDatabase &db)
 {
-    db = QSqlDatabase::database(QString::number(reinterpret_cast<quint64>(QThread::currentThreadId())));
-    if (!db.isOpen())
-        db.open();
+    const QString connectionName = QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()));
+    if (!DbConnections::Owns(connectionName))
+    {
+        //creates this thread's connection, or replaces a stale one
+        DbManager manager;
+        Q_UNUSED(manager)
+    }
+    db = QSqlDatabase::database(connectionName, false);
+    if (!db.isOpen() && DbConnections::Open(db))
+        ConfigureConnection(db);
     if (!db.isOpen())
         return false;
     return db.isValid();
@@ -2991,6 +4727,150 @@ bool DbManager::UpdateDatabaseFromVersion(int version)
             ret = q.exec() && ret;
             ret = UpdateVariable(QStringLiteral("version"), QStringLiteral("9")) && ret;
         }
+        if (version < 10)
+        {
+            //secondary indexes for the foreign keys and lookup columns used by the getters
+            //build them atomically so that an interrupted upgrade is retried from scratch
+            db.transaction();
+            QSqlQuery q(db);
+            const QStringList indexes = {
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_CKLCheck_AssetId_STIGCheckId` ON `CKLCheck` (`AssetId`, `STIGCheckId`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_CKLCheck_STIGCheckId` ON `CKLCheck` (`STIGCheckId`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_STIGCheck_STIGId_rule` ON `STIGCheck` (`STIGId`, `rule`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_STIGCheckCCI_STIGCheckId` ON `STIGCheckCCI` (`STIGCheckId`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_STIGCheckCCI_CCIId` ON `STIGCheckCCI` (`CCIId`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_STIGCheckLegacyId_STIGCheckId` ON `STIGCheckLegacyId` (`STIGCheckId`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_CCI_cci` ON `CCI` (`cci`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_CCI_ControlId` ON `CCI` (`ControlId`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_Control_FamilyId_number` ON `Control` (`FamilyId`, `number`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_AssetSTIG_AssetId_STIGId` ON `AssetSTIG` (`AssetId`, `STIGId`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_AssetSTIG_STIGId` ON `AssetSTIG` (`STIGId`)"),
+                QStringLiteral("CREATE INDEX IF NOT EXISTS `idx_Supplement_STIGId` ON `Supplement` (`STIGId`)")
+            };
+            bool indexRet = true;
+            for (const QString &index : indexes)
+            {
+                q.prepare(index);
+                indexRet = q.exec() && indexRet;
+            }
+            indexRet = UpdateVariable(QStringLiteral("version"), QStringLiteral("10")) && indexRet;
+            if (indexRet)
+                db.commit();
+            else
+                db.rollback();
+            ret = indexRet && ret;
+        }
+        if (version < 11)
+        {
+            //full-text index over the rule text and the checklist answers (see Search())
+            //external-content tables store only the index; the triggers keep it in step with the rows
+            db.transaction();
+            QSqlQuery q(db);
+            const QStringList statements = {
+                QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS `STIGCheckSearch` USING fts5(`rule`, `vulnNum`, `title`, `vulnDiscussion`, `check`, `fix`, content='STIGCheck', content_rowid='id', tokenize='porter unicode61')"),
+                QStringLiteral("CREATE TRIGGER IF NOT EXISTS `STIGCheckSearch_ai` AFTER INSERT ON `STIGCheck` BEGIN "
+                               "INSERT INTO `STIGCheckSearch` (rowid, `rule`, `vulnNum`, `title`, `vulnDiscussion`, `check`, `fix`) VALUES (new.`id`, new.`rule`, new.`vulnNum`, new.`title`, new.`vulnDiscussion`, new.`check`, new.`fix`); "
+                               "END"),
+                QStringLiteral("CREATE TRIGGER IF NOT EXISTS `STIGCheckSearch_ad` AFTER DELETE ON `STIGCheck` BEGIN "
+                               "INSERT INTO `STIGCheckSearch` (`STIGCheckSearch`, rowid, `rule`, `vulnNum`, `title`, `vulnDiscussion`, `check`, `fix`) VALUES ('delete', old.`id`, old.`rule`, old.`vulnNum`, old.`title`, old.`vulnDiscussion`, old.`check`, old.`fix`); "
+                               "END"),
+                QStringLiteral("CREATE TRIGGER IF NOT EXISTS `STIGCheckSearch_au` AFTER UPDATE OF `rule`, `vulnNum`, `title`, `vulnDiscussion`, `check`, `fix` ON `STIGCheck` BEGIN "
+                               "INSERT INTO `STIGCheckSearch` (`STIGCheckSearch`, rowid, `rule`, `vulnNum`, `title`, `vulnDiscussion`, `check`, `fix`) VALUES ('delete', old.`id`, old.`rule`, old.`vulnNum`, old.`title`, old.`vulnDiscussion`, old.`check`, old.`fix`); "
+                               "INSERT INTO `STIGCheckSearch` (rowid, `rule`, `vulnNum`, `title`, `vulnDiscussion`, `check`, `fix`) VALUES (new.`id`, new.`rule`, new.`vulnNum`, new.`title`, new.`vulnDiscussion`, new.`check`, new.`fix`); "
+                               "END"),
+                QStringLiteral("CREATE VIRTUAL TABLE IF NOT EXISTS `CKLCheckSearch` USING fts5(`findingDetails`, `comments`, content='CKLCheck', content_rowid='id', tokenize='porter unicode61')"),
+                QStringLiteral("CREATE TRIGGER IF NOT EXISTS `CKLCheckSearch_ai` AFTER INSERT ON `CKLCheck` BEGIN "
+                               "INSERT INTO `CKLCheckSearch` (rowid, `findingDetails`, `comments`) VALUES (new.`id`, new.`findingDetails`, new.`comments`); "
+                               "END"),
+                QStringLiteral("CREATE TRIGGER IF NOT EXISTS `CKLCheckSearch_ad` AFTER DELETE ON `CKLCheck` BEGIN "
+                               "INSERT INTO `CKLCheckSearch` (`CKLCheckSearch`, rowid, `findingDetails`, `comments`) VALUES ('delete', old.`id`, old.`findingDetails`, old.`comments`); "
+                               "END"),
+                //status changes are the common update and do not touch the index
+                QStringLiteral("CREATE TRIGGER IF NOT EXISTS `CKLCheckSearch_au` AFTER UPDATE OF `findingDetails`, `comments` ON `CKLCheck` "
+                               "WHEN old.`findingDetails` IS NOT new.`findingDetails` OR old.`comments` IS NOT new.`comments` BEGIN "
+                               "INSERT INTO `CKLCheckSearch` (`CKLCheckSearch`, rowid, `findingDetails`, `comments`) VALUES ('delete', old.`id`, old.`findingDetails`, old.`comments`); "
+                               "INSERT INTO `CKLCheckSearch` (rowid, `findingDetails`, `comments`) VALUES (new.`id`, new.`findingDetails`, new.`comments`); "
+                               "END"),
+                QStringLiteral("INSERT INTO `STIGCheckSearch` (`STIGCheckSearch`) VALUES ('rebuild')"),
+                QStringLiteral("INSERT INTO `CKLCheckSearch` (`CKLCheckSearch`) VALUES ('rebuild')")
+            };
+            bool searchRet = true;
+            bool noFts5 = false;
+            for (const QString &statement : statements)
+            {
+                q.prepare(statement);
+                if (!q.exec())
+                {
+                    searchRet = false;
+                    noFts5 = q.lastError().text().contains(QStringLiteral("no such module: fts5"), Qt::CaseInsensitive);
+                    break;
+                }
+            }
+            searchRet = searchRet && UpdateVariable(QStringLiteral("version"), QStringLiteral("11"));
+            if (searchRet)
+                db.commit();
+            else
+                db.rollback();
+            //SQLite was built without FTS5; Search() falls back to scanning the tables
+            if (!searchRet && noFts5)
+                searchRet = UpdateVariable(QStringLiteral("version"), QStringLiteral("11"));
+            //any other failure leaves the version alone so that the upgrade is retried
+            if (!searchRet)
+                return false;
+        }
+        if (version < 12)
+        {
+            //checks per Asset, STIG, severity, and status (see GetComplianceCounts()), kept current by triggers
+            db.transaction();
+            QSqlQuery q(db);
+            const QString summaryKey = QStringLiteral("(`AssetId`, `STIGId`, `severity`, `status`)");
+            const QString summaryInsert = QStringLiteral("INSERT INTO `ComplianceSummary` (`AssetId`, `STIGId`, `severity`, `status`, `checks`) ");
+            const QString addNew = summaryInsert +
+                                   "SELECT new.`AssetId`, `STIGCheck`.`STIGId`, " + EffectiveSeverity(QStringLiteral("new"), QStringLiteral("`STIGCheck`.`severity`")) + ", IFNULL(new.`status`, 0), 1 FROM `STIGCheck` WHERE `STIGCheck`.`id` = new.`STIGCheckId` "
+                                   "ON CONFLICT " + summaryKey + " DO UPDATE SET `checks` = `checks` + 1; ";
+            const QString removeOld = "UPDATE `ComplianceSummary` SET `checks` = `checks` - 1 WHERE " + summaryKey + " = "
+                                      "(SELECT old.`AssetId`, `STIGCheck`.`STIGId`, " + EffectiveSeverity(QStringLiteral("old"), QStringLiteral("`STIGCheck`.`severity`")) + ", IFNULL(old.`status`, 0) FROM `STIGCheck` WHERE `STIGCheck`.`id` = old.`STIGCheckId`); "
+                                      "DELETE FROM `ComplianceSummary` WHERE `AssetId` = old.`AssetId` AND `checks` <= 0; ";
+            const QStringList statements = {
+                QStringLiteral("CREATE TABLE IF NOT EXISTS `ComplianceSummary` ( "
+                               "`AssetId`	INTEGER NOT NULL, "
+                               "`STIGId`	INTEGER NOT NULL, "
+                               "`severity`	INTEGER NOT NULL, "
+                               "`status`	INTEGER NOT NULL, "
+                               "`checks`	INTEGER NOT NULL DEFAULT 0, "
+                               "PRIMARY KEY(`AssetId`, `STIGId`, `severity`, `status`) "
+                               ") WITHOUT ROWID"),
+                "CREATE TRIGGER IF NOT EXISTS `ComplianceSummary_ai` AFTER INSERT ON `CKLCheck` BEGIN " + addNew + "END",
+                "CREATE TRIGGER IF NOT EXISTS `ComplianceSummary_ad` AFTER DELETE ON `CKLCheck` BEGIN " + removeOld + "END",
+                //answering a check without changing its status leaves the counts alone
+                "CREATE TRIGGER IF NOT EXISTS `ComplianceSummary_au` AFTER UPDATE OF `AssetId`, `STIGCheckId`, `status`, `severityOverride` ON `CKLCheck` "
+                "WHEN old.`AssetId` IS NOT new.`AssetId` OR old.`STIGCheckId` IS NOT new.`STIGCheckId` OR old.`status` IS NOT new.`status` OR old.`severityOverride` IS NOT new.`severityOverride` BEGIN " + removeOld + addNew + "END",
+                //a STIG update can change the default severity of checks already on a checklist
+                "CREATE TRIGGER IF NOT EXISTS `ComplianceSummary_STIGCheck_au` AFTER UPDATE OF `STIGId`, `severity` ON `STIGCheck` "
+                "WHEN old.`STIGId` IS NOT new.`STIGId` OR old.`severity` IS NOT new.`severity` BEGIN "
+                "UPDATE `ComplianceSummary` SET `checks` = `checks` - (SELECT COUNT(*) FROM `CKLCheck` WHERE `CKLCheck`.`STIGCheckId` = old.`id` AND `CKLCheck`.`AssetId` = `ComplianceSummary`.`AssetId` "
+                "AND IFNULL(`CKLCheck`.`status`, 0) = `ComplianceSummary`.`status` AND " + EffectiveSeverity(QStringLiteral("`CKLCheck`"), QStringLiteral("old.`severity`")) + " = `ComplianceSummary`.`severity`) WHERE `STIGId` = old.`STIGId`; " +
+                summaryInsert +
+                "SELECT `CKLCheck`.`AssetId`, new.`STIGId`, " + EffectiveSeverity(QStringLiteral("`CKLCheck`"), QStringLiteral("new.`severity`")) + ", IFNULL(`CKLCheck`.`status`, 0), COUNT(*) FROM `CKLCheck` WHERE `CKLCheck`.`STIGCheckId` = new.`id` GROUP BY 1, 2, 3, 4 "
+                "ON CONFLICT " + summaryKey + " DO UPDATE SET `checks` = `checks` + excluded.`checks`; "
+                "DELETE FROM `ComplianceSummary` WHERE `STIGId` = old.`STIGId` AND `checks` <= 0; "
+                "END",
+                QStringLiteral("DELETE FROM `ComplianceSummary`"),
+                summaryInsert + ComplianceSummaryQuery(QStringLiteral("COUNT(*)"))
+            };
+            bool summaryRet = true;
+            for (const QString &statement : statements)
+            {
+                q.prepare(statement);
+                summaryRet = q.exec() && summaryRet;
+            }
+            summaryRet = UpdateVariable(QStringLiteral("version"), QStringLiteral("12")) && summaryRet;
+            if (summaryRet)
+                db.commit();
+            else
+                db.rollback();
+            ret = summaryRet && ret;
+        }
     }
     return ret;
 }
@@ -22,8 +22,12 @@
 
 #include <QSqlDatabase>
 #include <QString>
+#include <QStringList>
+#include <QVariant>
 #include <QVector>
 
+#include <functional>
+#include <memory>
 #include <tuple>
 
 #include "asset.h"
@@ -35,8 +39,33 @@
 #include "stigcheck.h"
 #include "supplement.h"
 
+class AssessmentSnapshot;
+class CCILookup;
+class DbTransaction;
+struct LogRecord;
+
+struct SearchHit
+{
+    int cklCheckId{-1};
+    int stigCheckId{-1};
+    int stigId{-1};
+    int assetId{-1};
+    double rank{0};
+    QString snippet;
+};
+
+struct ComplianceCounts
+{
+    int checks[4][4]{}; //by Severity, then Status
+    [[nodiscard]] int Count(Status status) const;
+    [[nodiscard]] int Count(Severity severity, Status status) const;
+    [[nodiscard]] int Total() const;
+};
+
 class DbManager
 {
+    friend class DbTransaction;
+
 public:
     explicit DbManager();
     explicit DbManager(const QString& connectionName);
@@ -54,6 +83,8 @@ public:
     bool AddFamily(const QString &acronym, const QString &description);
     bool AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVector<Supplement> &supplements = {}, bool stigExists = false);
     bool AddSTIGToAsset(const STIG &stig, const Asset &asset);
+    bool BulkInsert(const QString &table, const QStringList &columns, const QVector<QVariantList> &rows, QVector<int> *ids = nullptr);
+    int CheckComplianceSummary();
 
     bool DeleteAsset(int id);
     bool DeleteAsset(const Asset &asset);
@@ -64,10 +95,18 @@ public:
     bool DeleteSTIG(const STIG &stig);
     bool DeleteSTIGFromAsset(const STIG &stig, const Asset &asset);
 
+    int CountCKLChecks(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+    int CountSTIGChecks(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+    bool ForEachCCI(const std::function<bool (const CCI &)> &callback, const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+    bool ForEachCKLCheck(const std::function<bool (const CKLCheck &)> &callback, const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+    bool ForEachSTIGCheck(const std::function<bool (const STIGCheck &)> &callback, const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+
+    std::shared_ptr<const AssessmentSnapshot> GetAssessmentSnapshot();
     Asset GetAsset(int id);
     Asset GetAsset(const QString &hostName);
     Asset GetAsset(const Asset &asset);
     QVector<Asset> GetAssets(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+    QVector<Asset> GetAssets(const QVector<int> &ids);
     QVector<Asset> GetAssets(const STIG &stig);
     CCI GetCCI(int id);
     CCI GetCCI(const CCI &cci, const STIG *stig = nullptr);
@@ -75,6 +114,7 @@ public:
     QVector<CCI> GetCCIs(const Control &c);
     QVector<CCI> GetCCIs(int STIGCheckId);
     CCI GetCCIByCCI(int cci, const STIG *stig = nullptr);
+    std::shared_ptr<const CCILookup> GetCCILookup();
     QVector<CCI> GetCCIs(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
     CKLCheck GetCKLCheck(int id);
     CKLCheck GetCKLCheck(const CKLCheck &ckl);
@@ -83,6 +123,7 @@ public:
     QVector<CKLCheck> GetCKLChecks(const CCI &cci);
     QVector<CKLCheck> GetCKLChecks(const STIGCheck &stigCheck);
     QVector<CKLCheck> GetCKLChecks(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+    ComplianceCounts GetComplianceCounts(const Asset *asset = nullptr, const STIG *stig = nullptr);
     Control GetControl(int id);
     Control GetControl(const QString &control);
     QVector<Control> GetControls(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
@@ -91,7 +132,8 @@ public:
     Family GetFamily(int id);
     QVector<Family> GetFamilies(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
     QVector<QString> GetLegacyIds(int STIGCheckId);
-    int GetLogLevel();
+    static int GetLogLevel();
+    QStringList GetQueryPlan(const QString &query, const QVector<std::tuple<QString, QVariant>> &variables = {});
     QVector<CCI> GetRemapCCIs();
     STIG GetSTIG(int id);
     STIG GetSTIG(const QString &title, int version, const QString &release);
@@ -101,19 +143,28 @@ public:
     STIGCheck GetSTIGCheck(const STIGCheck &stigcheck);
     QVector<STIGCheck> GetSTIGChecks(const STIG &stig);
     QVector<STIGCheck> GetSTIGChecks(const CCI &cci);
+    QVector<STIGCheck> GetSTIGChecks(const QVector<int> &ids);
     QVector<STIGCheck> GetSTIGChecks(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+    QVector<STIGCheckHeader> GetSTIGCheckHeaders(const STIG &stig);
+    QVector<STIGCheckHeader> GetSTIGCheckHeaders(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
     QVector<STIG> GetSTIGs(const Asset &asset);
+    QVector<STIG> GetSTIGs(const QVector<int> &ids);
     QVector<STIG> GetSTIGs(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant> > &variables = {});
+    QByteArray GetSaveHash(const QString &path);
     QVector<Supplement> GetSupplements(const STIG &stig);
     QString GetVariable(const QString &name);
 
     bool IsEmassImport();
 
-    bool LoadDB(const QString &path);
-    bool Log(int severity, const QString &location, const QString &message);
-    bool Log(int severity, const QString &location, const QSqlQuery& query);
-    bool SaveDB(const QString &path);
-    QByteArray HashDB();
+    bool LoadDB(const QString &path, const std::function<void (qint64, qint64)> &progress = {});
+    static bool Log(int severity, const QString &location, const QString &message);
+    static bool Log(int severity, const QString &location, const QSqlQuery& query);
+    bool RebuildComplianceSummary();
+    bool SaveDB(const QString &path, const std::function<void (qint64, qint64)> &progress = {});
+    QByteArray HashDB(bool assessmentOnly = false);
+    QVector<SearchHit> Search(const QString &text, int limit = 50, const Asset *asset = nullptr);
+    QVector<int> SearchAssets(const QString &text);
+    QVector<int> SearchSTIGs(const QString &text);
 
     bool UpdateAsset(const Asset &asset);
     bool UpdateCCI(const CCI &cci);
@@ -123,12 +174,15 @@ public:
     bool UpdateSTIGCheck(const STIGCheck &check);
     bool UpdateVariable(const QString &name, const QString &value);
 
+    static bool WriteLog(const QVector<LogRecord> &records);
+
 private:
     bool UpdateDatabaseFromVersion(int version);
+    void LoadSTIGCheckMappings(QVector<STIGCheck> &checks, const QString &idQuery, const QVector<std::tuple<QString, QVariant>> &variables);
     static bool CheckDatabase(QSqlDatabase &db);
+    QVector<int> SearchOwners(const QString &text, bool assets);
     QString _dbPath;
-    bool _delayCommit{};
-    int _logLevel{};
+    std::unique_ptr<DbTransaction> _delayCommit;
 };
 
 QString GetLastExecutedQuery(const QSqlQuery& query);
@@ -0,0 +1,375 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dbquery.h"
+#include "querystats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <utility>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+/**
+ * @class DbQuery
+ * @brief A @a QSqlQuery that reuses prepared statements.
+ *
+ * Every @a DbManager getter and mutator prepares its SQL each time it
+ * is called. Bulk operations (STIG ingest, CKL import) call the same
+ * handful of statements thousands of times, so re-parsing the SQL
+ * dominates their run time.
+ *
+ * A @a DbQuery keeps a cache of prepared statements for each
+ * database connection, keyed by the SQL text. Calling prepare()
+ * checks a statement out of the cache (or prepares a new one on a
+ * miss), and the statement is returned to the cache when the query
+ * prepares different SQL or goes out of scope. A statement that is
+ * checked out is not shared; a nested query using the same SQL text
+ * prepares its own copy.
+ *
+ * Each connection keeps at most CacheCapacity() statements and
+ * finalizes its least recently used ones beyond that, so SQL built
+ * from varying where-clause text does not accumulate.
+ *
+ * When built with query statistics (see @a QueryStats), the time
+ * spent in exec() and next() is recorded for each execution.
+ *
+ * StartCapture() and StopCapture() list the SQL that a thread
+ * prepares, so that the statements a getter actually runs can be
+ * inspected (for example, with DbManager::GetQueryPlan()).
+ */
+
+namespace {
+    struct CachedStatement
+    {
+        QString query;
+        QSqlQuery statement;
+    };
+
+    //the prepared statements of one connection, keyed by SQL text
+    struct ConnectionStatements
+    {
+        std::list<CachedStatement> entries; //most recently used first
+        QHash<QString, std::list<CachedStatement>::iterator> index;
+    };
+
+    //connection name → prepared statements
+    typedef QHash<QString, ConnectionStatements> StatementCache;
+    Q_GLOBAL_STATIC(StatementCache, statementCache)
+    QMutex cacheMutex;
+    int cacheCapacity = 64;
+    std::atomic<quint64> cacheHits{0};
+    std::atomic<quint64> cacheMisses{0};
+
+    //the SQL prepared by this thread since StartCapture()
+    struct Capture
+    {
+        bool active{false};
+        QStringList queries;
+    };
+    thread_local Capture capture;
+
+    //finalizes the least recently used statements beyond the capacity
+    void Trim(ConnectionStatements &cache)
+    {
+        while (cache.entries.size() > static_cast<size_t>(cacheCapacity))
+        {
+            cache.index.remove(cache.entries.back().query);
+            cache.entries.pop_back();
+        }
+    }
+}
+
+/**
+ * @brief DbQuery::DbQuery
+ * @param db
+ *
+ * Main constructor. The @a db is the thread's connection obtained
+ * from DbManager::CheckDatabase().
+ */
+DbQuery::DbQuery(const QSqlDatabase &db) : QSqlQuery(db),
+    _db(db),
+    _connectionName(db.connectionName()),
+    _cachedQuery()
+{
+}
+
+/**
+ * @brief DbQuery::~DbQuery
+ *
+ * The destructor returns the prepared statement to the cache.
+ */
+DbQuery::~DbQuery()
+{
+#ifdef STIGQTER_QUERY_STATS
+    RecordStats();
+#endif
+    Release(false);
+}
+
+/**
+ * @brief DbQuery::prepare
+ * @param query
+ * @return @c True when the statement is ready to be bound and
+ * executed. Otherwise, @c false.
+ *
+ * Hides QSqlQuery::prepare() so that existing code written against
+ * @a QSqlQuery uses the statement cache without modification.
+ */
+bool DbQuery::prepare(const QString &query)
+{
+#ifdef STIGQTER_QUERY_STATS
+    RecordStats();
+#endif
+
+    if (capture.active)
+        capture.queries.append(query);
+
+    //re-preparing the statement already held; reset it and reuse it
+    if (!_cachedQuery.isEmpty() && _cachedQuery == query)
+    {
+        finish();
+        cacheHits++;
+        return true;
+    }
+
+    //the statement taken from the cache replaces this query's settings
+    const bool forwardOnly = isForwardOnly();
+    Release();
+
+    {
+        QMutexLocker locker(&cacheMutex);
+        ConnectionStatements &cache = (*statementCache)[_connectionName];
+        auto it = cache.index.find(query);
+        if (it != cache.index.end())
+        {
+            QSqlQuery::operator=(std::move(it.value()->statement));
+            cache.entries.erase(it.value());
+            cache.index.erase(it);
+            setForwardOnly(forwardOnly);
+            _cachedQuery = query;
+            cacheHits++;
+            return true;
+        }
+    }
+
+    setForwardOnly(forwardOnly);
+    cacheMisses++;
+    bool ret = QSqlQuery::prepare(query);
+    if (ret)
+        _cachedQuery = query;
+    return ret;
+}
+
+/**
+ * @brief DbQuery::ClearCache
+ * @param connectionName
+ *
+ * Finalizes the cached statements of the connection. This must be
+ * done before the connection is closed or its database file is
+ * replaced.
+ */
+void DbQuery::ClearCache(const QString &connectionName)
+{
+    QMutexLocker locker(&cacheMutex);
+    statementCache->remove(connectionName);
+}
+
+/**
+ * @brief DbQuery::CacheHits
+ * @return The number of prepare() calls satisfied from the cache.
+ */
+quint64 DbQuery::CacheHits()
+{
+    return cacheHits;
+}
+
+/**
+ * @brief DbQuery::CacheMisses
+ * @return The number of prepare() calls that had to parse the SQL.
+ */
+quint64 DbQuery::CacheMisses()
+{
+    return cacheMisses;
+}
+
+/**
+ * @brief DbQuery::CacheSize
+ * @return The number of statements currently held in the cache
+ * across all connections.
+ */
+int DbQuery::CacheSize()
+{
+    QMutexLocker locker(&cacheMutex);
+    int ret = 0;
+    for (const auto &cache : std::as_const(*statementCache))
+        ret += static_cast<int>(cache.index.count());
+    return ret;
+}
+
+/**
+ * @brief DbQuery::CacheSize
+ * @param connectionName
+ * @return The number of statements currently held in the cache for
+ * the connection.
+ */
+int DbQuery::CacheSize(const QString &connectionName)
+{
+    QMutexLocker locker(&cacheMutex);
+    auto it = statementCache->constFind(connectionName);
+    return it == statementCache->constEnd() ? 0 : static_cast<int>(it->index.count());
+}
+
+/**
+ * @brief DbQuery::SetCacheCapacity
+ * @param capacity
+ *
+ * Sets the number of statements kept for each connection. A capacity
+ * of 0 disables the cache.
+ */
+void DbQuery::SetCacheCapacity(int capacity)
+{
+    QMutexLocker locker(&cacheMutex);
+    cacheCapacity = std::max(0, capacity);
+    for (ConnectionStatements &cache : *statementCache)
+        Trim(cache);
+}
+
+/**
+ * @brief DbQuery::CacheCapacity
+ * @return The number of statements kept for each connection.
+ */
+int DbQuery::CacheCapacity()
+{
+    QMutexLocker locker(&cacheMutex);
+    return cacheCapacity;
+}
+
+/**
+ * @brief DbQuery::StartCapture
+ *
+ * Starts recording the SQL prepared by the calling thread.
+ */
+void DbQuery::StartCapture()
+{
+    capture.active = true;
+    capture.queries.clear();
+}
+
+/**
+ * @brief DbQuery::StopCapture
+ * @return The SQL prepared by the calling thread since
+ * StartCapture(), in order.
+ */
+QStringList DbQuery::StopCapture()
+{
+    capture.active = false;
+    return std::exchange(capture.queries, QStringList());
+}
+
+/**
+ * @brief DbQuery::Release
+ * @param reset
+ *
+ * Resets the statement held by this query and returns it to the
+ * cache. When @a reset is @c true, this query is given a fresh,
+ * unprepared statement so that it remains usable.
+ */
+void DbQuery::Release(bool reset)
+{
+    if (_cachedQuery.isEmpty())
+        return;
+
+    finish();
+    QSqlQuery released(std::move(static_cast<QSqlQuery&>(*this)));
+    if (reset)
+        QSqlQuery::operator=(QSqlQuery(_db));
+
+    QMutexLocker locker(&cacheMutex);
+    ConnectionStatements &cache = (*statementCache)[_connectionName];
+    //a nested copy of the same SQL replaces the one returned first
+    auto it = cache.index.find(_cachedQuery);
+    if (it != cache.index.end())
+    {
+        cache.entries.erase(it.value());
+        cache.index.erase(it);
+    }
+    cache.entries.push_front({_cachedQuery, std::move(released)});
+    cache.index.insert(_cachedQuery, cache.entries.begin());
+    Trim(cache);
+    _cachedQuery.clear();
+}
+
+#ifdef STIGQTER_QUERY_STATS
+/**
+ * @brief DbQuery::exec
+ * @return The result of QSqlQuery::exec(), which this hides so that
+ * the execution is timed.
+ */
+bool DbQuery::exec()
+{
+    RecordStats();
+    QElapsedTimer timer;
+    timer.start();
+    const bool ret = QSqlQuery::exec();
+    _statsNsecs = timer.nsecsElapsed();
+    _statsParameters = static_cast<int>(boundValues().size());
+    _statsRows = (ret && !isSelect()) ? numRowsAffected() : 0;
+    _statsPending = true;
+    return ret;
+}
+
+/**
+ * @brief DbQuery::next
+ * @return The result of QSqlQuery::next(). SQLite computes the rows
+ * of a result as they are read, so stepping is timed with the
+ * execution.
+ */
+bool DbQuery::next()
+{
+    if (!_statsPending)
+        return QSqlQuery::next();
+
+    QElapsedTimer timer;
+    timer.start();
+    const bool ret = QSqlQuery::next();
+    _statsNsecs += timer.nsecsElapsed();
+    if (ret)
+        _statsRows++;
+    return ret;
+}
+
+/**
+ * @brief DbQuery::RecordStats
+ *
+ * Reports the last execution once its results are no longer read:
+ * when the query is executed again, prepared again, or destroyed.
+ */
+void DbQuery::RecordStats()
+{
+    if (!_statsPending)
+        return;
+    _statsPending = false;
+    QueryStats::Record(_db, *this, lastQuery(), _statsParameters, _statsRows, _statsNsecs);
+}
+#endif
@@ -0,0 +1,67 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DBQUERY_H
+#define DBQUERY_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+
+class DbQuery : public QSqlQuery
+{
+public:
+    explicit DbQuery(const QSqlDatabase &db);
+    DbQuery(const DbQuery &right) = delete;
+    ~DbQuery();
+    DbQuery& operator=(const DbQuery &right) = delete;
+
+    bool prepare(const QString &query);
+#ifdef STIGQTER_QUERY_STATS
+    using QSqlQuery::exec;
+    bool exec();
+    bool next();
+#endif
+
+    static void ClearCache(const QString &connectionName);
+    static quint64 CacheHits();
+    static quint64 CacheMisses();
+    static int CacheSize();
+    static int CacheSize(const QString &connectionName);
+    static void SetCacheCapacity(int capacity);
+    static int CacheCapacity();
+    static void StartCapture();
+    static QStringList StopCapture();
+
+private:
+    void Release(bool reset = true);
+    QSqlDatabase _db;
+    QString _connectionName;
+    QString _cachedQuery;
+#ifdef STIGQTER_QUERY_STATS
+    void RecordStats();
+    bool _statsPending{false};
+    int _statsParameters{0};
+    qint64 _statsRows{0};
+    qint64 _statsNsecs{0};
+#endif
+};
+
+#endif // DBQUERY_H
@@ -0,0 +1,203 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dbtransaction.h"
+#include "common.h"
+#include "dbmanager.h"
+#include "entitycache.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+
+/**
+ * @class DbTransaction
+ * @brief A scoped transaction on the thread's database connection.
+ *
+ * Constructing a @a DbTransaction begins a transaction; destructing
+ * it commits the transaction unless Commit() or Rollback() has
+ * already ended it. Every @a DbManager mutator on the same thread
+ * joins the open transaction instead of committing on its own, so a
+ * bulk operation wrapped in a @a DbTransaction is written with
+ * exactly one commit.
+ *
+ * Transactions nest. The outermost @a DbTransaction on a thread
+ * issues BEGIN IMMEDIATE and COMMIT; the inner ones use savepoints,
+ * so an inner Rollback() undoes only the work of its own scope and
+ * an inner Commit() leaves the changes pending in the outer scope.
+ * Scopes must end in the reverse order that they began, which is
+ * guaranteed when they are declared as local variables.
+ *
+ * Example:
+ * @code
+ * DbManager db;
+ * DbTransaction transaction;
+ * for (const CKLCheck &check : checks)
+ *     db.UpdateCKLCheck(check);
+ * //one commit when transaction goes out of scope
+ * @endcode
+ */
+
+namespace {
+    //number of open DbTransactions on this thread's connection
+    thread_local int transactionDepth = 0;
+}
+
+/**
+ * @brief DbTransaction::DbTransaction
+ *
+ * Default constructor. Begins a transaction, or a savepoint when a
+ * transaction is already open on this thread.
+ */
+DbTransaction::DbTransaction()
+{
+    if (!DbManager::CheckDatabase(_db))
+        return;
+
+    //take the write lock up front; upgrading a read lock can fail while another thread writes
+    if (Execute(transactionDepth == 0 ? QStringLiteral("BEGIN IMMEDIATE") : "SAVEPOINT sp" + QString::number(transactionDepth)))
+    {
+        _level = transactionDepth;
+        transactionDepth++;
+    }
+    else
+    {
+        Warning(QStringLiteral("Unable to Start Transaction"), "Changes will be committed individually: " + _lastError);
+    }
+}
+
+/**
+ * @brief DbTransaction::~DbTransaction
+ *
+ * The destructor commits the transaction if it is still open.
+ */
+DbTransaction::~DbTransaction()
+{
+    if (IsOpen())
+        End(true);
+}
+
+/**
+ * @brief DbTransaction::Commit
+ * @return @c True when the transaction (or savepoint) is committed.
+ * Otherwise, @c false.
+ *
+ * Changes committed by a nested @a DbTransaction are written when the
+ * outermost @a DbTransaction commits.
+ */
+bool DbTransaction::Commit()
+{
+    return End(true);
+}
+
+/**
+ * @brief DbTransaction::Rollback
+ * @return @c True when the changes made in this scope are discarded.
+ * Otherwise, @c false.
+ */
+bool DbTransaction::Rollback()
+{
+    return End(false);
+}
+
+/**
+ * @brief DbTransaction::IsOpen
+ * @return @c True until the transaction is committed or rolled back.
+ */
+bool DbTransaction::IsOpen() const
+{
+    return _level >= 0;
+}
+
+/**
+ * @brief DbTransaction::Active
+ * @return @c True when a @a DbTransaction is open on this thread.
+ */
+bool DbTransaction::Active()
+{
+    return transactionDepth > 0;
+}
+
+/**
+ * @brief DbTransaction::Depth
+ * @return The number of @a DbTransactions open on this thread.
+ */
+int DbTransaction::Depth()
+{
+    return transactionDepth;
+}
+
+/**
+ * @brief DbTransaction::End
+ * @param commit
+ * @return @c True when the scope is committed (@a commit is @c true)
+ * or rolled back (@a commit is @c false). Otherwise, @c false.
+ */
+bool DbTransaction::End(bool commit)
+{
+    if (!IsOpen())
+        return false;
+
+    if (_level != transactionDepth - 1)
+    {
+        Warning(QStringLiteral("Transaction Order"), "A database transaction ended while " + QString::number(transactionDepth - 1 - _level) + " nested transaction(s) were still open.");
+    }
+
+    bool ret = false;
+    if (_level == 0)
+    {
+        ret = Execute(commit ? QStringLiteral("COMMIT") : QStringLiteral("ROLLBACK"));
+        if (!ret && commit)
+        {
+            Warning(QStringLiteral("Unable to Commit Transaction"), _lastError);
+            Execute(QStringLiteral("ROLLBACK"));
+        }
+        else if (ret && commit)
+        {
+            //fold the bulk write back into the database file without blocking readers
+            Execute(QStringLiteral("PRAGMA wal_checkpoint(PASSIVE)"));
+        }
+    }
+    else
+    {
+        const QString savepoint = "sp" + QString::number(_level);
+        ret = commit || Execute("ROLLBACK TO SAVEPOINT " + savepoint);
+        ret = Execute("RELEASE SAVEPOINT " + savepoint) && ret;
+    }
+
+    transactionDepth = _level;
+    if (_level == 0)
+        EntityCache::EndTransaction();
+    _level = -1;
+    return ret;
+}
+
+/**
+ * @brief DbTransaction::Execute
+ * @param sql
+ * @return @c True when the transaction control statement succeeds.
+ * Otherwise, @c false, and the error is kept for reporting.
+ */
+bool DbTransaction::Execute(const QString &sql)
+{
+    QSqlQuery q(_db);
+    bool ret = q.exec(sql);
+    if (!ret)
+        _lastError = q.lastError().text();
+    return ret;
+}
@@ -0,0 +1,49 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DBTRANSACTION_H
+#define DBTRANSACTION_H
+
+#include <QSqlDatabase>
+#include <QString>
+
+class DbTransaction
+{
+public:
+    explicit DbTransaction();
+    DbTransaction(const DbTransaction &right) = delete;
+    ~DbTransaction();
+    DbTransaction& operator=(const DbTransaction &right) = delete;
+
+    bool Commit();
+    bool Rollback();
+    [[nodiscard]] bool IsOpen() const;
+
+    [[nodiscard]] static bool Active();
+    [[nodiscard]] static int Depth();
+
+private:
+    bool End(bool commit);
+    bool Execute(const QString &sql);
+    QSqlDatabase _db;
+    QString _lastError;
+    int _level{-1};
+};
+
+#endif // DBTRANSACTION_H
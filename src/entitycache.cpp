@@ -0,0 +1,516 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "entitycache.h"
+#include "dbtransaction.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QMutexLocker>
+#include <QSet>
+
+/**
+ * @class EntityCache
+ * @brief A process-wide, read-through cache of the reference
+ * entities (@a STIGs, @a STIGChecks, @a CCIs, @a Controls, and
+ * @a Families) keyed by their database id.
+ *
+ * The reference tables change only when a STIG or the CCI list is
+ * imported, yet the navigation functions (CKLCheck::GetSTIGCheck(),
+ * STIGCheck::GetSTIG(), CCI::GetControl(), Control::GetFamily())
+ * are called for every row a report or view touches. DbManager
+ * checks the cache before querying a single entity by id and fills
+ * it after a miss.
+ *
+ * Every @a DbManager mutator removes the entries it changes. Writes
+ * made inside a @a DbTransaction are removed again when the
+ * outermost transaction ends; until then, other threads still read
+ * the previously committed row and could have put it back in the
+ * cache.
+ *
+ * Each entity type is bounded separately and evicts its least
+ * recently used entries. A capacity of 0 disables the cache for that
+ * type.
+ *
+ * The cache also holds the @a CCILookup table that STIG imports use
+ * to resolve CCI numbers. It follows the same invalidation rules as
+ * the entities: it is dropped whenever a @a CCI is added, changed, or
+ * deleted, and again when the transaction that did so ends.
+ */
+
+/**
+ * @class EntityCacheMap
+ * @brief A thread-safe, least-recently-used map from database id to
+ * a copy of an entity.
+ *
+ * Find() and Insert() are bracketed by Generation() to keep stale
+ * reads out of the cache: a row read before a concurrent Remove() or
+ * Clear() carries an older generation and is not inserted.
+ */
+
+namespace {
+    //ids removed by this thread inside the open transaction
+    struct PendingInvalidations
+    {
+        QSet<int> ids;
+        bool all = false;
+    };
+
+    template<typename T>
+    PendingInvalidations &Pending()
+    {
+        thread_local PendingInvalidations pending;
+        return pending;
+    }
+
+    QMutex lookupMutex;
+    std::shared_ptr<const CCILookup> lookupTable;
+    quint64 lookupGeneration = 0;
+    //whether this thread changed the CCIs inside the open transaction
+    thread_local bool lookupPending = false;
+}
+
+/**
+ * @brief EntityCacheMap::EntityCacheMap
+ * @param capacity
+ *
+ * Main constructor. At most @a capacity entities are kept.
+ */
+template<typename T>
+EntityCacheMap<T>::EntityCacheMap(int capacity) : _capacity(capacity)
+{
+}
+
+/**
+ * @brief EntityCacheMap::Find
+ * @param id
+ * @param ret
+ * @return @c True when the entity with the database @a id is cached
+ * and has been copied to @a ret. Otherwise, @c false.
+ */
+template<typename T>
+bool EntityCacheMap<T>::Find(int id, T &ret)
+{
+    QMutexLocker locker(&_mutex);
+    auto it = _index.find(id);
+    if (it == _index.end())
+    {
+        _misses++;
+        return false;
+    }
+    _entries.splice(_entries.begin(), _entries, it.value());
+    ret = it.value()->value;
+    _hits++;
+    return true;
+}
+
+/**
+ * @brief EntityCacheMap::Insert
+ * @param id
+ * @param value
+ * @param generation
+ *
+ * Caches a copy of @a value, read from the database after
+ * Generation() returned @a generation. The copy is dropped if the
+ * cache has been invalidated since, or if this thread has changed
+ * the row in a transaction that is still open.
+ */
+template<typename T>
+void EntityCacheMap<T>::Insert(int id, const T &value, quint64 generation)
+{
+    const PendingInvalidations &pending = Pending<T>();
+    if (pending.all || pending.ids.contains(id))
+        return;
+
+    QMutexLocker locker(&_mutex);
+    if (_capacity <= 0 || generation != _generation)
+        return;
+
+    auto it = _index.find(id);
+    if (it != _index.end())
+    {
+        _entries.splice(_entries.begin(), _entries, it.value());
+    }
+    else
+    {
+        _entries.emplace_front();
+        _entries.front().id = id;
+        _index.insert(id, _entries.begin());
+    }
+    _entries.front().value = value;
+    Trim();
+}
+
+/**
+ * @brief EntityCacheMap::Remove
+ * @param id
+ *
+ * Invalidates the entity with the database @a id.
+ */
+template<typename T>
+void EntityCacheMap<T>::Remove(int id)
+{
+    {
+        QMutexLocker locker(&_mutex);
+        auto it = _index.find(id);
+        if (it != _index.end())
+        {
+            _entries.erase(it.value());
+            _index.erase(it);
+        }
+        _generation++;
+    }
+    if (DbTransaction::Active())
+        Pending<T>().ids.insert(id);
+}
+
+/**
+ * @brief EntityCacheMap::Clear
+ *
+ * Invalidates every cached entity.
+ */
+template<typename T>
+void EntityCacheMap<T>::Clear()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _index.clear();
+        _entries.clear();
+        _generation++;
+    }
+    if (DbTransaction::Active())
+        Pending<T>().all = true;
+}
+
+/**
+ * @brief EntityCacheMap::EndTransaction
+ *
+ * Repeats the invalidations made by this thread during the
+ * transaction that just ended.
+ */
+template<typename T>
+void EntityCacheMap<T>::EndTransaction()
+{
+    PendingInvalidations pending;
+    std::swap(pending, Pending<T>());
+    if (pending.all)
+    {
+        Clear();
+    }
+    else
+    {
+        for (int id : std::as_const(pending.ids))
+            Remove(id);
+    }
+}
+
+/**
+ * @brief EntityCacheMap::SetCapacity
+ * @param capacity
+ *
+ * Sets the maximum number of cached entities, evicting the least
+ * recently used ones when the cache is already larger.
+ */
+template<typename T>
+void EntityCacheMap<T>::SetCapacity(int capacity)
+{
+    QMutexLocker locker(&_mutex);
+    _capacity = capacity;
+    Trim();
+}
+
+/**
+ * @brief EntityCacheMap::Capacity
+ * @return The maximum number of cached entities.
+ */
+template<typename T>
+int EntityCacheMap<T>::Capacity() const
+{
+    QMutexLocker locker(&_mutex);
+    return _capacity;
+}
+
+/**
+ * @brief EntityCacheMap::Generation
+ * @return A counter that changes whenever an entity is invalidated.
+ */
+template<typename T>
+quint64 EntityCacheMap<T>::Generation() const
+{
+    QMutexLocker locker(&_mutex);
+    return _generation;
+}
+
+/**
+ * @brief EntityCacheMap::Hits
+ * @return The number of Find() calls satisfied from the cache.
+ */
+template<typename T>
+quint64 EntityCacheMap<T>::Hits() const
+{
+    QMutexLocker locker(&_mutex);
+    return _hits;
+}
+
+/**
+ * @brief EntityCacheMap::Misses
+ * @return The number of Find() calls that had to query the database.
+ */
+template<typename T>
+quint64 EntityCacheMap<T>::Misses() const
+{
+    QMutexLocker locker(&_mutex);
+    return _misses;
+}
+
+/**
+ * @brief EntityCacheMap::Evictions
+ * @return The number of entities dropped to stay within Capacity().
+ */
+template<typename T>
+quint64 EntityCacheMap<T>::Evictions() const
+{
+    QMutexLocker locker(&_mutex);
+    return _evictions;
+}
+
+/**
+ * @brief EntityCacheMap::Size
+ * @return The number of cached entities.
+ */
+template<typename T>
+int EntityCacheMap<T>::Size() const
+{
+    QMutexLocker locker(&_mutex);
+    return static_cast<int>(_index.count());
+}
+
+/**
+ * @brief EntityCacheMap::Trim
+ *
+ * Evicts the least recently used entities beyond the capacity. The
+ * caller holds the mutex.
+ */
+template<typename T>
+void EntityCacheMap<T>::Trim()
+{
+    while (!_entries.empty() && _index.count() > std::max(_capacity, 0))
+    {
+        _index.remove(_entries.back().id);
+        _entries.pop_back();
+        _evictions++;
+    }
+}
+
+template class EntityCacheMap<CCI>;
+template class EntityCacheMap<Control>;
+template class EntityCacheMap<Family>;
+template class EntityCacheMap<STIG>;
+template class EntityCacheMap<STIGCheck>;
+
+/**
+ * @brief EntityCache::CCIs
+ * @return The cache of @a CCIs. Every CCI in the library fits in the
+ * default capacity.
+ */
+EntityCacheMap<CCI> &EntityCache::CCIs()
+{
+    static EntityCacheMap<CCI> cache(8192);
+    return cache;
+}
+
+/**
+ * @brief EntityCache::Controls
+ * @return The cache of @a Controls.
+ */
+EntityCacheMap<Control> &EntityCache::Controls()
+{
+    static EntityCacheMap<Control> cache(2048);
+    return cache;
+}
+
+/**
+ * @brief EntityCache::Families
+ * @return The cache of @a Families.
+ */
+EntityCacheMap<Family> &EntityCache::Families()
+{
+    static EntityCacheMap<Family> cache(64);
+    return cache;
+}
+
+/**
+ * @brief EntityCache::STIGs
+ * @return The cache of @a STIGs.
+ */
+EntityCacheMap<STIG> &EntityCache::STIGs()
+{
+    static EntityCacheMap<STIG> cache(1024);
+    return cache;
+}
+
+/**
+ * @brief EntityCache::STIGChecks
+ * @return The cache of @a STIGChecks. A STIG library holds far more
+ * checks than an assessment uses at once, so only the working set
+ * is kept.
+ */
+EntityCacheMap<STIGCheck> &EntityCache::STIGChecks()
+{
+    static EntityCacheMap<STIGCheck> cache(4096);
+    return cache;
+}
+
+/**
+ * @brief EntityCache::CCILookupTable
+ * @return The cached @a CCILookup table, or @c nullptr when it has
+ * not been loaded since it was last invalidated.
+ */
+std::shared_ptr<const CCILookup> EntityCache::CCILookupTable()
+{
+    QMutexLocker locker(&lookupMutex);
+    return lookupTable;
+}
+
+/**
+ * @brief EntityCache::CCILookupGeneration
+ * @return A counter that changes whenever the @a CCILookup table is
+ * invalidated. Read it before loading the table.
+ */
+quint64 EntityCache::CCILookupGeneration()
+{
+    QMutexLocker locker(&lookupMutex);
+    return lookupGeneration;
+}
+
+/**
+ * @brief EntityCache::SetCCILookupTable
+ * @param table
+ * @param generation
+ *
+ * Caches the @a table loaded after CCILookupGeneration() returned
+ * @a generation. It is dropped if the CCIs have changed since, or if
+ * this thread has changed them in a transaction that is still open.
+ */
+void EntityCache::SetCCILookupTable(const std::shared_ptr<const CCILookup> &table, quint64 generation)
+{
+    if (lookupPending)
+        return;
+    QMutexLocker locker(&lookupMutex);
+    if (generation == lookupGeneration)
+        lookupTable = table;
+}
+
+/**
+ * @brief EntityCache::InvalidateCCILookupTable
+ *
+ * Drops the @a CCILookup table after the CCIs change. Tables already
+ * handed out stay valid for the imports that hold them.
+ */
+void EntityCache::InvalidateCCILookupTable()
+{
+    {
+        QMutexLocker locker(&lookupMutex);
+        lookupTable.reset();
+        lookupGeneration++;
+    }
+    if (DbTransaction::Active())
+        lookupPending = true;
+}
+
+/**
+ * @brief EntityCache::Clear
+ *
+ * Invalidates every cached entity of every type.
+ */
+void EntityCache::Clear()
+{
+    InvalidateCCILookupTable();
+    CCIs().Clear();
+    Controls().Clear();
+    Families().Clear();
+    STIGs().Clear();
+    STIGChecks().Clear();
+}
+
+/**
+ * @brief EntityCache::EndTransaction
+ *
+ * Called by @a DbTransaction when the outermost transaction on this
+ * thread commits or rolls back.
+ */
+void EntityCache::EndTransaction()
+{
+    if (std::exchange(lookupPending, false))
+        InvalidateCCILookupTable();
+    CCIs().EndTransaction();
+    Controls().EndTransaction();
+    Families().EndTransaction();
+    STIGs().EndTransaction();
+    STIGChecks().EndTransaction();
+}
+
+/**
+ * @brief EntityCache::SetCapacity
+ * @param capacity
+ *
+ * Bounds every entity type to @a capacity entries. Deployments with
+ * little memory can lower it; 0 turns the cache off.
+ */
+void EntityCache::SetCapacity(int capacity)
+{
+    CCIs().SetCapacity(capacity);
+    Controls().SetCapacity(capacity);
+    Families().SetCapacity(capacity);
+    STIGs().SetCapacity(capacity);
+    STIGChecks().SetCapacity(capacity);
+}
+
+/**
+ * @brief EntityCache::Hits
+ * @return The number of lookups satisfied from the cache across
+ * every entity type.
+ */
+quint64 EntityCache::Hits()
+{
+    return CCIs().Hits() + Controls().Hits() + Families().Hits() + STIGs().Hits() + STIGChecks().Hits();
+}
+
+/**
+ * @brief EntityCache::Misses
+ * @return The number of lookups that had to query the database
+ * across every entity type.
+ */
+quint64 EntityCache::Misses()
+{
+    return CCIs().Misses() + Controls().Misses() + Families().Misses() + STIGs().Misses() + STIGChecks().Misses();
+}
+
+/**
+ * @brief EntityCache::HitRate
+ * @return The fraction of lookups satisfied from the cache, or 0
+ * before the first lookup.
+ */
+double EntityCache::HitRate()
+{
+    const quint64 hits = Hits();
+    const quint64 total = hits + Misses();
+    return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+}
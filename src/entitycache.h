@@ -0,0 +1,97 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENTITYCACHE_H
+#define ENTITYCACHE_H
+
+#include "cci.h"
+#include "ccilookup.h"
+#include "control.h"
+#include "family.h"
+#include "stig.h"
+#include "stigcheck.h"
+
+#include <list>
+#include <memory>
+
+#include <QHash>
+#include <QMutex>
+
+template<typename T>
+class EntityCacheMap
+{
+public:
+    explicit EntityCacheMap(int capacity);
+    EntityCacheMap(const EntityCacheMap &right) = delete;
+    EntityCacheMap& operator=(const EntityCacheMap &right) = delete;
+
+    bool Find(int id, T &ret);
+    void Insert(int id, const T &value, quint64 generation);
+    void Remove(int id);
+    void Clear();
+    void EndTransaction();
+
+    void SetCapacity(int capacity);
+    [[nodiscard]] int Capacity() const;
+    [[nodiscard]] quint64 Generation() const;
+    [[nodiscard]] quint64 Hits() const;
+    [[nodiscard]] quint64 Misses() const;
+    [[nodiscard]] quint64 Evictions() const;
+    [[nodiscard]] int Size() const;
+
+private:
+    struct Entry
+    {
+        int id;
+        T value;
+    };
+    void Trim();
+    mutable QMutex _mutex;
+    std::list<Entry> _entries; //most recently used first
+    QHash<int, typename std::list<Entry>::iterator> _index;
+    int _capacity;
+    quint64 _generation{0};
+    quint64 _hits{0};
+    quint64 _misses{0};
+    quint64 _evictions{0};
+};
+
+class EntityCache
+{
+public:
+    static EntityCacheMap<CCI>& CCIs();
+    static EntityCacheMap<Control>& Controls();
+    static EntityCacheMap<Family>& Families();
+    static EntityCacheMap<STIG>& STIGs();
+    static EntityCacheMap<STIGCheck>& STIGChecks();
+
+    [[nodiscard]] static std::shared_ptr<const CCILookup> CCILookupTable();
+    [[nodiscard]] static quint64 CCILookupGeneration();
+    static void SetCCILookupTable(const std::shared_ptr<const CCILookup> &table, quint64 generation);
+    static void InvalidateCCILookupTable();
+
+    static void Clear();
+    static void EndTransaction();
+    static void SetCapacity(int capacity);
+    [[nodiscard]] static quint64 Hits();
+    [[nodiscard]] static quint64 Misses();
+    [[nodiscard]] static double HitRate();
+};
+
+#endif // ENTITYCACHE_H
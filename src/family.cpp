@@ -61,46 +61,16 @@
 
 /**
  * @brief Family::Family
- * @param parent
  *
  * Default constructor.
  */
-Family::Family(QObject *parent) : QObject(parent),
+Family::Family() :
     id(-1),
     acronym(QStringLiteral("ZZ")),
     description(QStringLiteral("Default Family"))
 {
 }
 
-/**
- * @brief Family::Family
- * @param right
- *
- * Copy constructor.
- */
-Family::Family(const Family &right) : Family(right.parent())
-{
-    *this = right;
-}
-
-/**
- * @brief Family::operator=
- * @param right
- * @return This @a Family, copied from the assignee.
- *
- * Deep copy assignment operator.
- */
-Family& Family::operator=(const Family &right)
-{
-    if (this != &right)
-    {
-        id = right.id;
-        acronym = right.acronym;
-        description = right.description;
-    }
-    return *this;
-}
-
 /**
  * @brief PrintFamily
  * @param family
@@ -20,22 +20,19 @@
 #ifndef FAMILY_H
 #define FAMILY_H
 
-#include <QObject>
+#include <QMetaType>
 #include <QString>
 
-class Family : public QObject
+class Family
 {
-    Q_OBJECT
 public:
-    Family(const Family &right);
-    explicit Family(QObject *parent = nullptr);
-    ~Family() override = default;
+    Family();
     int id;
     QString acronym;
     QString description;
-    Family& operator=(const Family &right);
 };
 
+Q_DECLARE_TYPEINFO(Family, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(Family);
 
 [[nodiscard]] QString PrintFamily(const Family &family);
@@ -0,0 +1,388 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "logwriter.h"
+#include "dbconnections.h"
+#include "dbmanager.h"
+
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+
+/**
+ * @class LogWriter
+ * @brief The thread that writes the Log table.
+ *
+ * DbManager::Log() used to insert each record synchronously on the
+ * caller's connection, which doubled the number of writes during an
+ * import. Records are now placed in a bounded, lock-free queue and
+ * written by this thread in batches, one transaction per batch.
+ *
+ * The queue is a multi-producer, single-consumer ring buffer: each
+ * slot carries a sequence number that tells producers when the slot
+ * is free and the writer when it has been filled. When the queue is
+ * full, Enqueue() fails and the caller writes the record itself, so
+ * a thread that holds the database write lock can never wait on the
+ * writer.
+ *
+ * A batch that cannot be written (usually because another
+ * connection holds a long write transaction) is kept and retried
+ * until it is written; the Log table is the audit trail required by
+ * STIG rule SV-84059, so records are never discarded. Only when the
+ * writer stops and the database still cannot be written are the
+ * remaining records sent to the application's message log instead.
+ *
+ * The writer's connection is closed while the database file is
+ * replaced (see Suspend()) and when the writer stops.
+ */
+
+namespace {
+    void StopLogWriter()
+    {
+        LogWriter::Instance()->Stop();
+    }
+}
+
+/**
+ * @brief LogWriter::LogWriter
+ *
+ * Main constructor. Use Instance() to obtain the running writer.
+ */
+LogWriter::LogWriter() : QThread(nullptr),
+    _slots(new Slot[_capacity])
+{
+    for (quint64 i = 0; i < _capacity; i++)
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    setObjectName(QStringLiteral("LogWriter"));
+}
+
+/**
+ * @brief LogWriter::Instance
+ * @return The process-wide @a LogWriter, started on first use and
+ * stopped when the application exits.
+ */
+LogWriter *LogWriter::Instance()
+{
+    //never deleted; the thread is stopped by the post routine
+    static LogWriter *instance = []() {
+        auto *writer = new LogWriter();
+        writer->start(QThread::LowPriority);
+        qAddPostRoutine(StopLogWriter);
+        return writer;
+    }();
+    return instance;
+}
+
+/**
+ * @brief LogWriter::Enqueue
+ * @param record
+ * @return @c True when the @a record has been moved to the queue.
+ * Otherwise (the queue is full or the writer has stopped), @c false,
+ * and @a record is left unchanged for the caller to write.
+ */
+bool LogWriter::Enqueue(LogRecord &record)
+{
+    if (_stopping)
+        return false;
+
+    quint64 pos = _enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    for (;;)
+    {
+        slot = &_slots[pos & (_capacity - 1)];
+        const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence == pos)
+        {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (sequence < pos)
+        {
+            //the writer has not yet emptied this slot
+            _wake.wakeOne();
+            return false;
+        }
+        else
+        {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->record = std::move(record);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    //do not let the queue approach its bound before the next timed flush
+    if (pos - _dequeuePos.load(std::memory_order_relaxed) > _capacity / 2)
+        _wake.wakeOne();
+    return true;
+}
+
+/**
+ * @brief LogWriter::Flush
+ * @param timeout
+ * @return @c True when every record enqueued before the call has
+ * been written to the database.
+ *
+ * Blocks until the records are written, for at most @a timeout
+ * milliseconds when it is not negative. Returns early while the
+ * writer is suspended.
+ */
+bool LogWriter::Flush(int timeout)
+{
+    if (QThread::currentThread() == this)
+        return false;
+
+    const quint64 target = _enqueuePos.load(std::memory_order_acquire);
+    QElapsedTimer timer;
+    timer.start();
+    QMutexLocker locker(&_mutex);
+    while (_writtenPos.load() < target && _suspended == 0 && isRunning() && (timeout < 0 || timer.elapsed() < timeout))
+    {
+        _wake.wakeOne();
+        _progress.wait(&_mutex, 100);
+    }
+    return _writtenPos.load() >= target;
+}
+
+/**
+ * @brief LogWriter::Suspend
+ *
+ * Writes the queued records and closes the writer's connection so
+ * that the database file can be replaced. Records that cannot be
+ * written within the SQLite busy timeout, and records enqueued while
+ * suspended, are kept until Resume().
+ */
+void LogWriter::Suspend()
+{
+    if (QThread::currentThread() == this)
+        return;
+
+    Flush(30000);
+    QMutexLocker locker(&_mutex);
+    _suspended++;
+    _wake.wakeOne();
+    while (!_released && isRunning())
+        _progress.wait(&_mutex, 100);
+}
+
+/**
+ * @brief LogWriter::Resume
+ *
+ * Ends a Suspend().
+ */
+void LogWriter::Resume()
+{
+    QMutexLocker locker(&_mutex);
+    if (_suspended > 0)
+        _suspended--;
+    _wake.wakeOne();
+}
+
+/**
+ * @brief LogWriter::Stop
+ *
+ * Writes the queued records and ends the thread. Later records are
+ * written synchronously by DbManager::Log().
+ */
+void LogWriter::Stop()
+{
+    if (QThread::currentThread() == this)
+        return;
+
+    {
+        QMutexLocker locker(&_mutex);
+        _stopping = true;
+        _wake.wakeOne();
+    }
+    wait();
+}
+
+/**
+ * @brief LogWriter::Batches
+ * @return The number of transactions used to write the records.
+ */
+quint64 LogWriter::Batches() const
+{
+    return _batches;
+}
+
+/**
+ * @brief LogWriter::Retries
+ * @return The number of times a batch could not be written and was
+ * retried.
+ */
+quint64 LogWriter::Retries() const
+{
+    return _retries;
+}
+
+/**
+ * @brief LogWriter::Unwritten
+ * @return The number of records sent to the message log because the
+ * database could not be written when the writer stopped.
+ */
+quint64 LogWriter::Unwritten() const
+{
+    return _unwritten;
+}
+
+/**
+ * @brief LogWriter::Written
+ * @return The number of records taken from the queue and written.
+ */
+quint64 LogWriter::Written() const
+{
+    return _writtenPos - _unwritten;
+}
+
+/**
+ * @brief LogWriter::run
+ *
+ * The writer loop. Records are written when the queue has grown,
+ * when a flush is requested, or every quarter second.
+ */
+void LogWriter::run()
+{
+    //producers wait on the writer; it must not wait for a connection
+    DbConnections::Exempt();
+
+    //creates (or upgrades) this thread's connection
+    {
+        DbManager db;
+        Q_UNUSED(db)
+    }
+
+    QVector<LogRecord> batch;
+    batch.reserve(_maxBatch);
+    unsigned long retryDelay = 0;
+    int failuresWhileStopping = 0;
+    for (;;)
+    {
+        {
+            QMutexLocker locker(&_mutex);
+            if (batch.isEmpty() && !HasPending() && !_stopping && _suspended == 0)
+                _wake.wait(&_mutex, 250);
+            if (_suspended > 0)
+            {
+                if (!_released)
+                {
+                    locker.unlock();
+                    ReleaseConnection();
+                    locker.relock();
+                    _released = true;
+                    _progress.wakeAll();
+                }
+                if (_stopping)
+                    break;
+                _wake.wait(&_mutex, 250);
+                continue;
+            }
+            if (_stopping && batch.isEmpty() && !HasPending())
+                break;
+            _released = false;
+        }
+
+        LogRecord record;
+        while (batch.count() < _maxBatch && TryPop(record))
+            batch.append(std::move(record));
+
+        if (!batch.isEmpty())
+        {
+            if (DbManager::WriteLog(batch))
+            {
+                _batches++;
+                retryDelay = 0;
+                batch.clear();
+            }
+            else if (_stopping && ++failuresWhileStopping >= 3)
+            {
+                //the application is exiting and the database cannot be written
+                for (const LogRecord &record : std::as_const(batch))
+                    qCritical().noquote() << "Unable to write log record:" << record.when << record.severity << record.location << record.user << record.message;
+                _unwritten += static_cast<quint64>(batch.count());
+                batch.clear();
+            }
+            else
+            {
+                //keep the batch; the write lock is usually held by a long transaction
+                _retries++;
+                retryDelay = std::min<unsigned long>(retryDelay == 0 ? 100 : retryDelay * 2, 2000);
+                QThread::msleep(retryDelay);
+            }
+        }
+
+        if (batch.isEmpty())
+        {
+            _writtenPos.store(_dequeuePos.load());
+            QMutexLocker locker(&_mutex);
+            _progress.wakeAll();
+        }
+    }
+
+    DbConnections::Release();
+    QMutexLocker locker(&_mutex);
+    _progress.wakeAll();
+}
+
+/**
+ * @brief LogWriter::HasPending
+ * @return @c True when a producer has claimed a slot the writer has
+ * not yet taken.
+ */
+bool LogWriter::HasPending() const
+{
+    return _dequeuePos.load(std::memory_order_relaxed) != _enqueuePos.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief LogWriter::TryPop
+ * @param record
+ * @return @c True when the oldest record has been moved to
+ * @a record. Only the writer thread calls this.
+ */
+bool LogWriter::TryPop(LogRecord &record)
+{
+    const quint64 pos = _dequeuePos.load(std::memory_order_relaxed);
+    Slot &slot = _slots[pos & (_capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+        return false; //empty, or the producer is still filling the slot
+
+    record = std::move(slot.record);
+    slot.record = LogRecord();
+    slot.sequence.store(pos + _capacity, std::memory_order_release);
+    _dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief LogWriter::ReleaseConnection
+ *
+ * Closes the writer's connection. DbManager reopens it for the next
+ * batch.
+ */
+void LogWriter::ReleaseConnection()
+{
+    QSqlDatabase db = QSqlDatabase::database(QString::number(reinterpret_cast<quint64>(QThread::currentThreadId())), false);
+    if (db.isOpen())
+        DbConnections::Close(db);
+}
@@ -0,0 +1,91 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include <atomic>
+#include <memory>
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+struct LogRecord
+{
+    QString when;
+    int severity{0};
+    QString location;
+    QString message;
+    QString user;
+};
+
+class LogWriter : public QThread
+{
+public:
+    LogWriter(const LogWriter &right) = delete;
+    LogWriter& operator=(const LogWriter &right) = delete;
+
+    static LogWriter* Instance();
+
+    bool Enqueue(LogRecord &record);
+    bool Flush(int timeout = -1);
+    void Suspend();
+    void Resume();
+    void Stop();
+
+    [[nodiscard]] quint64 Batches() const;
+    [[nodiscard]] quint64 Retries() const;
+    [[nodiscard]] quint64 Unwritten() const;
+    [[nodiscard]] quint64 Written() const;
+
+protected:
+    void run() override;
+
+private:
+    explicit LogWriter();
+    struct Slot
+    {
+        std::atomic<quint64> sequence;
+        LogRecord record;
+    };
+    bool HasPending() const;
+    bool TryPop(LogRecord &record);
+    void ReleaseConnection();
+    static constexpr quint64 _capacity = 4096; //must be a power of 2
+    static constexpr int _maxBatch = 512;
+    std::unique_ptr<Slot[]> _slots;
+    alignas(64) std::atomic<quint64> _enqueuePos{0};
+    alignas(64) std::atomic<quint64> _dequeuePos{0};
+    std::atomic<quint64> _writtenPos{0};
+    std::atomic<quint64> _batches{0};
+    std::atomic<quint64> _retries{0};
+    std::atomic<quint64> _unwritten{0};
+    std::atomic<bool> _stopping{false};
+    //guards sleeping and suspension only; the queue itself is lock-free
+    QMutex _mutex;
+    QWaitCondition _wake;
+    QWaitCondition _progress;
+    int _suspended{0};
+    bool _released{true};
+};
+
+#endif // LOGWRITER_H
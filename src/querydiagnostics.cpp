@@ -0,0 +1,183 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "dbmanager.h"
+#include "querydiagnostics.h"
+#include "querystats.h"
+
+#include "ui_querydiagnostics.h"
+
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSaveFile>
+
+/**
+ * @class QueryDiagnostics
+ * @brief Displays the @a QueryStats of the running process: the
+ * statements each thread executed and the slow-query log.
+ *
+ * Available from the Help menu when built with CONFIG+=query_stats.
+ */
+
+namespace {
+    QTableWidgetItem *NumberItem(double value)
+    {
+        auto *ret = new QTableWidgetItem(); //memory managed by the table
+        ret->setData(Qt::DisplayRole, value);
+        return ret;
+    }
+}
+
+/**
+ * @brief QueryDiagnostics::QueryDiagnostics
+ * @param parent
+ *
+ * Main constructor.
+ */
+QueryDiagnostics::QueryDiagnostics(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::QueryDiagnostics)
+{
+    ui->setupUi(this);
+    this->setWindowTitle(QStringLiteral("Query Diagnostics"));
+    ui->spnThreshold->blockSignals(true);
+    ui->spnThreshold->setValue(QueryStats::Threshold());
+    ui->spnThreshold->blockSignals(false);
+    Refresh();
+}
+
+/**
+ * @brief QueryDiagnostics::~QueryDiagnostics
+ *
+ * Destructor.
+ */
+QueryDiagnostics::~QueryDiagnostics()
+{
+    delete ui;
+}
+
+/**
+ * @brief QueryDiagnostics::Refresh
+ *
+ * Shows the statistics gathered so far.
+ */
+void QueryDiagnostics::Refresh()
+{
+    const QJsonObject stats = QueryStats::ToJson();
+
+    QStringList buckets;
+    for (const auto &bound : stats.value(QStringLiteral("histogramBucketsMs")).toArray())
+        buckets.append("≤" + QString::number(bound.toDouble()) + " ms");
+    buckets.append(QStringLiteral("slower"));
+
+    ui->tblStatements->setSortingEnabled(false);
+    ui->tblStatements->setRowCount(0);
+    for (const auto &threadValue : stats.value(QStringLiteral("threads")).toArray())
+    {
+        const QJsonObject thread = threadValue.toObject();
+        for (const auto &statementValue : thread.value(QStringLiteral("statements")).toArray())
+        {
+            const QJsonObject statement = statementValue.toObject();
+            QStringList histogram;
+            const QJsonArray counts = statement.value(QStringLiteral("histogram")).toArray();
+            for (int i = 0; i < counts.count() && i < buckets.count(); i++)
+            {
+                if (counts.at(i).toDouble() > 0)
+                    histogram.append(buckets.at(i) + ": " + QString::number(counts.at(i).toDouble()));
+            }
+
+            const int row = ui->tblStatements->rowCount();
+            ui->tblStatements->insertRow(row);
+            ui->tblStatements->setItem(row, 0, new QTableWidgetItem(thread.value(QStringLiteral("thread")).toString()));
+            ui->tblStatements->setItem(row, 1, NumberItem(statement.value(QStringLiteral("executions")).toDouble()));
+            ui->tblStatements->setItem(row, 2, NumberItem(statement.value(QStringLiteral("rows")).toDouble()));
+            ui->tblStatements->setItem(row, 3, NumberItem(statement.value(QStringLiteral("totalMs")).toDouble()));
+            ui->tblStatements->setItem(row, 4, NumberItem(statement.value(QStringLiteral("meanMs")).toDouble()));
+            ui->tblStatements->setItem(row, 5, NumberItem(statement.value(QStringLiteral("maxMs")).toDouble()));
+            ui->tblStatements->setItem(row, 6, new QTableWidgetItem(histogram.join(QStringLiteral(", "))));
+            ui->tblStatements->setItem(row, 7, new QTableWidgetItem(statement.value(QStringLiteral("sql")).toString()));
+        }
+    }
+    ui->tblStatements->setSortingEnabled(true);
+    ui->tblStatements->sortItems(3, Qt::DescendingOrder);
+
+    ui->tblSlow->setRowCount(0);
+    for (const auto &slowValue : stats.value(QStringLiteral("slowQueries")).toArray())
+    {
+        const QJsonObject slow = slowValue.toObject();
+        QStringList plan;
+        for (const auto &step : slow.value(QStringLiteral("plan")).toArray())
+            plan.append(step.toString());
+
+        const int row = ui->tblSlow->rowCount();
+        ui->tblSlow->insertRow(row);
+        ui->tblSlow->setItem(row, 0, new QTableWidgetItem(slow.value(QStringLiteral("when")).toString()));
+        ui->tblSlow->setItem(row, 1, new QTableWidgetItem(slow.value(QStringLiteral("thread")).toString()));
+        ui->tblSlow->setItem(row, 2, NumberItem(slow.value(QStringLiteral("ms")).toDouble()));
+        ui->tblSlow->setItem(row, 3, NumberItem(slow.value(QStringLiteral("rows")).toDouble()));
+        ui->tblSlow->setItem(row, 4, new QTableWidgetItem(plan.join(QStringLiteral("; "))));
+        ui->tblSlow->setItem(row, 5, new QTableWidgetItem(slow.value(QStringLiteral("sql")).toString()));
+    }
+}
+
+/**
+ * @brief QueryDiagnostics::Reset
+ *
+ * Discards the statistics gathered so far.
+ */
+void QueryDiagnostics::Reset()
+{
+    QueryStats::Reset();
+    Refresh();
+}
+
+/**
+ * @brief QueryDiagnostics::SaveJson
+ * @param fileName
+ *
+ * Writes QueryStats::Dump() to a file chosen by the user.
+ */
+void QueryDiagnostics::SaveJson(const QString &fileName)
+{
+    DbManager db;
+    QString fn = !fileName.isEmpty() ? fileName : QFileDialog::getSaveFileName(this,
+        QStringLiteral("Save Query Statistics"), db.GetVariable(QStringLiteral("lastdir")), QStringLiteral("JSON (*.json)"));
+
+    if (fn.isNull() || fn.isEmpty())
+        return;
+
+    db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fn).absolutePath());
+    QSaveFile file(fn);
+    if (!file.open(QFile::WriteOnly) || file.write(QueryStats::Dump()) < 0 || !file.commit())
+        Warning(QStringLiteral("Unable to Save Statistics"), "The query statistics could not be written to " + fn + ".");
+}
+
+/**
+ * @brief QueryDiagnostics::ThresholdChanged
+ * @param msecs
+ *
+ * Sets the slow-query threshold.
+ */
+void QueryDiagnostics::ThresholdChanged(int msecs)
+{
+    QueryStats::SetThreshold(msecs);
+}
@@ -0,0 +1,47 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUERYDIAGNOSTICS_H
+#define QUERYDIAGNOSTICS_H
+
+#include <QWidget>
+
+namespace Ui {
+class QueryDiagnostics;
+}
+
+class QueryDiagnostics : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit QueryDiagnostics(QWidget *parent = nullptr);
+    ~QueryDiagnostics();
+
+private Q_SLOTS:
+    void Refresh();
+    void Reset();
+    void SaveJson(const QString &fileName = QString());
+    void ThresholdChanged(int msecs);
+
+private:
+    Ui::QueryDiagnostics *ui;
+};
+
+#endif // QUERYDIAGNOSTICS_H
@@ -0,0 +1,361 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "querystats.h"
+
+#ifdef STIGQTER_QUERY_STATS
+
+#include "dbmanager.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+/**
+ * @class QueryStats
+ * @brief Timing of the statements executed through @a DbQuery.
+ *
+ * Built only when qmake is run with CONFIG+=query_stats, which
+ * defines STIGQTER_QUERY_STATS. Without it, @a DbQuery calls
+ * QSqlQuery::exec() and QSqlQuery::next() directly.
+ *
+ * Each thread aggregates its own statements (executions, rows,
+ * bound parameters, and a latency histogram), so recording does not
+ * contend with the other workers. When a thread exits, its
+ * statistics are merged into a single "finished threads" entry. A
+ * statement slower than
+ * Threshold() is also kept with its EXPLAIN QUERY PLAN output, so
+ * that a slow report run can be traced to the query and the missing
+ * index.
+ */
+
+namespace {
+    //upper bounds of the histogram buckets, in microseconds; the last bucket is unbounded
+    constexpr std::array<qint64, 9> bucketBounds = {100, 500, 1000, 5000, 10000, 50000, 100000, 500000, 1000000};
+    constexpr int maxSlowQueries = 200;
+
+    struct StatementStats
+    {
+        int parameters{0};
+        quint64 executions{0};
+        qint64 rows{0};
+        qint64 totalNsecs{0};
+        qint64 maxNsecs{0};
+        std::array<quint64, bucketBounds.size() + 1> histogram{};
+    };
+
+    struct ThreadStats
+    {
+        QString thread;
+        QMutex mutex; //only contended while the statistics are read
+        QHash<QString, StatementStats> statements;
+    };
+
+    struct SlowQuery
+    {
+        QString thread;
+        QString when;
+        QString sql;
+        int parameters;
+        qint64 rows;
+        qint64 nsecs;
+        QStringList plan;
+    };
+
+    QMutex registryMutex;
+    //the running threads; each is merged into retiredStats when it exits
+    std::vector<ThreadStats *> registry;
+    ThreadStats retiredStats;
+    QVector<SlowQuery> slowQueries;
+    std::atomic<qint64> thresholdNsecs{100 * 1000000LL};
+
+    QString ThreadName()
+    {
+        QThread *thread = QThread::currentThread();
+        if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+            return QStringLiteral("main");
+        if (!thread->objectName().isEmpty())
+            return thread->objectName();
+        return QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()));
+    }
+
+    void Merge(StatementStats &into, const StatementStats &from)
+    {
+        into.parameters = from.parameters;
+        into.executions += from.executions;
+        into.rows += from.rows;
+        into.totalNsecs += from.totalNsecs;
+        into.maxNsecs = std::max(into.maxNsecs, from.maxNsecs);
+        for (size_t i = 0; i < into.histogram.size(); i++)
+            into.histogram[i] += from.histogram[i];
+    }
+
+    /**
+     * @brief The LocalThreadStats class registers the statistics of
+     * the thread that owns it. When the thread exits, they are merged
+     * into retiredStats, so the registry only holds running threads.
+     */
+    class LocalThreadStats
+    {
+    public:
+        LocalThreadStats()
+        {
+            stats.thread = ThreadName();
+            QMutexLocker locker(&registryMutex);
+            registry.push_back(&stats);
+        }
+
+        ~LocalThreadStats()
+        {
+            QMutexLocker locker(&registryMutex);
+            registry.erase(std::remove(registry.begin(), registry.end(), &stats), registry.end());
+            QMutexLocker retiredLocker(&retiredStats.mutex);
+            for (auto it = stats.statements.cbegin(); it != stats.statements.cend(); ++it)
+                Merge(retiredStats.statements[it.key()], it.value());
+        }
+
+        LocalThreadStats(const LocalThreadStats&) = delete;
+        LocalThreadStats &operator=(const LocalThreadStats&) = delete;
+
+        ThreadStats stats;
+    };
+
+    ThreadStats &LocalStats()
+    {
+        thread_local LocalThreadStats local;
+        return local.stats;
+    }
+
+    /**
+     * @brief Plan
+     * @param db
+     * @param query
+     * @return SQLite's EXPLAIN QUERY PLAN output for the statement
+     * @a query last executed, with its bound values substituted.
+     *
+     * A plain @a QSqlQuery is used so that explaining a slow query
+     * is not itself recorded.
+     */
+    QStringList Plan(const QSqlDatabase &db, const QSqlQuery &query)
+    {
+        QStringList ret;
+        QSqlQuery q(db);
+        if (q.exec("EXPLAIN QUERY PLAN " + GetLastExecutedQuery(query)))
+        {
+            while (q.next())
+                ret.append(q.value(3).toString());
+        }
+        return ret;
+    }
+
+    double Milliseconds(qint64 nsecs)
+    {
+        return static_cast<double>(nsecs) / 1000000.0;
+    }
+
+    /**
+     * @brief ThreadJson
+     * @param name
+     * @param statements
+     * @return The @a statements of thread @a name, ordered by their
+     * total time.
+     */
+    QJsonObject ThreadJson(const QString &name, const QHash<QString, StatementStats> &statements)
+    {
+        QVector<QString> order;
+        order.reserve(statements.count());
+        for (auto it = statements.cbegin(); it != statements.cend(); ++it)
+            order.append(it.key());
+        std::sort(order.begin(), order.end(), [&statements](const QString &a, const QString &b) {
+            return statements.value(a).totalNsecs > statements.value(b).totalNsecs;
+        });
+
+        QJsonArray ret;
+        for (const QString &sql : order)
+        {
+            const StatementStats &stats = *statements.constFind(sql);
+            QJsonArray histogram;
+            for (quint64 count : stats.histogram)
+                histogram.append(static_cast<double>(count));
+            QJsonObject statement;
+            statement.insert(QStringLiteral("sql"), sql);
+            statement.insert(QStringLiteral("executions"), static_cast<double>(stats.executions));
+            statement.insert(QStringLiteral("parameters"), stats.parameters);
+            statement.insert(QStringLiteral("rows"), static_cast<double>(stats.rows));
+            statement.insert(QStringLiteral("totalMs"), Milliseconds(stats.totalNsecs));
+            statement.insert(QStringLiteral("meanMs"), Milliseconds(stats.totalNsecs) / static_cast<double>(stats.executions));
+            statement.insert(QStringLiteral("maxMs"), Milliseconds(stats.maxNsecs));
+            statement.insert(QStringLiteral("histogram"), histogram);
+            ret.append(statement);
+        }
+        QJsonObject thread;
+        thread.insert(QStringLiteral("thread"), name);
+        thread.insert(QStringLiteral("statements"), ret);
+        return thread;
+    }
+}
+
+/**
+ * @brief QueryStats::Record
+ * @param db
+ * @param query
+ * @param sql
+ * @param parameters
+ * @param rows
+ * @param nsecs
+ *
+ * Adds one execution of the prepared @a sql to this thread's
+ * statistics: the number of bound @a parameters, the @a rows read
+ * (or changed), and the @a nsecs spent executing the statement and
+ * stepping through its results.
+ */
+void QueryStats::Record(const QSqlDatabase &db, const QSqlQuery &query, const QString &sql, int parameters, qint64 rows, qint64 nsecs)
+{
+    ThreadStats &local = LocalStats();
+    {
+        QMutexLocker locker(&local.mutex);
+        StatementStats &stats = local.statements[sql];
+        stats.parameters = parameters;
+        stats.executions++;
+        stats.rows += rows;
+        stats.totalNsecs += nsecs;
+        stats.maxNsecs = std::max(stats.maxNsecs, nsecs);
+        const auto bucket = std::lower_bound(bucketBounds.cbegin(), bucketBounds.cend(), nsecs / 1000);
+        stats.histogram[static_cast<size_t>(bucket - bucketBounds.cbegin())]++;
+    }
+
+    if (nsecs >= thresholdNsecs)
+    {
+        const QDateTime now = QDateTime::currentDateTime();
+        SlowQuery slow{local.thread, now.toOffsetFromUtc(now.offsetFromUtc()).toString(Qt::ISODate), sql, parameters, rows, nsecs, Plan(db, query)};
+        QMutexLocker locker(&registryMutex);
+        if (slowQueries.count() >= maxSlowQueries)
+            slowQueries.removeFirst();
+        slowQueries.append(std::move(slow));
+    }
+}
+
+/**
+ * @brief QueryStats::SetThreshold
+ * @param msecs
+ *
+ * Statements that take at least @a msecs milliseconds are logged
+ * with their query plan. The default is 100 ms.
+ */
+void QueryStats::SetThreshold(int msecs)
+{
+    thresholdNsecs = static_cast<qint64>(msecs) * 1000000LL;
+}
+
+/**
+ * @brief QueryStats::Threshold
+ * @return The slow-query threshold in milliseconds.
+ */
+int QueryStats::Threshold()
+{
+    return static_cast<int>(thresholdNsecs / 1000000LL);
+}
+
+/**
+ * @brief QueryStats::Reset
+ *
+ * Discards the statistics gathered so far.
+ */
+void QueryStats::Reset()
+{
+    QMutexLocker locker(&registryMutex);
+    for (ThreadStats *stats : registry)
+    {
+        QMutexLocker statsLocker(&stats->mutex);
+        stats->statements.clear();
+    }
+    QMutexLocker retiredLocker(&retiredStats.mutex);
+    retiredStats.statements.clear();
+    slowQueries.clear();
+}
+
+/**
+ * @brief QueryStats::ToJson
+ * @return The statistics of each running thread and of the finished
+ * threads together (statements ordered by their total time), and
+ * the slow-query log.
+ */
+QJsonObject QueryStats::ToJson()
+{
+    QJsonObject ret;
+    ret.insert(QStringLiteral("thresholdMs"), Threshold());
+
+    QJsonArray buckets;
+    for (qint64 bound : bucketBounds)
+        buckets.append(static_cast<double>(bound) / 1000.0);
+    ret.insert(QStringLiteral("histogramBucketsMs"), buckets);
+
+    QMutexLocker locker(&registryMutex);
+    QJsonArray threads;
+    for (ThreadStats *local : registry)
+    {
+        QMutexLocker statsLocker(&local->mutex);
+        if (!local->statements.isEmpty())
+            threads.append(ThreadJson(local->thread, local->statements));
+    }
+    {
+        QMutexLocker retiredLocker(&retiredStats.mutex);
+        if (!retiredStats.statements.isEmpty())
+            threads.append(ThreadJson(QStringLiteral("finished threads"), retiredStats.statements));
+    }
+    ret.insert(QStringLiteral("threads"), threads);
+
+    QJsonArray slow;
+    for (const SlowQuery &query : std::as_const(slowQueries))
+    {
+        QJsonObject entry;
+        entry.insert(QStringLiteral("thread"), query.thread);
+        entry.insert(QStringLiteral("when"), query.when);
+        entry.insert(QStringLiteral("sql"), query.sql);
+        entry.insert(QStringLiteral("parameters"), query.parameters);
+        entry.insert(QStringLiteral("rows"), static_cast<double>(query.rows));
+        entry.insert(QStringLiteral("ms"), Milliseconds(query.nsecs));
+        entry.insert(QStringLiteral("plan"), QJsonArray::fromStringList(query.plan));
+        slow.append(entry);
+    }
+    ret.insert(QStringLiteral("slowQueries"), slow);
+    return ret;
+}
+
+/**
+ * @brief QueryStats::Dump
+ * @return ToJson() as an indented JSON document.
+ */
+QByteArray QueryStats::Dump()
+{
+    return QJsonDocument(ToJson()).toJson(QJsonDocument::Indented);
+}
+
+#endif // STIGQTER_QUERY_STATS
@@ -0,0 +1,46 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUERYSTATS_H
+#define QUERYSTATS_H
+
+#ifdef STIGQTER_QUERY_STATS
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+
+class QueryStats
+{
+public:
+    static void Record(const QSqlDatabase &db, const QSqlQuery &query, const QString &sql, int parameters, qint64 rows, qint64 nsecs);
+
+    static void SetThreshold(int msecs);
+    [[nodiscard]] static int Threshold();
+    static void Reset();
+
+    [[nodiscard]] static QJsonObject ToJson();
+    [[nodiscard]] static QByteArray Dump();
+};
+
+#endif // STIGQTER_QUERY_STATS
+
+#endif // QUERYSTATS_H
@@ -49,11 +49,10 @@
 
 /**
  * @brief STIG::STIG
- * @param parent
  *
  * Default constructor.
  */
-STIG::STIG(QObject *parent) : QObject(parent),
+STIG::STIG() :
     id(-1),
     title(),
     description(),
@@ -74,6 +73,17 @@ QVector<STIGCheck> STIG::GetSTIGChecks() const
     return db.GetSTIGChecks(*this);
 }
 
+/**
+ * @brief STIG::GetSTIGCheckHeaders
+ * @return The identifying fields of the @a STIGChecks associated
+ * with this @a STIG, without their text.
+ */
+QVector<STIGCheckHeader> STIG::GetSTIGCheckHeaders() const
+{
+    DbManager db;
+    return db.GetSTIGCheckHeaders(*this);
+}
+
 /**
  * @brief STIG::GetSupplements
  * @return The list of @a Supplements associated with this @a STIG.
@@ -94,39 +104,6 @@ QVector<Asset> STIG::GetAssets() const
     return db.GetAssets(*this);
 }
 
-/**
- * @brief STIG::STIG
- * @param right
- *
- * Copy constructor.
- */
-STIG::STIG(const STIG &right) : STIG(right.parent())
-{
-    *this = right;
-}
-
-/**
- * @brief STIG::operator=
- * @param right
- * @return This @a STIG, copied from the assignee.
- *
- * Deep copy assignment operator.
- */
-STIG &STIG::operator=(const STIG &right)
-{
-    if (this != &right)
-    {
-        id = right.id;
-        title = right.title;
-        description = right.description;
-        release = right.release;
-        version = right.version;
-        benchmarkId = right.benchmarkId;
-        fileName = right.fileName;
-    }
-    return *this;
-}
-
 /**
  * @brief STIG::operator==
  * @param right
@@ -21,20 +21,19 @@
 #define STIG_H
 
 #include <QList>
-#include <QObject>
+#include <QMetaType>
 #include <QString>
+#include <QVector>
 
 class STIGCheck;
+struct STIGCheckHeader;
 class Asset;
 class Supplement;
 
-class STIG : public QObject
+class STIG
 {
-    Q_OBJECT
 public:
-    STIG(const STIG &right);
-    explicit STIG(QObject *parent = nullptr);
-    ~STIG() override = default;
+    STIG();
 
     int id;
     QString title;
@@ -45,14 +44,15 @@ public:
     QString fileName;
     QVector<Asset> GetAssets() const;
     QVector<STIGCheck> GetSTIGChecks() const;
+    QVector<STIGCheckHeader> GetSTIGCheckHeaders() const;
     QVector<Supplement> GetSupplements() const;
-    STIG& operator=(const STIG &right);
     bool operator<(const STIG &right) const;
 };
 
 bool operator==(STIG const& lhs, STIG const& rhs);
 bool operator!=(STIG const& lhs, STIG const& rhs);
 
+Q_DECLARE_TYPEINFO(STIG, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(STIG);
 
 [[nodiscard]] QString PrintSTIG(const STIG &stig);
@@ -63,12 +63,11 @@
 
 /**
  * @brief STIGCheck::STIGCheck
- * @param parent
  *
  * Default constructor. An ID of -1 is used to represent a
  * @a STIGCheck that is detached from the database or incomplete.
  */
-STIGCheck::STIGCheck(QObject *parent) : QObject(parent),
+STIGCheck::STIGCheck() :
     id(-1),
     stigId(-1),
     vulnNum(),
@@ -99,59 +98,6 @@ STIGCheck::STIGCheck(QObject *parent) : QObject(parent),
     legacyIds.clear();
 }
 
-/**
- * @brief STIGCheck::STIGCheck
- * @param right
- *
- * Copy constructor.
- */
-STIGCheck::STIGCheck(const STIGCheck &right) : STIGCheck(right.parent())
-{
-    *this = right;
-}
-
-/**
- * @brief STIGCheck::operator =
- * @param right
- * @return This @a STIGCheck, copied from the assignee.
- *
- * Deep copy assignment operator.
- */
-STIGCheck& STIGCheck::operator=(const STIGCheck &right)
-{
-    if (this != &right)
-    {
-        id = right.id;
-        stigId = right.stigId;
-        cciIds = right.cciIds;
-        legacyIds = right.legacyIds;
-        rule = right.rule;
-        vulnNum = right.vulnNum;
-        groupTitle = right.groupTitle;
-        ruleVersion = right.ruleVersion;
-        severity = right.severity;
-        weight = right.weight;
-        title = right.title;
-        vulnDiscussion = right.vulnDiscussion;
-        falsePositives = right.falsePositives;
-        falseNegatives = right.falseNegatives;
-        fix = right.fix;
-        check = right.check;
-        documentable = right.documentable;
-        mitigations = right.mitigations;
-        severityOverrideGuidance = right.severityOverrideGuidance;
-        checkContentRef = right.checkContentRef;
-        potentialImpact = right.potentialImpact;
-        thirdPartyTools = right.thirdPartyTools;
-        mitigationControl = right.mitigationControl;
-        responsibility = right.responsibility;
-        iaControls = right.iaControls;
-        targetKey = right.targetKey;
-        isRemap = right.isRemap;
-    }
-    return *this;
-}
-
 /**
  * @brief STIGCheck::GetSTIG
  * @return The @a STIG associated with this @a STIGCheck.
@@ -237,6 +183,18 @@ bool operator==(STIGCheck const& lhs, STIGCheck const& rhs)
     return stigCheck.rule;
 }
 
+/**
+ * @overload PrintSTIGCheck(const STIGCheckHeader &header)
+ * @brief PrintSTIGCheck
+ * @param header
+ * @return Human-readable printout of the @a STIGCheck, the same as
+ * PrintSTIGCheck() of the full check.
+ */
+[[nodiscard]] QString PrintSTIGCheck(const STIGCheckHeader &header)
+{
+    return header.rule;
+}
+
 /**
  * @brief PrintCMRSVulnId
  * @param stigCheck
@@ -23,8 +23,9 @@
 #include "cci.h"
 #include "stig.h"
 
-#include <QObject>
+#include <QMetaType>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
 enum Severity
@@ -38,14 +39,10 @@ enum Severity
 Severity GetSeverity(const QString &severity);
 QString GetSeverity(Severity severity, bool cat = true); //cat levels or low/mod/high
 
-class STIGCheck : public QObject
+class STIGCheck
 {
-    Q_OBJECT
 public:
-    STIGCheck(const STIGCheck& right);
-    explicit STIGCheck(QObject *parent = nullptr);
-    ~STIGCheck() override = default;
-    STIGCheck& operator=(const STIGCheck &right);
+    STIGCheck();
 
     int id;
     int stigId;
@@ -80,9 +77,25 @@ public:
 
 bool operator==(STIGCheck const& lhs, STIGCheck const& rhs);
 
+Q_DECLARE_TYPEINFO(STIGCheck, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(STIGCheck);
 
+struct STIGCheckHeader
+{
+    int id{-1};
+    int stigId{-1};
+    QString rule;
+    QString ruleVersion;
+    QString vulnNum;
+    QString title;
+    Severity severity{Severity::high};
+};
+
+Q_DECLARE_TYPEINFO(STIGCheckHeader, Q_MOVABLE_TYPE);
+Q_DECLARE_METATYPE(STIGCheckHeader);
+
 [[nodiscard]] QString PrintSTIGCheck(const STIGCheck &stigCheck);
+[[nodiscard]] QString PrintSTIGCheck(const STIGCheckHeader &header);
 
 [[nodiscard]] QString PrintCMRSVulnId(const STIGCheck &stigCheck);
 
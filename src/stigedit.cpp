@@ -138,10 +138,11 @@ void STIGEdit::RunTests()
 void STIGEdit::UpdateChecks()
 {
     ui->lstChecks->clear();
-    for (auto sc : _s.GetSTIGChecks())
+    //the list only needs the rules; the full check is read when it is selected
+    for (const STIGCheckHeader &sc : _s.GetSTIGCheckHeaders())
     {
         auto *tmpItem = new QListWidgetItem(); //memory managed by ui->lstChecks container
-        tmpItem->setData(Qt::UserRole, QVariant::fromValue<STIGCheck>(sc));
+        tmpItem->setData(Qt::UserRole, QVariant::fromValue<STIGCheckHeader>(sc));
         tmpItem->setText(PrintSTIGCheck(sc));
         ui->lstChecks->addItem(tmpItem);
     }
@@ -197,9 +198,10 @@ void STIGEdit::AddCCI()
  */
 void STIGEdit::SelectCheck()
 {
+    DbManager db;
     for (QListWidgetItem *i : ui->lstChecks->selectedItems())
     {
-        auto sc = i->data(Qt::UserRole).value<STIGCheck>();
+        STIGCheck sc = db.GetSTIGCheck(i->data(Qt::UserRole).value<STIGCheckHeader>().id);
         ui->txtCheckRule->setText(sc.rule);
         ui->txtCheckRuleVersion->setText(sc.ruleVersion);
         ui->txtCheckTitle->setText(sc.title);
@@ -250,7 +252,7 @@ void STIGEdit::UpdateCheck()
     DbManager db;
     for (QListWidgetItem *i : ui->lstChecks->selectedItems())
     {
-        auto sc = i->data(Qt::UserRole).value<STIGCheck>();
+        STIGCheck sc = db.GetSTIGCheck(i->data(Qt::UserRole).value<STIGCheckHeader>().id);
         sc.rule = ui->txtCheckRule->text();
         sc.ruleVersion = ui->txtCheckRuleVersion->text();
         sc.title = ui->txtCheckTitle->text();
@@ -20,6 +20,9 @@
 #include "assetview.h"
 #include "common.h"
 #include "help.h"
+#ifdef STIGQTER_QUERY_STATS
+#include "querydiagnostics.h"
+#endif
 #include "stigedit.h"
 #include "stigqter.h"
 #include "workerassetadd.h"
@@ -43,9 +46,9 @@
 #include "workercheckversion.h"
 #include "workerhtml.h"
 
-#include <QCryptographicHash>
 #include <QCloseEvent>
 #include <QFileDialog>
+#include <QHash>
 #include <QHostInfo>
 #include <QInputDialog>
 #include <QMessageBox>
@@ -90,7 +93,8 @@ STIGQter::STIGQter(QWidget *parent) :
     _updatedAssets(false),
     _updatedCCIs(false),
     _updatedSTIGs(false),
-    _isFiltered(false)
+    _isFiltered(false),
+    _isSearched(false)
 {
     //log software startup as required by SV-84041r1_rule
     Warning(QStringLiteral("System is Starting"), QHostInfo::localHostName(), true, 4);
@@ -109,6 +113,19 @@ STIGQter::STIGQter(QWidget *parent) :
     //set keyboard shortcuts
     _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_S), this, SLOT(Save())));
 
+    //the full-text search runs once the user stops typing (see Search())
+    _searchTimer.setSingleShot(true);
+    connect(&_searchTimer, SIGNAL(timeout()), this, SLOT(SearchHelper()));
+
+#ifdef STIGQTER_QUERY_STATS
+    //statement timings are only gathered in instrumented builds
+    connect(ui->menuHelp->addAction(QStringLiteral("&Query Diagnostics")), &QAction::triggered, this, []() {
+        auto *d = new QueryDiagnostics();
+        d->setAttribute(Qt::WA_DeleteOnClose); //clean up after itself (no explicit "delete" needed)
+        d->show();
+    });
+#endif
+
     //display path to database file
     DbManager db;
     ui->lblDBLoc->setText(QStringLiteral("DB: ") + db.GetDBPath());
@@ -539,6 +556,29 @@ void STIGQter::POAMTemplateControl(const QString &fileName)
     POAMTemplate(fileName, false);
 }
 
+/**
+ * @brief STIGQter::RebuildSummary
+ *
+ * Checks the compliance summary behind the checklist counts against
+ * the checklists and rebuilds it.
+ */
+void STIGQter::RebuildSummary()
+{
+    DbManager db;
+    const int mismatched = db.CheckComplianceSummary();
+    if (db.RebuildComplianceSummary())
+    {
+        QString message = QStringLiteral("The compliance summary has been rebuilt.");
+        if (mismatched > 0)
+            message = "The compliance summary had " + QString::number(mismatched) + " incorrect count" + Pluralize(mismatched) + " and has been rebuilt.";
+        QMessageBox::information(this, QStringLiteral("Compliance Summary"), message);
+    }
+    else
+    {
+        Warning(QStringLiteral("Compliance Summary"), QStringLiteral("The compliance summary could not be rebuilt."));
+    }
+}
+
 /**
  * @brief STIGQter::RemapChanged
  * @param checkState
@@ -609,12 +649,8 @@ bool STIGQter::Reset(bool checkOnly)
     else
     {
         //check if saved database is up-to-date
-        QFile dest(lastSaveLocation);
-        dest.open(QFile::ReadOnly);
-        QByteArray destHash = QCryptographicHash::hash(dest.readAll(), QCryptographicHash::Sha3_256);
-        dest.close();
         DbManager db;
-        if (destHash == db.HashDB())
+        if (db.GetSaveHash(lastSaveLocation) == db.HashDB(true))
         {
             //database was saved without changes; reset application.
             if (checkOnly)
@@ -658,7 +694,9 @@ void STIGQter::Save()
     if (!lastSaveLocation.isNull() && !lastSaveLocation.isEmpty())
     {
         DbManager db;
-        db.SaveDB(lastSaveLocation);
+        Initialize(1000);
+        db.SaveDB(lastSaveLocation, [this](qint64 done, qint64 total) { FileProgress(done, total); });
+        Progress(1000);
     }
 }
 
@@ -682,6 +720,92 @@ void STIGQter::SaveAs(const QString &fileName)
     }
 }
 
+/**
+ * @brief STIGQter::Search
+ * @param text
+ *
+ * Detects when the user has changed the search text and been idle
+ * for a while.
+ */
+void STIGQter::Search(const QString &text)
+{
+    Q_UNUSED(text)
+    //each search runs three full-text queries; wait for 3/10 of a second rather than searching on every keypress
+    _searchTimer.start(300);
+}
+
+/**
+ * @brief STIGQter::SearchHelper
+ *
+ * Narrow the STIG and Asset lists to those whose rule text or
+ * checklist answers contain the search text, best match first. The
+ * matching passage of the best hits is shown as the item's tool tip.
+ */
+void STIGQter::SearchHelper()
+{
+    const QString text = ui->txtSearch->text();
+    if (text.length() <= 2)
+    {
+        if (_isSearched)
+        {
+            _isSearched = false;
+            DisplaySTIGs(_isFiltered ? ui->txtSTIGSearch->text() : QString());
+            DisplayAssets();
+        }
+        return;
+    }
+    _isSearched = true;
+
+    DbManager db;
+    //every STIG and Asset with a hit is listed, best match first
+    const QVector<int> stigIds = db.SearchSTIGs(text);
+    const QVector<int> assetIds = db.SearchAssets(text);
+
+    //the best hits provide the tooltips
+    QHash<int, QString> stigSnippets;
+    QHash<int, QString> assetSnippets;
+    for (const SearchHit &hit : db.Search(text, 200))
+    {
+        if (!stigSnippets.contains(hit.stigId))
+            stigSnippets.insert(hit.stigId, hit.snippet);
+        if (hit.assetId >= 0 && !assetSnippets.contains(hit.assetId))
+            assetSnippets.insert(hit.assetId, hit.snippet);
+    }
+
+    QHash<int, STIG> stigs;
+    for (const STIG &s : db.GetSTIGs(stigIds))
+        stigs.insert(s.id, s);
+    QHash<int, Asset> assets;
+    for (const Asset &a : db.GetAssets(assetIds))
+        assets.insert(a.id, a);
+
+    ui->lstSTIGs->clear();
+    for (int id : stigIds)
+    {
+        if (!stigs.contains(id))
+            continue;
+        const STIG &s = stigs[id];
+        auto *tmpItem = new QListWidgetItem(); //memory managed by ui->lstSTIGs container
+        tmpItem->setData(Qt::UserRole, QVariant::fromValue<STIG>(s));
+        tmpItem->setText(PrintSTIG(s));
+        tmpItem->setToolTip(stigSnippets.value(s.id));
+        ui->lstSTIGs->addItem(tmpItem);
+    }
+
+    ui->lstAssets->clear();
+    for (int id : assetIds)
+    {
+        if (!assets.contains(id))
+            continue;
+        const Asset &a = assets[id];
+        auto *tmpItem = new QListWidgetItem(); //memory managed by ui->lstAssets container
+        tmpItem->setData(Qt::UserRole, QVariant::fromValue<Asset>(a));
+        tmpItem->setText(PrintAsset(a));
+        tmpItem->setToolTip(assetSnippets.value(a.id));
+        ui->lstAssets->addItem(tmpItem);
+    }
+}
+
 /**
  * @brief STIGQter::SelectAsset
  *
@@ -718,15 +842,9 @@ void STIGQter::CleanThreads()
         if (t->isRunning())
             continue;
 
+        //the thread removed its database connection when it finished (see DbConnections)
         t->wait();
 
-        QString connName = o->GetThreadId();
-        if (!connName.isNull() && !connName.isEmpty())
-        {
-            if (QSqlDatabase::connectionNames().contains(connName))
-                QSqlDatabase::removeDatabase(connName);
-        }
-
         workers.removeOne(o);
         threads.removeOne(t);
         delete o;
@@ -1265,7 +1383,9 @@ void STIGQter::Load(const QString &fileName)
     {
         while (ui->tabDB->count() > 1)
             ui->tabDB->removeTab(1);
-        db.LoadDB(fn);
+        Initialize(1000);
+        db.LoadDB(fn, [this](qint64 done, qint64 total) { FileProgress(done, total); });
+        Progress(1000);
         EnableInput();
         DisplayCCIs();
         DisplaySTIGs();
@@ -1460,6 +1580,22 @@ void STIGQter::Initialize(int max, int val)
     ui->progressBar->setValue(val);
 }
 
+/**
+ * @brief STIGQter::FileProgress
+ * @param done
+ * @param total
+ *
+ * Shows the progress of saving or loading a database on a progress
+ * bar initialized to 1000 steps. The interface is repainted since
+ * the file is processed on the GUI thread.
+ */
+void STIGQter::FileProgress(qint64 done, qint64 total)
+{
+    if (total > 0)
+        Progress(static_cast<int>(done * 1000 / total));
+    QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+}
+
 /**
  * @brief STIGQter::Progress
  * @param val
@@ -23,6 +23,7 @@
 #include <QMainWindow>
 #include <QSettings>
 #include <QShortcut>
+#include <QTimer>
 
 #include "dbmanager.h"
 #include "help.h"
@@ -77,11 +78,14 @@ private Q_SLOTS:
     void OpenCKL();
     void POAMTemplate(const QString &fileName = QString(), bool APNumLevel = true);
     void POAMTemplateControl(const QString &fileName = QString());
+    void RebuildSummary();
     void RemapChanged(int checkState);
     void RenameTab(int index, const QString &title);
     bool Reset(bool checkOnly = false);
     void Save();
     void SaveAs(const QString &fileName = QString());
+    void Search(const QString &text);
+    void SearchHelper();
     void SelectAsset();
     void SelectSTIG();
     void StatusChange(const QString &status);
@@ -101,6 +105,7 @@ private:
     bool _updatedSTIGs;
     QString lastSaveLocation;
     QList<QShortcut*> _shortcuts;
+    QTimer _searchTimer;
     void closeEvent(QCloseEvent *event);
     void CleanThreads();
     void DisableInput();
@@ -108,8 +113,10 @@ private:
     void DisplayCCIs();
     void DisplaySTIGs(const QString &search = QString());
     void EnableInput();
+    void FileProgress(qint64 done, qint64 total);
     void UpdateRemapButton();
     bool _isFiltered;
+    bool _isSearched;
 };
 
 #endif // STIGQTER_H
@@ -29,21 +29,10 @@
 
 /**
  * @brief Supplement::Supplement
- * @param right
- * Copy Constructor
- */
-Supplement::Supplement(const Supplement &right) : Supplement(right.parent())
-{
-    *this = right;
-}
-
-/**
- * @brief Supplement::Supplement
- * @param parent
  *
  * Default constructor.
  */
-Supplement::Supplement(QObject *parent) : QObject(parent),
+Supplement::Supplement() :
     id(-1),
     STIGId(-1),
     path(),
@@ -61,23 +50,6 @@ STIG Supplement::GetSTIG()
     return db.GetSTIG(STIGId);
 }
 
-/**
- * @brief Supplement::operator =
- * @param right
- * @return This supplement assigned to from the right operand.
- */
-Supplement &Supplement::operator=(const Supplement &right)
-{
-    if (this != &right)
-    {
-        id = right.id;
-        STIGId = right.STIGId;
-        path = right.path;
-        contents = right.contents;
-    }
-    return *this;
-}
-
 /**
  * @brief PrintSupplement
  * @param supplement
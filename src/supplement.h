@@ -22,24 +22,23 @@
 
 #include "stig.h"
 
-#include <QObject>
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
 
-class Supplement : public QObject
+class Supplement
 {
-    Q_OBJECT
 public:
-    Supplement(const Supplement &right);
-    explicit Supplement(QObject *parent = nullptr);
-    ~Supplement() override = default;
+    Supplement();
 
     int id;
     int STIGId;
     QString path;
     QByteArray contents;
     STIG GetSTIG();
-    Supplement& operator=(const Supplement &right);
 };
 
+Q_DECLARE_TYPEINFO(Supplement, Q_MOVABLE_TYPE);
 Q_DECLARE_METATYPE(Supplement);
 
 [[nodiscard]] QString PrintSupplement(const Supplement &supplement);
@@ -0,0 +1,210 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vulndescriptionscanner.h"
+
+#include <iterator>
+
+#include <QLatin1String>
+
+/**
+ * @class VulnDescriptionScanner
+ * @brief Splits the description of a STIG rule into its fields.
+ *
+ * The XCCDF description of a rule is text that embeds pseudo-tags:
+ * @code
+ * <VulnDiscussion>…</VulnDiscussion><FalsePositives></FalsePositives>…
+ * @endcode
+ * Only the exact tags of the known fields are markup. Any other
+ * "<", ">", or "&" is text.
+ *
+ * The scanner makes one pass over the description and yields each
+ * field as a slice of it, without copying. It gives the same result
+ * as escaping everything but the known tags and reading the
+ * description as an XML element:
+ * @list
+ * @li text outside of a field is skipped;
+ * @li a field that contains another field, ends with the wrong tag,
+ * or is never closed yields the text before that point, and the
+ * scan stops there;
+ * @li an end tag outside of a field stops the scan.
+ * @endlist
+ *
+ * The description is expected to be text already read by an XML
+ * parser, so it only has valid XML characters.
+ */
+
+namespace {
+    //the tag names, in the order of VulnDescriptionScanner::Field
+    const QLatin1String tagNames[] = {
+        QLatin1String("VulnDiscussion"),
+        QLatin1String("FalsePositives"),
+        QLatin1String("FalseNegatives"),
+        QLatin1String("Documentable"),
+        QLatin1String("Mitigations"),
+        QLatin1String("SeverityOverrideGuidance"),
+        QLatin1String("PotentialImpacts"),
+        QLatin1String("ThirdPartyTools"),
+        QLatin1String("MitigationControl"),
+        QLatin1String("Responsibility")
+    };
+
+    /**
+     * @brief MatchTag
+     * @param text
+     * @param at
+     * @param closing
+     * @param length
+     * @return The index in @a tagNames of the known tag that starts
+     * at the "<" at @a at, or -1. When the tag is known, @a closing
+     * is whether it is an end tag, and @a length is its length.
+     */
+    int MatchTag(QStringView text, qsizetype at, bool &closing, qsizetype &length)
+    {
+        qsizetype nameStart = at + 1;
+        closing = nameStart < text.size() && text.at(nameStart) == QLatin1Char('/');
+        if (closing)
+            nameStart++;
+        for (int i = 0; i < static_cast<int>(std::size(tagNames)); i++)
+        {
+            const qsizetype nameEnd = nameStart + tagNames[i].size();
+            if (nameEnd < text.size() && text.at(nameEnd) == QLatin1Char('>') && text.mid(nameStart, tagNames[i].size()).compare(tagNames[i]) == 0)
+            {
+                length = nameEnd + 1 - at;
+                return i;
+            }
+        }
+        return -1;
+    }
+}
+
+/**
+ * @brief VulnDescriptionScanner::VulnDescriptionScanner
+ * @param description
+ *
+ * Main constructor. The @a description must outlive the scanner and
+ * the values it yields.
+ */
+VulnDescriptionScanner::VulnDescriptionScanner(QStringView description) : _description(description)
+{
+}
+
+/**
+ * @brief VulnDescriptionScanner::Next
+ * @return @c True when another field is found. Its name and value
+ * are then available from CurrentField() and Value().
+ */
+bool VulnDescriptionScanner::Next()
+{
+    int open = -1;
+    qsizetype valueStart = 0;
+    while (!_done)
+    {
+        const qsizetype at = _description.indexOf(QLatin1Char('<'), _pos);
+        if (at < 0)
+        {
+            _done = true;
+            if (open < 0)
+                return false;
+            //a field that is never closed ends with the description
+            _field = static_cast<Field>(open);
+            _value = _description.mid(valueStart);
+            return true;
+        }
+
+        bool closing = false;
+        qsizetype length = 0;
+        const int tag = MatchTag(_description, at, closing, length);
+        if (tag < 0)
+        {
+            _pos = at + 1;
+            continue;
+        }
+        _pos = at + length;
+
+        if (open < 0)
+        {
+            //an end tag outside of a field ends the scan
+            if (closing)
+            {
+                _done = true;
+                return false;
+            }
+            open = tag;
+            valueStart = _pos;
+            continue;
+        }
+
+        _field = static_cast<Field>(open);
+        _value = _description.mid(valueStart, at - valueStart);
+        //a field inside of a field, or the wrong end tag, ends the scan
+        if (!closing || tag != open)
+            _done = true;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief VulnDescriptionScanner::CurrentField
+ * @return The field found by the last call to Next().
+ */
+VulnDescriptionScanner::Field VulnDescriptionScanner::CurrentField() const
+{
+    return _field;
+}
+
+/**
+ * @brief VulnDescriptionScanner::Value
+ * @return The text of the field found by the last call to Next(),
+ * as a slice of the description.
+ */
+QStringView VulnDescriptionScanner::Value() const
+{
+    return _value;
+}
+
+/**
+ * @brief VulnDescriptionScanner::Text
+ * @return A trimmed copy of Value() with its line endings normalized
+ * to "\n", as an XML parser reports them.
+ */
+QString VulnDescriptionScanner::Text() const
+{
+    const QStringView value = _value.trimmed();
+    if (!value.contains(QLatin1Char('\r')))
+        return value.toString();
+
+    QString ret;
+    ret.reserve(value.size());
+    for (qsizetype i = 0; i < value.size(); i++)
+    {
+        if (value.at(i) == QLatin1Char('\r'))
+        {
+            ret.append(QLatin1Char('\n'));
+            if (i + 1 < value.size() && value.at(i + 1) == QLatin1Char('\n'))
+                i++;
+        }
+        else
+        {
+            ret.append(value.at(i));
+        }
+    }
+    return ret;
+}
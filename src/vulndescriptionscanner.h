@@ -0,0 +1,58 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VULNDESCRIPTIONSCANNER_H
+#define VULNDESCRIPTIONSCANNER_H
+
+#include <QString>
+#include <QStringView>
+
+class VulnDescriptionScanner
+{
+public:
+    enum class Field
+    {
+        VulnDiscussion,
+        FalsePositives,
+        FalseNegatives,
+        Documentable,
+        Mitigations,
+        SeverityOverrideGuidance,
+        PotentialImpacts,
+        ThirdPartyTools,
+        MitigationControl,
+        Responsibility
+    };
+
+    explicit VulnDescriptionScanner(QStringView description);
+
+    [[nodiscard]] bool Next();
+    [[nodiscard]] Field CurrentField() const;
+    [[nodiscard]] QStringView Value() const;
+    [[nodiscard]] QString Text() const;
+
+private:
+    QStringView _description;
+    qsizetype _pos{0};
+    bool _done{false};
+    Field _field{Field::VulnDiscussion};
+    QStringView _value;
+};
+
+#endif // VULNDESCRIPTIONSCANNER_H
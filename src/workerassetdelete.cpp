@@ -18,6 +18,7 @@
  */
 
 #include "dbmanager.h"
+#include "dbtransaction.h"
 #include "workerassetdelete.h"
 
 #include <QMap>
@@ -75,7 +76,6 @@ void WorkerAssetDelete::process()
     DbManager db;
 
     Q_EMIT updateStatus(QStringLiteral("Deleting Assets…"));
-    db.DelayCommit(true);
     int numChecks = 0;
 
     QMap<Asset, QVector<STIG>> toDelete;
@@ -93,6 +93,7 @@ void WorkerAssetDelete::process()
     Q_EMIT initialize(2 + _assets.count() + numChecks, 1);
     Q_EMIT progress(-1);
 
+    DbTransaction transaction;
     for (Asset a : toDelete.keys())
     {
         Q_EMIT updateStatus(QStringLiteral("Deleting Asset ") + PrintAsset(a) + QStringLiteral("…"));
@@ -105,7 +106,7 @@ void WorkerAssetDelete::process()
         db.DeleteAsset(a);
         Q_EMIT progress(-1);
     }
-    db.DelayCommit(false);
+    transaction.Commit();
     Q_EMIT progress(-1);
 
     //complete
@@ -21,6 +21,7 @@
 #include "common.h"
 #include "cci.h"
 #include "dbmanager.h"
+#include "dbtransaction.h"
 
 #include <iostream>
 
@@ -56,24 +57,19 @@ WorkerCCIAdd::WorkerCCIAdd(QObject *parent) : Worker(parent)
  * @brief WorkerCCIAdd::CheckFamily
  * @param acronym
  * @param addedFamilies
- * @param resetDelay
  *
- * Verifies that families have been added to the database
+ * Verifies that families have been added to the database. The new
+ * @a Family joins the open transaction, so the @a Controls added
+ * after it see it without an intermediate commit.
  */
-void WorkerCCIAdd::CheckFamily(const QString &acronym, const QString &description, QList<QString> &addedFamilies, bool resetDelay)
+void WorkerCCIAdd::CheckFamily(const QString &acronym, const QString &description, QList<QString> &addedFamilies)
 {
     if (addedFamilies.contains(acronym))
         return;
 
     DbManager db;
-    if (resetDelay)
-        db.DelayCommit(false);
-
     db.AddFamily(acronym, description);
     addedFamilies.append(acronym);
-
-    if (resetDelay)
-        db.DelayCommit(true);
 }
 
 /**
@@ -92,6 +88,8 @@ void WorkerCCIAdd::process()
     //open database in this thread
     Q_EMIT initialize(1, 0);
     DbManager db;
+    //the whole RMF and CCI index is written with one commit
+    DbTransaction transaction;
 
     //populate CCIs
 
@@ -101,7 +99,6 @@ void WorkerCCIAdd::process()
     //Step 2: read the families and controls
     //privacy controls obtained from https://nvlpubs.nist.gov/nistpubs/SpecialPublications/NIST.SP.800-53r4.pdf contents
     QList<QString> familiesAdded = {QStringLiteral("AP"), QStringLiteral("AR"), QStringLiteral("DI"), QStringLiteral("DM"), QStringLiteral("IP"), QStringLiteral("SE"), QStringLiteral("TR"), QStringLiteral("UL")};
-    db.DelayCommit(true);
     Q_EMIT initialize(959, 1); //# of base controls: 958
     db.AddFamily(QStringLiteral("AP"), QStringLiteral("Authority and Purpose"));
     db.AddFamily(QStringLiteral("AR"), QStringLiteral("Accountability, Audit, and Risk Management"));
@@ -111,10 +108,8 @@ void WorkerCCIAdd::process()
     db.AddFamily(QStringLiteral("SE"), QStringLiteral("Security"));
     db.AddFamily(QStringLiteral("TR"), QStringLiteral("Transparency"));
     db.AddFamily(QStringLiteral("UL"), QStringLiteral("Use Limitation"));
-    db.DelayCommit(false);
 
     //Step 3: download all controls for each family
-    db.DelayCommit(true);
 
     QFile file2(QStringLiteral(":/dod/src/800-53-rev4-controls.xml"));
     file2.open(QIODevice::ReadOnly);
@@ -144,7 +139,7 @@ void WorkerCCIAdd::process()
                 {
                     inStatement = false;
                     Q_EMIT updateStatus("Adding " + control);
-                    CheckFamily(control.left(2), family, familiesAdded, true);
+                    CheckFamily(control.left(2), family, familiesAdded);
                     db.AddControl(control, title, description);
                     Q_EMIT progress(-1);
                 }
@@ -164,7 +159,7 @@ void WorkerCCIAdd::process()
                 else if ((xml->name().compare(QStringLiteral("control")) == 0) || (xml->name().compare(QStringLiteral("control-enhancement")) == 0))
                 {
                     Q_EMIT updateStatus("Adding " + control);
-                    CheckFamily(control.left(2), family, familiesAdded, true);
+                    CheckFamily(control.left(2), family, familiesAdded);
                     db.AddControl(control, title, description);
                     Q_EMIT progress(-1);
                 }
@@ -173,7 +168,7 @@ void WorkerCCIAdd::process()
     }
     if (!control.isEmpty())
     {
-        CheckFamily(control.left(2), family, familiesAdded, true);
+        CheckFamily(control.left(2), family, familiesAdded);
         db.AddControl(control, title, description);
     }
 
@@ -299,7 +294,6 @@ void WorkerCCIAdd::process()
 
     //Step 7: add CCIs
     Q_EMIT initialize(toAdd.size() + 1, 1);
-    db.DelayCommit(true);
     QList<CCI> inDB = db.GetCCIs().toList();
     for (const CCI &c : toAdd)
     {
@@ -312,7 +306,7 @@ void WorkerCCIAdd::process()
         db.AddCCI(tmpCCI, false);
         Q_EMIT progress(-1);
     }
-    db.DelayCommit(false);
+    transaction.Commit();
 
     //complete
     Q_EMIT updateStatus(QStringLiteral("Done!"));
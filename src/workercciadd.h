@@ -29,7 +29,7 @@ class WorkerCCIAdd : public Worker
     Q_OBJECT
 
 private:
-    void CheckFamily(const QString &acronym, const QString &description, QList<QString> &addedFamilies, bool resetDelay = false);
+    void CheckFamily(const QString &acronym, const QString &description, QList<QString> &addedFamilies);
 
 public:
     explicit WorkerCCIAdd(QObject *parent = nullptr);
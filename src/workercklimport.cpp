@@ -21,6 +21,7 @@
 #include "cklcheck.h"
 #include "common.h"
 #include "dbmanager.h"
+#include "dbtransaction.h"
 #include "workercklimport.h"
 #include "workerstigadd.h"
 
@@ -28,6 +29,7 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSet>
 #include <QTemporaryFile>
 #include <QUrlQuery>
 #include <QXmlStreamReader>
@@ -45,6 +47,124 @@
  * @a Asset and @a STIG are allowed.
  */
 
+namespace {
+
+/**
+ * @brief ReadSTIGInfo
+ * @param xml
+ * @param onVar
+ * @param stig
+ * @return @c True when the current element of @a xml names a STIG
+ * attribute or carries its value. Otherwise, @c false.
+ *
+ * Inside a CKL's STIGS element, a SID_NAME or VULN_ATTRIBUTE names
+ * the attribute (@a onVar) that the following SID_DATA holds. The
+ * version, release and title are stored in @a stig.
+ */
+bool ReadSTIGInfo(QXmlStreamReader *xml, QString &onVar, STIG &stig)
+{
+    if ((xml->name().compare(QStringLiteral("SID_NAME")) == 0) || (xml->name().compare(QStringLiteral("VULN_ATTRIBUTE")) == 0))
+    {
+        onVar = xml->readElementText().trimmed();
+        return true;
+    }
+    if (xml->name().compare(QStringLiteral("SID_DATA")) == 0)
+    {
+        if (onVar == QStringLiteral("version"))
+            stig.version = xml->readElementText().trimmed().toInt();
+        else if (onVar == QStringLiteral("releaseinfo"))
+            stig.release = xml->readElementText().trimmed();
+        else if (onVar == QStringLiteral("title"))
+            stig.title = xml->readElementText().trimmed();
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * @brief WorkerCKLImport::ResolveSTIGs
+ * @param ckl
+ * @param fileName
+ * @return @c True when every STIG that the checklist @a ckl is
+ * mapped against is in the database. Otherwise, @c false.
+ *
+ * When "autostig" is enabled, a missing STIG is downloaded and
+ * imported. This is done before the checklist's transaction begins
+ * so that the database is not locked during the download.
+ */
+bool WorkerCKLImport::ResolveSTIGs(const QByteArray &ckl, const QString &fileName)
+{
+    DbManager db;
+    bool inStigs = false;
+    QXmlStreamReader xml(ckl);
+    QString onVar;
+    STIG tmpSTIG;
+    QSet<QString> resolved;
+
+    //find the STIGs the same way that ParseCKL() looks them up
+    while (!xml.atEnd() && !xml.hasError())
+    {
+        xml.readNext();
+        if (!xml.isStartElement())
+            continue;
+        if (!inStigs)
+        {
+            if (xml.name().compare(QStringLiteral("STIGS")) == 0)
+                inStigs = true;
+        }
+        else if (ReadSTIGInfo(&xml, onVar, tmpSTIG))
+        {
+            continue;
+        }
+        else if ((xml.name().compare(QStringLiteral("ATTRIBUTE_DATA")) == 0) && (onVar == QStringLiteral("Rule_ID")))
+        {
+            QString tmpStr = tmpSTIG.title + " version " + QString::number(tmpSTIG.version) + " " + tmpSTIG.release;
+            if (resolved.contains(tmpStr))
+                continue;
+            STIG tmpSTIG2 = db.GetSTIG(tmpSTIG.title, tmpSTIG.version, tmpSTIG.release);
+            if (tmpSTIG2.id < 0)
+            {
+                QString autostig = db.GetVariable("autostig");
+                if (autostig == QStringLiteral("true"))
+                {
+                    QUrl u("https://www.stigqter.com/autostig.php");
+                    QUrlQuery q;
+                    q.addQueryItem(QStringLiteral("stig"), tmpStr);
+                    u.setQuery(q);
+                    QString u2 = DownloadPage(u);
+
+                    if (!u2.isEmpty())
+                    {
+                        QTemporaryFile tf;
+                        if (tf.open())
+                        {
+                            Q_EMIT updateStatus(QStringLiteral("Attempting to download missing STIG…"));
+                            if (DownloadFile(u2, &tf))
+                            {
+                                Q_EMIT updateStatus(QStringLiteral("Parsing missing STIG…"));
+                                WorkerSTIGAdd wa;
+                                wa.AddSTIGs({tf.fileName()});
+                                wa.process();
+                                tmpSTIG2 = db.GetSTIG(tmpSTIG.title, tmpSTIG.version, tmpSTIG.release);
+                            }
+                        }
+                    }
+                }
+            }
+            if (tmpSTIG2.id < 0)
+            {
+                //The STIG has not been imported.
+                Q_EMIT ThrowWarning(QStringLiteral("STIG/SRG Not Found"), "The CKL file " + fileName + " is mapped against a STIG that has not been imported (" + tmpStr + ").");
+                return false;
+            }
+            resolved.insert(tmpStr);
+        }
+    }
+    return true;
+}
+
 /**
  * @brief WorkerCKLImport::ParseCKL
  * @param fileName
@@ -59,9 +179,15 @@ void WorkerCKLImport::ParseCKL(const QString &fileName)
 	Q_EMIT ThrowWarning(QStringLiteral("Unable to Open CKL"), "The CKL file " + fileName + " cannot be opened.");
         return;
     }
+    const QByteArray ckl = f.readAll();
+    if (!ResolveSTIGs(ckl, fileName))
+        return;
+
     DbManager db;
+    //the whole checklist is imported with one commit
+    DbTransaction transaction;
     bool inStigs = false;
-    QXmlStreamReader *xml = new QXmlStreamReader(f.readAll());
+    QXmlStreamReader *xml = new QXmlStreamReader(ckl);
     Asset a;
     QVector<CKLCheck> checks;
     STIGCheck tmpCheck;
@@ -100,34 +226,17 @@ void WorkerCKLImport::ParseCKL(const QString &fileName)
                         //Apply STIG - the Asset does not have this STIG yet
                         Q_EMIT updateStatus("Adding " + PrintSTIG(tmpSTIG) + " to " + PrintAsset(a) + "…");
                         db.AddSTIGToAsset(tmpSTIG, a);
-                        db.DelayCommit(true);
                         for (CKLCheck c : checks)
                         {
                             c.assetId = a.id;
                             db.UpdateCKLCheck(c);
                         }
-                        db.DelayCommit(false);
                     }
                     checks.clear();
                 }
-                else if ((xml->name().compare(QStringLiteral("SID_NAME")) == 0) || (xml->name().compare(QStringLiteral("VULN_ATTRIBUTE")) == 0))
+                else if (ReadSTIGInfo(xml, onVar, tmpSTIG))
                 {
-                    onVar = xml->readElementText().trimmed();
-                }
-                else if (xml->name().compare(QStringLiteral("SID_DATA")) == 0)
-                {
-                    if (onVar == QStringLiteral("version"))
-                    {
-                        tmpSTIG.version = xml->readElementText().trimmed().toInt();
-                    }
-                    else if (onVar == QStringLiteral("releaseinfo"))
-                    {
-                        tmpSTIG.release = xml->readElementText().trimmed();
-                    }
-                    else if (onVar == QStringLiteral("title"))
-                    {
-                        tmpSTIG.title = xml->readElementText().trimmed();
-                    }
+                    continue;
                 }
                 else if (xml->name().compare(QStringLiteral("ATTRIBUTE_DATA")) == 0)
                 {
@@ -136,37 +245,9 @@ void WorkerCKLImport::ParseCKL(const QString &fileName)
                         QString tmpStr = tmpSTIG.title + " version " + QString::number(tmpSTIG.version) + " " + tmpSTIG.release;
                         STIG tmpSTIG2 = db.GetSTIG(tmpSTIG.title, tmpSTIG.version, tmpSTIG.release);
                         if (tmpSTIG2.id < 0)
-                        {
-                            QString autostig = db.GetVariable("autostig");
-                            if (autostig == QStringLiteral("true"))
-                            {
-                                QUrl u("https://www.stigqter.com/autostig.php");
-                                QUrlQuery q;
-                                q.addQueryItem(QStringLiteral("stig"), tmpStr);
-                                u.setQuery(q);
-                                QString u2 = DownloadPage(u);
-
-                                if (!u2.isEmpty())
-                                {
-                                    QTemporaryFile tf;
-                                    if (tf.open())
-                                    {
-                                        Q_EMIT updateStatus(QStringLiteral("Attempting to download missing STIG…"));
-                                        if (DownloadFile(u2, &tf))
-                                        {
-                                            Q_EMIT updateStatus(QStringLiteral("Parsing missing STIG…"));
-                                            WorkerSTIGAdd wa;
-                                            wa.AddSTIGs({tf.fileName()});
-                                            wa.process();
-                                            tmpSTIG2 = db.GetSTIG(tmpSTIG.title, tmpSTIG.version, tmpSTIG.release);
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        if (tmpSTIG2.id < 0)
                         {
                             //The STIG has not been imported.
+                            transaction.Rollback();
                             Q_EMIT ThrowWarning(QStringLiteral("STIG/SRG Not Found"), "The CKL file " + fileName + " is mapped against a STIG that has not been imported (" + tmpStr + ").");
                             return;
                         }
@@ -261,13 +342,11 @@ void WorkerCKLImport::ParseCKL(const QString &fileName)
         return;
     }
     db.AddSTIGToAsset(tmpSTIG, a);
-    db.DelayCommit(true);
     for (CKLCheck c : checks)
     {
         c.assetId = a.id;
         db.UpdateCKLCheck(c);
     }
-    db.DelayCommit(false);
     delete xml;
 }
 
@@ -296,6 +375,7 @@ void WorkerCKLImport::ParseCKLB(const QString &fileName)
     }
 
     DbManager db;
+    DbTransaction transaction;
     QJsonObject root = doc.object();
 
     // Parse asset/target metadata
@@ -329,6 +409,7 @@ void WorkerCKLImport::ParseCKLB(const QString &fileName)
         if (matches.isEmpty())
         {
             QString stigName = stigObj[QStringLiteral("stig_name")].toString();
+            transaction.Rollback();
             Q_EMIT ThrowWarning(QStringLiteral("STIG/SRG Not Found"),
                 "The CKLB file " + fileName + " references a STIG that has not been imported (" + stigName + " / " + benchmarkId + ").");
             return;
@@ -347,7 +428,6 @@ void WorkerCKLImport::ParseCKLB(const QString &fileName)
         Q_EMIT updateStatus("Adding " + PrintSTIG(stig) + " to " + PrintAsset(a) + "…");
         db.AddSTIGToAsset(stig, a);
 
-        db.DelayCommit(true);
         for (const QJsonValue &ruleVal : stigObj[QStringLiteral("rules")].toArray())
         {
             QJsonObject rule = ruleVal.toObject();
@@ -368,7 +448,6 @@ void WorkerCKLImport::ParseCKLB(const QString &fileName)
 
             db.UpdateCKLCheck(cc);
         }
-        db.DelayCommit(false);
     }
 }
 
@@ -31,6 +31,7 @@ class WorkerCKLImport : public Worker
 
 private:
     QStringList _fileNames;
+    bool ResolveSTIGs(const QByteArray &ckl, const QString &fileName);
     void ParseCKL(const QString &fileName);
     void ParseCKLB(const QString &fileName);
     Asset CheckAsset(Asset &a);
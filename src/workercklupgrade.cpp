@@ -25,6 +25,7 @@
 #include "workerstigadd.h"
 
 #include <QFile>
+#include <QHash>
 #include <QTemporaryFile>
 #include <QUrlQuery>
 #include <QXmlStreamReader>
@@ -65,8 +66,8 @@ void WorkerCKLUpgrade::process()
 {
     Worker::process();
 
-    Q_EMIT initialize(_stig.GetSTIGChecks().count() + 1, 0);
     DbManager db;
+    Q_EMIT initialize(db.CountSTIGChecks(QStringLiteral("WHERE STIGId = :STIGId"), {std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), _stig.id)}) + 1, 0);
     db.DelayCommit(true);
 
     for (STIG s : db.GetSTIGs())
@@ -85,28 +86,37 @@ void WorkerCKLUpgrade::process()
                 //found STIG to upgrade to
                 db.AddSTIGToAsset(s, _asset);
                 db.DelayCommit(true);
-                QVector<CKLCheck> oldChecks = _asset.GetCKLChecks(&_stig);
+
+                //match the checks by vulnerability number without loading their text
+                QHash<int, QString> vulnNums; //STIGCheck id → vulnNum
+                for (const STIGCheckHeader &sc : db.GetSTIGCheckHeaders(QStringLiteral("WHERE STIGId IN (:oldSTIGId, :newSTIGId)"), {
+                                                                            std::make_tuple<QString, QVariant>(QStringLiteral(":oldSTIGId"), _stig.id),
+                                                                            std::make_tuple<QString, QVariant>(QStringLiteral(":newSTIGId"), s.id)
+                                                                        }))
+                {
+                    vulnNums.insert(sc.id, sc.vulnNum);
+                }
+                QHash<QString, CKLCheck> oldChecks; //vulnNum → the first old check
+                for (const CKLCheck &cklOld : _asset.GetCKLChecks(&_stig))
+                {
+                    const QString vulnNum = vulnNums.value(cklOld.stigCheckId);
+                    if (!oldChecks.contains(vulnNum))
+                        oldChecks.insert(vulnNum, cklOld);
+                }
                 for (CKLCheck ckl : _asset.GetCKLChecks(&s))
                 {
                     Q_EMIT updateStatus("Updating " + PrintCKLCheck(ckl) + "...");
-                    bool updated = false;
-                    for (CKLCheck cklOld : oldChecks)
+                    auto cklOld = oldChecks.constFind(vulnNums.value(ckl.stigCheckId));
+                    if (cklOld != oldChecks.constEnd())
                     {
-                        if (cklOld.GetSTIGCheck().vulnNum == ckl.GetSTIGCheck().vulnNum)
-                        {
-                            ckl.status = cklOld.status;
-                            ckl.findingDetails = cklOld.findingDetails;
-                            ckl.comments = cklOld.comments;
-                            ckl.severityOverride = cklOld.severityOverride;
-                            ckl.severityJustification = cklOld.severityJustification;
-                            db.UpdateCKLCheck(ckl);
-                            updated = true;
-                            Q_EMIT progress(-1);
-                            break;
-                        }
+                        ckl.status = cklOld->status;
+                        ckl.findingDetails = cklOld->findingDetails;
+                        ckl.comments = cklOld->comments;
+                        ckl.severityOverride = cklOld->severityOverride;
+                        ckl.severityJustification = cklOld->severityJustification;
+                        db.UpdateCKLCheck(ckl);
+                        Q_EMIT progress(-1);
                     }
-                    if (updated)
-                        continue;
                 }
                 db.DelayCommit(false);
                 break;
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "assessmentsnapshot.h"
 #include "asset.h"
 #include "common.h"
 #include "dbmanager.h"
@@ -58,6 +59,18 @@ void WorkerCMRSExport::SetExportPath(const QString &fileName)
     _fileName = fileName;
 }
 
+/**
+ * @brief WorkerCMRSExport::SetSnapshot
+ * @param snapshot
+ *
+ * Export an @a AssessmentSnapshot that is already loaded instead of
+ * loading one.
+ */
+void WorkerCMRSExport::SetSnapshot(const std::shared_ptr<const AssessmentSnapshot> &snapshot)
+{
+    _snapshot = snapshot;
+}
+
 /**
  * @brief WorkerCMRSExport::process
  *
@@ -70,8 +83,10 @@ void WorkerCMRSExport::process()
     Worker::process();
 
     DbManager db;
-    QVector<Asset> assets = db.GetAssets();
-    Q_EMIT initialize(assets.count(), 0);
+    const std::shared_ptr<const AssessmentSnapshot> loaded = _snapshot ? _snapshot : db.GetAssessmentSnapshot();
+    const AssessmentSnapshot &snapshot = *loaded;
+    const SnapshotCKLChecks &findings = snapshot.cklChecks;
+    Q_EMIT initialize(snapshot.assets.count(), 0);
 
     Q_EMIT updateStatus(QStringLiteral("Preparing Data…"));
 
@@ -87,8 +102,9 @@ void WorkerCMRSExport::process()
         QString curDate = QDateTime::currentDateTime(QTimeZone::UTC).toString(Qt::ISODate);
         QString elementKey = QStringLiteral("0"); //doesn't make sense for target keys to be at this level
 
-        for (Asset a : assets)
+        for (int asset = 0; asset < snapshot.assets.count(); asset++)
         {
+            const Asset &a = snapshot.assets.at(asset);
             Q_EMIT updateStatus("Adding " + PrintAsset(a));
 
             stream.writeStartElement(QStringLiteral("ASSET"));
@@ -138,8 +154,12 @@ void WorkerCMRSExport::process()
 
             stream.writeEndElement(); //ELEMENT
 
-            for (STIG s : a.GetSTIGs())
+            //the asset's checks are grouped by STIG in the order of its STIGs
+            const SnapshotAdjacency::Range checks = snapshot.assetCKLChecks.At(asset);
+            const int *c = checks.begin();
+            for (int stig : snapshot.assetSTIGs.At(asset))
             {
+                const STIG &s = snapshot.stigs.at(stig);
                 stream.writeStartElement(QStringLiteral("TARGET"));
 
                 stream.writeStartElement(QStringLiteral("TARGET_ID"));
@@ -150,9 +170,11 @@ void WorkerCMRSExport::process()
                 stream.writeCharacters(elementKey);
                 stream.writeEndElement(); //TARGET_KEY
 
-                for (CKLCheck c : a.GetCKLChecks(&s))
+                while (c != checks.end() && snapshot.CKLCheckSTIG(*c) < stig)
+                    c++;
+                for (; c != checks.end() && snapshot.CKLCheckSTIG(*c) == stig; c++)
                 {
-                    STIGCheck sc = c.GetSTIGCheck();
+                    const STIGCheck sc = snapshot.STIGCheckAt(findings.stigCheck.at(*c));
 
                     stream.writeStartElement(QStringLiteral("FINDING"));
 
@@ -163,19 +185,19 @@ void WorkerCMRSExport::process()
                     stream.writeEndElement(); //FINDING_ID
 
                     stream.writeStartElement(QStringLiteral("FINDING_STATUS"));
-                    stream.writeCharacters(GetCMRSStatus(c.status));
+                    stream.writeCharacters(GetCMRSStatus(static_cast<Status>(findings.status.at(*c))));
                     stream.writeEndElement(); //FINDING_STATUS
 
                     stream.writeStartElement(QStringLiteral("FINDING_DETAILS"));
                     stream.writeAttribute(QStringLiteral("OVERRIDE"), QStringLiteral("O"));
-                    stream.writeCharacters(c.findingDetails);
+                    stream.writeCharacters(snapshot.String(findings.findingDetails.at(*c)));
                     stream.writeEndElement(); //FINDING_DETAILS
 
                     stream.writeStartElement(QStringLiteral("SCRIPT_RESULTS"));
                     stream.writeEndElement(); //SCRIPT_RESULTS
 
                     stream.writeStartElement(QStringLiteral("COMMENT"));
-                    stream.writeCharacters(c.comments);
+                    stream.writeCharacters(snapshot.String(findings.comments.at(*c)));
                     stream.writeEndElement(); //COMMENT
 
                     stream.writeStartElement(QStringLiteral("TOOL"));
@@ -19,6 +19,7 @@
 
 #include <QDate>
 
+#include "assessmentsnapshot.h"
 #include "common.h"
 #include "dbmanager.h"
 #include "workeremassreport.h"
@@ -55,6 +56,18 @@ void WorkerEMASSReport::SetReportName(const QString &fileName)
     _fileName = fileName;
 }
 
+/**
+ * @brief WorkerEMASSReport::SetSnapshot
+ * @param snapshot
+ *
+ * Build the report from an @a AssessmentSnapshot that is already
+ * loaded instead of loading one.
+ */
+void WorkerEMASSReport::SetSnapshot(const std::shared_ptr<const AssessmentSnapshot> &snapshot)
+{
+    _snapshot = snapshot;
+}
+
 /**
  * @brief WorkerEMASSReport::process
  *
@@ -66,9 +79,11 @@ void WorkerEMASSReport::process()
     Worker::process();
 
     DbManager db;
+    const std::shared_ptr<const AssessmentSnapshot> loaded = _snapshot ? _snapshot : db.GetAssessmentSnapshot();
+    const AssessmentSnapshot &snapshot = *loaded;
+    const SnapshotCKLChecks &findings = snapshot.cklChecks;
 
-    QVector<CKLCheck> checks = db.GetCKLChecks();
-    int numChecks = checks.count();
+    int numChecks = findings.Count();
     Q_EMIT initialize(numChecks+2, 0);
 
     //current date in eMASS format
@@ -180,11 +195,9 @@ void WorkerEMASSReport::process()
     worksheet_write_string(ws, 5, 18, "Tested By", fmtBoldCenter);
     worksheet_write_string(ws, 5, 19, "Test Results", fmtBoldCenter);
 
-    bool dbIsImport = db.IsEmassImport();
-
-    QVector<CCI> ccis = db.GetCCIs();
+    bool dbIsImport = snapshot.emassImport;
 
-    Q_EMIT initialize(ccis.count()+1, 0);
+    Q_EMIT initialize(snapshot.ccis.count()+1, 0);
 
     unsigned int onRow = 5;
 
@@ -194,12 +207,13 @@ void WorkerEMASSReport::process()
     if (username.isNull() || username.isEmpty())
         username = QStringLiteral("UNKNOWN");
 
-    QVector<CKLCheck> failedChecks;
-    QVector<CKLCheck> passedChecks;
-    QVector<CKLCheck> naChecks;
+    QVector<int> failedChecks; //CKLCheck rows
+    QVector<int> passedChecks;
+    QVector<int> naChecks;
 
-    for (CCI cci : db.GetCCIs())
+    for (int cciRow = 0; cciRow < snapshot.ccis.count(); cciRow++)
     {
+        const CCI &cci = snapshot.ccis.at(cciRow);
         Q_EMIT progress(-1);
         Q_EMIT updateStatus("Adding " + PrintCCI(cci) + "…");
         failedChecks.clear();
@@ -207,17 +221,17 @@ void WorkerEMASSReport::process()
         naChecks.clear();
 
         //step 1: check if control is passed or failed
-        for (CKLCheck sc : cci.GetCKLChecks())
+        for (int sc : snapshot.cciCKLChecks.At(cciRow))
         {
-            if (sc.status == Status::Open)
+            if (findings.status.at(sc) == Status::Open)
             {
                 failedChecks.append(sc);
             }
-            else if (sc.status == Status::NotAFinding)
+            else if (findings.status.at(sc) == Status::NotAFinding)
             {
                 passedChecks.append(sc);
             }
-            else if (sc.status == Status::NotApplicable)
+            else if (findings.status.at(sc) == Status::NotApplicable)
             {
                 naChecks.append(sc);
             }
@@ -262,11 +276,13 @@ void WorkerEMASSReport::process()
         //sort only failed checks
         if (failed)
         {
-            std::sort(failedChecks.begin(), failedChecks.end());
+            std::sort(failedChecks.begin(), failedChecks.end(), [&snapshot](int left, int right) {
+                return snapshot.CKLCheckLessThan(left, right);
+            });
         }
-        Control control = cci.GetControl();
+        const Control &control = snapshot.ControlAt(snapshot.cciControls.at(cciRow));
         //control
-        worksheet_write_string(ws, onRow, 0, PrintControl(control).toStdString().c_str(), nullptr);
+        worksheet_write_string(ws, onRow, 0, snapshot.ControlName(snapshot.cciControls.at(cciRow)).toStdString().c_str(), nullptr);
         //control information
         worksheet_write_string(ws, onRow, 1, Excelify(control.description).toStdString().c_str(), fmtWrapped);
         //control implementation status
@@ -354,16 +370,17 @@ void WorkerEMASSReport::process()
             {
                 testResult += QStringLiteral("Not Applicable. All associated technical STIG/SRG checks are determined to be Not Applicable:");
             }
-            for (CKLCheck cc : failed ? failedChecks : passedChecks.isEmpty() ? naChecks : passedChecks)
+            for (int cc : failed ? failedChecks : passedChecks.isEmpty() ? naChecks : passedChecks)
             {
-                testResult.append("\n" + PrintAsset(cc.GetAsset()) + ": " + PrintCKLCheck(cc));
+                testResult.append("\n" + PrintAsset(snapshot.assets.at(findings.asset.at(cc))) + ": " + snapshot.String(snapshot.stigChecks.rule.at(findings.stigCheck.at(cc))));
                 //if failed check, print out severity and finding details (if available)
                 if (failed)
                 {
-                    testResult.append(" - " + GetSeverity(cc.GetSeverity()));
-                    if (!cc.findingDetails.isEmpty())
+                    testResult.append(" - " + GetSeverity(static_cast<Severity>(findings.severity.at(cc))));
+                    const QString &findingDetails = snapshot.String(findings.findingDetails.at(cc));
+                    if (!findingDetails.isEmpty())
                     {
-                        testResult.append(" - " + cc.findingDetails);
+                        testResult.append(" - " + findingDetails);
                     }
                 }
             }
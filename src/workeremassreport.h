@@ -22,18 +22,24 @@
 
 #include "worker.h"
 
+#include <memory>
+
 #include <QObject>
 
+class AssessmentSnapshot;
+
 class WorkerEMASSReport : public Worker
 {
     Q_OBJECT
 
 private:
     QString _fileName;
+    std::shared_ptr<const AssessmentSnapshot> _snapshot;
 
 public:
     explicit WorkerEMASSReport(QObject *parent = nullptr);
     void SetReportName(const QString &fileName);
+    void SetSnapshot(const std::shared_ptr<const AssessmentSnapshot> &snapshot);
 
 public Q_SLOTS:
     void process() override;
@@ -79,8 +79,7 @@ void WorkerFindingsReport::process()
     DbManager db;
 
     QMap<CCI, QVector<CKLCheck>> failedCCIs;
-    QVector<CKLCheck> checks = db.GetCKLChecks();
-    int numChecks = checks.count();
+    int numChecks = db.GetComplianceCounts().Total();
     Q_EMIT initialize(numChecks+3, 0);
 
     //new workbook
@@ -140,9 +139,8 @@ void WorkerFindingsReport::process()
 
     //write each failed check
     unsigned int onRow = 0;
-    for (int i = 0; i < numChecks; i++)
-    {
-        CKLCheck cc = checks[i];
+    //stream the checks; only the open findings are kept for the CCI sheet
+    db.ForEachCKLCheck([&](const CKLCheck &cc) {
         STIGCheck sc = cc.GetSTIGCheck();
         QVector<CCI> ccis = sc.GetCCIs();
         Asset a = cc.GetAsset();
@@ -193,7 +191,8 @@ void WorkerFindingsReport::process()
             }
         }
         Q_EMIT progress(-1);
-    }
+        return true;
+    });
 
     Q_EMIT initialize(numChecks+failedCCIs.count()*2+1, numChecks);
 
@@ -257,16 +256,16 @@ void WorkerFindingsReport::process()
             if (!fixes.isEmpty() && !sc.fix.trimmed().isEmpty())
                 fixes.append(QStringLiteral("\n"));
 
-            int nf = 0; //not a finding
-            int f = 0; //finding
-            QVector<CKLCheck> checks3 = db.GetCKLChecks(sc);
-            for (CKLCheck c3 : checks3)
-            {
-                if (c3.status == Status::NotAFinding)
-                    nf++;
-                else if (c3.status == Status::Open)
-                    f++;
-            }
+            //count the samples without loading every asset's check
+            const QString sampleClause = QStringLiteral("WHERE STIGCheckId = :STIGCheckId AND status = :status");
+            int nf = db.CountCKLChecks(sampleClause, {
+                                           std::make_tuple<QString, QVariant>(QStringLiteral(":STIGCheckId"), sc.id),
+                                           std::make_tuple<QString, QVariant>(QStringLiteral(":status"), Status::NotAFinding)
+                                       }); //not a finding
+            int f = db.CountCKLChecks(sampleClause, {
+                                          std::make_tuple<QString, QVariant>(QStringLiteral(":STIGCheckId"), sc.id),
+                                          std::make_tuple<QString, QVariant>(QStringLiteral(":status"), Status::Open)
+                                      }); //finding
             QString samples = QString(" (Occurred on %1 of %2 samples: %3%)").arg(QString::number(f), QString::number(f + nf), QString::number((double)100 * (double)f / (double)(f + nf), 'f', 2));
             assets.append(PrintCKLCheck(cc) + samples);
             if (!sc.fix.trimmed().isEmpty())
@@ -23,6 +23,8 @@
 #include "dbmanager.h"
 #include "stig.h"
 
+#include <algorithm>
+
 #include <QDir>
 #include <QFileInfo>
 #include <QList>
@@ -146,20 +148,14 @@ void WorkerHTML::process()
 
     //Load the STIG checks into memory
     Q_EMIT initialize(1, 0);
-    Q_EMIT updateStatus(QStringLiteral("Loading STIG information into memory…"));
+    Q_EMIT updateStatus(QStringLiteral("Loading STIG information…"));
     QVector<STIG> stigs = db.GetSTIGs();
-
-    QMap<STIG, QVector<STIGCheck>> checkMap;
-    int count = 0;
-    for (const STIG &s : stigs)
-    {
-        QVector<STIGCheck> checks = s.GetSTIGChecks();
-        count += checks.count();
-        checkMap.insert(s, checks);
-    }
+    //the checks of each STIG are streamed from the database as its pages are written
+    std::sort(stigs.begin(), stigs.end());
+    int count = db.CountSTIGChecks();
 
     //update progress bar to reflect number of steps
-    Q_EMIT initialize(1 + checkMap.count() + count, 1);
+    Q_EMIT initialize(1 + stigs.count() + count, 1);
 
     QDir outputDir(_exportDir);
     if (!outputDir.exists())
@@ -189,7 +185,7 @@ void WorkerHTML::process()
                "<ul>");
 
     //iterate through STIGs. Each STIG is a reference file to its STIGChecks.
-    for (const STIG &s : checkMap.keys())
+    for (const STIG &s : stigs)
     {
         QString STIGName = PrintSTIG(s);
         QString STIGFileName = TrimFileName(s.fileName);
@@ -241,8 +237,7 @@ void WorkerHTML::process()
                    "</tr>");
 
         //Create individual .html files for every STIGCheck
-        for (const STIGCheck &c : checkMap[s])
-        {
+        db.ForEachSTIGCheck([&](const STIGCheck &c) {
             QString checkName(SanitizeFile(PrintSTIGCheck(c)));
             Q_EMIT updateStatus("Creating Check " + checkName + "…");
             stig.write("<tr>"
@@ -262,7 +257,7 @@ void WorkerHTML::process()
 
             QString checkPath = QDir::cleanPath(outputDir.filePath(checkName + ".html"));
             if (!checkPath.startsWith(cleanExportDir))
-                continue;
+                return true;
 
             QFile check(checkPath);
             check.open(QIODevice::WriteOnly);
@@ -325,7 +320,8 @@ void WorkerHTML::process()
             check.close();
 
             Q_EMIT progress(-1);
-        }
+            return true;
+        }, QStringLiteral("WHERE STIGCheck.STIGId = :STIGId"), {std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), s.id)});
         Q_EMIT progress(-1);
         stig.write("</table>"
                    "</body>"
@@ -20,6 +20,9 @@
 #include "common.h"
 #include "dbmanager.h"
 #include "workerimportemass.h"
+#include "ziparchive.h"
+
+#include <memory>
 
 #include <QRegularExpression>
 #include <QXmlStreamReader>
@@ -88,18 +91,20 @@ void WorkerImportEMASS::process()
 
     Q_EMIT initialize(5, 0);
 
+    //each part of the workbook is decompressed as it is parsed
     Q_EMIT updateStatus(QStringLiteral("Opening xlsx file…"));
-    QMap<QString, QByteArray> files = GetFilesFromZip(_fileName);
+    const ZipArchive xlsx(_fileName);
     Q_EMIT progress(-1);
 
     //First, create Shared Strings table
     Q_EMIT updateStatus(QStringLiteral("Reading Shared Strings Table…"));
     QStringList sst;
-    if (files.contains(QStringLiteral("xl/sharedStrings.xml")))
+    std::unique_ptr<QIODevice> sharedStrings = xlsx.Open(QStringLiteral("xl/sharedStrings.xml"));
+    if (sharedStrings)
     {
         //There is a sharedStrings table! Parse it:
         QString toAdd = QString();
-        QXmlStreamReader xml(files[QStringLiteral("xl/sharedStrings.xml")]);
+        QXmlStreamReader xml(sharedStrings.get());
         while (!xml.atEnd() && !xml.hasError())
         {
             xml.readNext();
@@ -122,10 +127,11 @@ void WorkerImportEMASS::process()
     //Second, get the list of sheet IDs from the workbook relationships
     Q_EMIT updateStatus(QStringLiteral("Getting Worksheet IDs…"));
     QMap<QString, QString> relationshipIds;
-    if (files.contains(QStringLiteral("xl/_rels/workbook.xml.rels")))
+    std::unique_ptr<QIODevice> relationships = xlsx.Open(QStringLiteral("xl/_rels/workbook.xml.rels"));
+    if (relationships)
     {
         //Get the IDs of the worksheets
-        QXmlStreamReader xml(files[QStringLiteral("xl/_rels/workbook.xml.rels")]);
+        QXmlStreamReader xml(relationships.get());
         while (!xml.atEnd() && !xml.hasError())
         {
             xml.readNext();
@@ -155,10 +161,11 @@ void WorkerImportEMASS::process()
     //Third, get the names of the sheets by relationship ID
     Q_EMIT updateStatus(QStringLiteral("Getting Worksheet Names…"));
     QMap<QString, QString> sheetNames;
-    if (files.contains(QStringLiteral("xl/workbook.xml")))
+    std::unique_ptr<QIODevice> workbook = xlsx.Open(QStringLiteral("xl/workbook.xml"));
+    if (workbook)
     {
         //Get the Worksheets
-        QXmlStreamReader xml(files[QStringLiteral("xl/workbook.xml")]);
+        QXmlStreamReader xml(workbook.get());
         while (!xml.atEnd() && !xml.hasError())
         {
             xml.readNext();
@@ -186,12 +193,13 @@ void WorkerImportEMASS::process()
     Q_EMIT progress(-1);
 
     //Fourth, find out if a worksheet is named "Test Result Import"
-    if (sheetNames.contains(QStringLiteral("Test Result Import")) && relationshipIds.contains(sheetNames[QStringLiteral("Test Result Import")]) && files.contains("xl/" + relationshipIds[sheetNames[QStringLiteral("Test Result Import")]]))
+    if (sheetNames.contains(QStringLiteral("Test Result Import")) && relationshipIds.contains(sheetNames[QStringLiteral("Test Result Import")]) && xlsx.Entry("xl/" + relationshipIds[sheetNames[QStringLiteral("Test Result Import")]]).IsValid())
     {
         //It does! Continue parsing.
         //Fifth, read the correct spreadsheet that has the needed data
         Q_EMIT updateStatus(QStringLiteral("Reading worksheet…"));
-        QXmlStreamReader xml(files["xl/" + relationshipIds[sheetNames[QStringLiteral("Test Result Import")]]]);
+        std::unique_ptr<QIODevice> worksheet = xlsx.Open("xl/" + relationshipIds[sheetNames[QStringLiteral("Test Result Import")]]);
+        QXmlStreamReader xml(worksheet.get());
         int onRow = 0;
         QString onCol = QString();
         bool isSharedString = false; //keep up with whether the current record is a shared string
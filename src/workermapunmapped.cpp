@@ -20,6 +20,7 @@
 #include "asset.h"
 #include "common.h"
 #include "dbmanager.h"
+#include "dbtransaction.h"
 #include "stig.h"
 #include "stigcheck.h"
 #include "workermapunmapped.h"
@@ -70,6 +71,7 @@ void WorkerMapUnmapped::process()
         remapCCIIds.append(c.id);
     }
 
+    DbTransaction transaction;
     for (STIGCheck check : stigchecks)
     {
         bool updateCheck = false;
@@ -111,6 +113,7 @@ void WorkerMapUnmapped::process()
         }
         Q_EMIT progress(-1);
     }
+    transaction.Commit();
 
     Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
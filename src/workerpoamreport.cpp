@@ -78,10 +78,9 @@ void WorkerPOAMReport::process()
     Q_EMIT updateStatus(QStringLiteral("Building spreadsheet header..."));
     DbManager db;
 
-    QVector<CKLCheck> checks = db.GetCKLChecks();
     QMap<Control, QPair<Severity, QVector<STIGCheck>>> failedControls;
     QMap<CCI, QPair<Severity, QVector<STIGCheck>>> failedCCIs;
-    int numChecks = checks.count();
+    int numChecks = db.CountCKLChecks();
     Q_EMIT initialize(numChecks+3, 0);
 
     //current date in eMASS format
@@ -246,53 +245,50 @@ void WorkerPOAMReport::process()
 
     Q_EMIT updateStatus("Finding non-compliant technical Checks...");
 
-    //build list of non-compliant controls
-    for (auto a : checks)
-    {
-        if (a.status == Status::Open)
+    //build list of non-compliant controls, streaming only the open findings
+    db.ForEachCKLCheck([&](const CKLCheck &a) {
+        Severity tmpSeverity = a.GetSeverity();
+        STIGCheck tmpCheck = a.GetSTIGCheck();
+        auto ccis = tmpCheck.GetCCIs();
+        for (auto cci : ccis)
         {
-            Severity tmpSeverity = a.GetSeverity();
-            STIGCheck tmpCheck = a.GetSTIGCheck();
-            auto ccis = tmpCheck.GetCCIs();
-            for (auto cci : ccis)
+            //check if CCI is imported from eMASS or not
+            if (!_apNums || cci.importApNum.isEmpty())
             {
-                //check if CCI is imported from eMASS or not
-                if (!_apNums || cci.importApNum.isEmpty())
-                {
-                    //The CCI was not imported - add the finding at the control level
-                    auto tmpControl = cci.GetControl();
-
-                    if (!failedControls.keys().contains(tmpControl))
-                        failedControls.insert(tmpControl, {Severity::none, {}});
+                //The CCI was not imported - add the finding at the control level
+                auto tmpControl = cci.GetControl();
 
-                    if (failedControls[tmpControl].first < tmpSeverity)
-                    {
-                        failedControls[tmpControl].first = tmpSeverity;
-                    }
+                if (!failedControls.keys().contains(tmpControl))
+                    failedControls.insert(tmpControl, {Severity::none, {}});
 
-                    if (!failedControls[tmpControl].second.contains(tmpCheck))
-                        failedControls[tmpControl].second.append(tmpCheck);
-                }
-                else
+                if (failedControls[tmpControl].first < tmpSeverity)
                 {
-                    //The CCI was imported - add the finding at the cci level
-                    if (!failedCCIs.keys().contains(cci))
-                    {
-                        failedCCIs.insert(cci, {Severity::none, {}});
-                    }
+                    failedControls[tmpControl].first = tmpSeverity;
+                }
 
-                    //set the severity of the CCI if it is now higher
-                    if (failedCCIs[cci].first < tmpSeverity)
-                    {
-                        failedCCIs[cci].first = tmpSeverity;
-                    }
+                if (!failedControls[tmpControl].second.contains(tmpCheck))
+                    failedControls[tmpControl].second.append(tmpCheck);
+            }
+            else
+            {
+                //The CCI was imported - add the finding at the cci level
+                if (!failedCCIs.keys().contains(cci))
+                {
+                    failedCCIs.insert(cci, {Severity::none, {}});
+                }
 
-                    if (!failedCCIs[cci].second.contains(tmpCheck))
-                        failedCCIs[cci].second.append(tmpCheck);
+                //set the severity of the CCI if it is now higher
+                if (failedCCIs[cci].first < tmpSeverity)
+                {
+                    failedCCIs[cci].first = tmpSeverity;
                 }
+
+                if (!failedCCIs[cci].second.contains(tmpCheck))
+                    failedCCIs[cci].second.append(tmpCheck);
             }
         }
-    }
+        return true;
+    }, QStringLiteral("WHERE status = :status"), {std::make_tuple<QString, QVariant>(QStringLiteral(":status"), Status::Open)});
 
     unsigned onRow = 7;
 
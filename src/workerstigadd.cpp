@@ -17,12 +17,24 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "ccilookup.h"
 #include "common.h"
 #include "dbmanager.h"
+#include "dbtransaction.h"
 #include "stig.h"
 #include "stigcheck.h"
+#include "vulndescriptionscanner.h"
 #include "workerstigadd.h"
+#include "ziparchive.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QWaitCondition>
 #include <QXmlStreamReader>
 
 /**
@@ -32,6 +44,16 @@
  * STIGs and SRGs are supplied as compressed archives with XML files
  * that detail the checklist items. The extraction and parsing of
  * these files is handled here.
+ *
+ * The import is a pipeline. The worker's thread extracts each
+ * archive and queues its XCCDF files to a thread pool, which parses
+ * them without touching the database. The worker's thread is also the
+ * single writer: it adds the parsed STIGs in the order of the queue,
+ * so the database is the same as after a sequential import. At most
+ * twice as many files as there are parser threads are queued or
+ * parsed but not yet added; extraction waits on the writer beyond
+ * that. Only the XCCDF files are decompressed, unless the rest of
+ * the archive is imported as supplements.
  */
 
 /**
@@ -41,7 +63,8 @@
  * Default constructor.
  */
 WorkerSTIGAdd::WorkerSTIGAdd(QObject *parent) : Worker(parent),
-    _enableSupplements(false)
+    _enableSupplements(false),
+    _parserThreads(QThread::idealThreadCount())
 {
 }
 
@@ -49,26 +72,32 @@ WorkerSTIGAdd::WorkerSTIGAdd(QObject *parent) : Worker(parent),
  * @brief WorkerSTIGAdd::ParseSTIG
  * @param stig
  * @param fileName
+ * @param ccis
+ * @return The STIG and its STIGChecks, with the CCI references
+ * resolved through @a ccis.
  *
  * Once a STIG is extracted, it is then parsed for STIGChecks and
- * version information.
+ * version information. Parsing does not use the database, so STIGs
+ * are parsed on several threads at once; they share one read-only
+ * @a ccis table.
  */
-void WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, const QMap<QString, QByteArray> &supplements)
+ParsedSTIG WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, const CCILookup &ccis)
 {
     //should be the .xml file inside of the STIG .zip file here
     auto *xml = new QXmlStreamReader(stig);
-    STIG s;
+    ParsedSTIG ret;
+    STIG &s = ret.stig;
     s.fileName = fileName;
     STIGCheck c;
     s.id = -1;
     c.id = -1;
-    QVector<STIGCheck> checks;
+    QVector<STIGCheck> &checks = ret.checks;
+    QVector<int> missingCCIs; //CCI numbers of the current check that are not in the database
     bool inStigRules = false;
     bool inProfile = false;
     bool inReference = false;
     bool inGroup = false;
     bool addedGroup = false; //if the rule has already been added by the new group tag
-    DbManager db;
     while (!xml->atEnd() && !xml->hasError())
     {
         xml->readNext();
@@ -135,6 +164,8 @@ void WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, c
                         addedGroup = true;
                         //new rule; add the previous one!
                         checks.append(c);
+                        ret.missingCCIs.append(missingCCIs);
+                        missingCCIs.clear();
                         c.cciIds.clear();
                         c.legacyIds.clear();
                     }
@@ -163,6 +194,8 @@ void WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, c
                         {
                             //new rule; add the previous one!
                             checks.append(c);
+                            ret.missingCCIs.append(missingCCIs);
+                            missingCCIs.clear();
                             c.cciIds.clear();
                             c.legacyIds.clear();
                         }
@@ -202,57 +235,8 @@ void WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, c
                 {
                     if (!inGroup)
                     {
-                        QString toParse = "<?xml version=\"1.0\" encoding=\"UTF-8\"?><VulnDescription>" + XMLVulnFix(xml->readElementText().trimmed()) + "</VulnDescription>";
-
                         //parse vulnerability description elements
-                        QXmlStreamReader xml2(toParse);
-                        while (!xml2.atEnd() && !xml2.hasError())
-                        {
-                            xml2.readNext();
-                            if (xml2.isStartElement())
-                            {
-                                if (xml2.name().compare(QStringLiteral("VulnDiscussion")) == 0)
-                                {
-                                    c.vulnDiscussion = xml2.readElementText().trimmed();
-                                }
-                                else if (xml2.name().compare(QStringLiteral("FalsePositives")) == 0)
-                                {
-                                    c.falsePositives = xml2.readElementText().trimmed();
-                                }
-                                else if (xml2.name().compare(QStringLiteral("FalseNegatives")) == 0)
-                                {
-                                    c.falseNegatives = xml2.readElementText().trimmed();
-                                }
-                                else if (xml2.name().compare(QStringLiteral("Documentable")) == 0)
-                                {
-                                    c.documentable = xml2.readElementText().trimmed().startsWith(QStringLiteral("t"), Qt::CaseInsensitive);
-                                }
-                                else if (xml2.name().compare(QStringLiteral("Mitigations")) == 0)
-                                {
-                                    c.mitigations = xml2.readElementText().trimmed();
-                                }
-                                else if (xml2.name().compare(QStringLiteral("SeverityOverrideGuidance")) == 0)
-                                {
-                                    c.severityOverrideGuidance = xml2.readElementText().trimmed();
-                                }
-                                else if (xml2.name().compare(QStringLiteral("PotentialImpacts")) == 0)
-                                {
-                                    c.potentialImpact = xml2.readElementText().trimmed();
-                                }
-                                else if (xml2.name().compare(QStringLiteral("ThirdPartyTools")) == 0)
-                                {
-                                    c.thirdPartyTools = xml2.readElementText().trimmed();
-                                }
-                                else if (xml2.name().compare(QStringLiteral("MitigationControl")) == 0)
-                                {
-                                    c.mitigationControl = xml2.readElementText().trimmed();
-                                }
-                                else if (xml2.name().compare(QStringLiteral("Responsibility")) == 0)
-                                {
-                                    c.responsibility = xml2.readElementText().trimmed();
-                                }
-                            }
-                        }
+                        ParseVulnDescription(xml->readElementText().trimmed(), c);
                     }
                 }
                 else if (xml->name().compare(QStringLiteral("identifier")) == 0)
@@ -288,9 +272,17 @@ void WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, c
                     {
                         if (elementText.startsWith(QStringLiteral("CCI"), Qt::CaseInsensitive))
                         {
-                            auto tmpCci = db.GetCCIByCCI(GetCCINumber(elementText), &s);
-                            if (tmpCci.id >= 0 && !c.cciIds.contains(tmpCci.id))
-                                c.cciIds.append(tmpCci.id);
+                            const int cciNumber = GetCCINumber(elementText);
+                            const int cciId = ccis.Id(cciNumber);
+                            if (cciId < 0)
+                            {
+                                if (!missingCCIs.contains(cciNumber))
+                                    missingCCIs.append(cciNumber);
+                            }
+                            else if (!c.cciIds.contains(cciId))
+                            {
+                                c.cciIds.append(cciId);
+                            }
                         }
                     }
                 }
@@ -322,65 +314,106 @@ void WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, c
     if (inStigRules)
     {
         checks.append(c);
-        c.cciIds.clear();
-        c.legacyIds.clear();
+        ret.missingCCIs.append(missingCCIs);
     }
     delete xml;
+    return ret;
+}
 
-    QVector<Supplement> supplementsToAdd;
-
-    if (_enableSupplements)
+/**
+ * @brief WorkerSTIGAdd::ParseVulnDescription
+ * @param description
+ * @param check
+ *
+ * Sets the fields of @a check (the vulnerability discussion, false
+ * positives and negatives, mitigations, and so on) that are embedded
+ * in the XCCDF @a description of its rule. Fields that the
+ * description does not have are left unchanged.
+ */
+void WorkerSTIGAdd::ParseVulnDescription(QStringView description, STIGCheck &check)
+{
+    VulnDescriptionScanner scanner(description);
+    while (scanner.Next())
     {
-        for (const QString &key : supplements.keys())
+        switch (scanner.CurrentField())
         {
-            Supplement sup;
-            sup.path = key;
-            sup.contents = supplements.value(key);
-            supplementsToAdd.append(sup);
+        case VulnDescriptionScanner::Field::VulnDiscussion:
+            check.vulnDiscussion = scanner.Text();
+            break;
+        case VulnDescriptionScanner::Field::FalsePositives:
+            check.falsePositives = scanner.Text();
+            break;
+        case VulnDescriptionScanner::Field::FalseNegatives:
+            check.falseNegatives = scanner.Text();
+            break;
+        case VulnDescriptionScanner::Field::Documentable:
+            check.documentable = scanner.Value().trimmed().startsWith(QLatin1Char('t'), Qt::CaseInsensitive);
+            break;
+        case VulnDescriptionScanner::Field::Mitigations:
+            check.mitigations = scanner.Text();
+            break;
+        case VulnDescriptionScanner::Field::SeverityOverrideGuidance:
+            check.severityOverrideGuidance = scanner.Text();
+            break;
+        case VulnDescriptionScanner::Field::PotentialImpacts:
+            check.potentialImpact = scanner.Text();
+            break;
+        case VulnDescriptionScanner::Field::ThirdPartyTools:
+            check.thirdPartyTools = scanner.Text();
+            break;
+        case VulnDescriptionScanner::Field::MitigationControl:
+            check.mitigationControl = scanner.Text();
+            break;
+        case VulnDescriptionScanner::Field::Responsibility:
+            check.responsibility = scanner.Text();
+            break;
         }
     }
-
-    //Sometimes the .zip file contains extraneous .xml files
-    if (!checks.isEmpty())
-        db.AddSTIG(s, checks, supplementsToAdd);
 }
 
 /**
- * @brief WorkerSTIGAdd::XMLVulnFix
- * @param xml
- * @return formatted XML data encoded properly for STIG vulnDescription field
+ * @brief WorkerSTIGAdd::AddParsedSTIG
+ * @param parsed
+ *
+ * The writer stage of the import: looks up the CCIs that were
+ * missing from the lookup table (reporting the ones that do not
+ * exist) and adds the STIG to the database.
  */
-QString WorkerSTIGAdd::XMLVulnFix(const QString &xml)
+void WorkerSTIGAdd::AddParsedSTIG(ParsedSTIG &parsed)
 {
-        QString temp(xml);
+    //Sometimes the .zip file contains extraneous .xml files
+    if (parsed.checks.isEmpty())
+        return;
 
-        temp.replace(QStringLiteral("&"), QStringLiteral("&amp;"));
-        temp.replace(QStringLiteral("'"), QStringLiteral("&apos;"));
-        temp.replace(QStringLiteral("\""), QStringLiteral("&quot;"));
-        temp.replace(QStringLiteral("<"), QStringLiteral("&lt;"));
-        temp.replace(QStringLiteral(">"), QStringLiteral("&gt;"));
-        temp.replace(QStringLiteral("&lt;VulnDiscussion&gt;"), QStringLiteral("<VulnDiscussion>"));
-        temp.replace(QStringLiteral("&lt;/VulnDiscussion&gt;"), QStringLiteral("</VulnDiscussion>"));
-        temp.replace(QStringLiteral("&lt;FalsePositives&gt;"), QStringLiteral("<FalsePositives>"));
-        temp.replace(QStringLiteral("&lt;/FalsePositives&gt;"), QStringLiteral("</FalsePositives>"));
-        temp.replace(QStringLiteral("&lt;FalseNegatives&gt;"), QStringLiteral("<FalseNegatives>"));
-        temp.replace(QStringLiteral("&lt;/FalseNegatives&gt;"), QStringLiteral("</FalseNegatives>"));
-        temp.replace(QStringLiteral("&lt;Documentable&gt;"), QStringLiteral("<Documentable>"));
-        temp.replace(QStringLiteral("&lt;/Documentable&gt;"), QStringLiteral("</Documentable>"));
-        temp.replace(QStringLiteral("&lt;Mitigations&gt;"), QStringLiteral("<Mitigations>"));
-        temp.replace(QStringLiteral("&lt;/Mitigations&gt;"), QStringLiteral("</Mitigations>"));
-        temp.replace(QStringLiteral("&lt;SeverityOverrideGuidance&gt;"), QStringLiteral("<SeverityOverrideGuidance>"));
-        temp.replace(QStringLiteral("&lt;/SeverityOverrideGuidance&gt;"), QStringLiteral("</SeverityOverrideGuidance>"));
-        temp.replace(QStringLiteral("&lt;PotentialImpacts&gt;"), QStringLiteral("<PotentialImpacts>"));
-        temp.replace(QStringLiteral("&lt;/PotentialImpacts&gt;"), QStringLiteral("</PotentialImpacts>"));
-        temp.replace(QStringLiteral("&lt;ThirdPartyTools&gt;"), QStringLiteral("<ThirdPartyTools>"));
-        temp.replace(QStringLiteral("&lt;/ThirdPartyTools&gt;"), QStringLiteral("</ThirdPartyTools>"));
-        temp.replace(QStringLiteral("&lt;MitigationControl&gt;"), QStringLiteral("<MitigationControl>"));
-        temp.replace(QStringLiteral("&lt;/MitigationControl&gt;"), QStringLiteral("</MitigationControl>"));
-        temp.replace(QStringLiteral("&lt;Responsibility&gt;"), QStringLiteral("<Responsibility>"));
-        temp.replace(QStringLiteral("&lt;/Responsibility&gt;"), QStringLiteral("</Responsibility>"));
+    DbManager db;
+    for (int i = 0; i < parsed.checks.count(); i++)
+    {
+        STIGCheck &c = parsed.checks[i];
+        for (int cciNumber : std::as_const(parsed.missingCCIs[i]))
+        {
+            auto tmpCci = db.GetCCIByCCI(cciNumber, &parsed.stig);
+            if (tmpCci.id >= 0 && !c.cciIds.contains(tmpCci.id))
+                c.cciIds.append(tmpCci.id);
+        }
+    }
+    db.AddSTIG(parsed.stig, parsed.checks, parsed.supplements);
+}
 
-        return temp;
+/**
+ * @brief WorkerSTIGAdd::AddSTIG
+ * @param fileName
+ * @param contents
+ *
+ * Queues a STIG .zip file that is already in memory, such as one
+ * inside of the quarterly release, so that it is extracted without
+ * writing it to disk. The @a fileName is only used for status
+ * messages.
+ */
+void WorkerSTIGAdd::AddSTIG(const QString &fileName, const QByteArray &contents)
+{
+    _todo.append(fileName);
+    _contents.resize(_todo.count() - 1);
+    _contents.append(contents);
 }
 
 /**
@@ -407,6 +440,18 @@ void WorkerSTIGAdd::SetEnableSupplements(bool enableSupplements)
     _enableSupplements = enableSupplements;
 }
 
+/**
+ * @brief WorkerSTIGAdd::SetParserThreads
+ * @param threads
+ *
+ * Sets the number of threads that parse STIGs. The default is the
+ * number of processor cores.
+ */
+void WorkerSTIGAdd::SetParserThreads(int threads)
+{
+    _parserThreads = std::max(1, threads);
+}
+
 /**
  * @brief WorkerSTIGAdd::process
  *
@@ -420,27 +465,132 @@ void WorkerSTIGAdd::process()
 {
     Worker::process();
 
+    //every parser thread resolves CCI numbers through the same table
+    std::shared_ptr<const CCILookup> ccis;
+    {
+        DbManager db;
+        ccis = db.GetCCILookup();
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(_parserThreads);
+    const int maxQueued = _parserThreads * 2;
+
+    //parsed STIGs wait here, by queue position, until they are added in order
+    QMutex parsedMutex;
+    QWaitCondition parsedReady;
+    QMap<int, ParsedSTIG> parsed;
+    std::atomic<int> numParsed{0};
+    int numQueued = 0;
+    int numAdded = 0;
+
+    //every STIG in an archive is added with one commit
+    QVector<int> archiveSTIGs(_todo.count(), 0);
+    std::unique_ptr<DbTransaction> transaction;
+    int transactionArchive = -1;
+
+    //the writer stage: add the next parsed STIG in queue order
+    auto addNext = [&]() {
+        ParsedSTIG next;
+        {
+            QMutexLocker locker(&parsedMutex);
+            while (!parsed.contains(numAdded))
+                parsedReady.wait(&parsedMutex);
+            next = parsed.take(numAdded);
+        }
+        numAdded++;
+        if (next.archive != transactionArchive)
+        {
+            transaction.reset();
+            transaction = std::make_unique<DbTransaction>();
+            transactionArchive = next.archive;
+        }
+        Q_EMIT updateStatus("Adding " + next.stig.fileName + "… (" + QString::number(numParsed.load()) + " of " + QString::number(numQueued) + " STIGs parsed, " + QString::number(numAdded - 1) + " added)");
+        AddParsedSTIG(next);
+        if (--archiveSTIGs[next.archive] == 0)
+        {
+            transaction.reset();
+            Q_EMIT progress(-1);
+        }
+    };
+
     //get the list of STIG .zip files selected
     Q_EMIT initialize(_todo.count(), 0);
     //loop through it and parse all XML files inside
-    for (const QString &s : _todo)
+    for (int archive = 0; archive < _todo.count(); archive++)
     {
-        Q_EMIT updateStatus("Extracting " + s + "…");
-        //get the list of XML files inside the STIG
-        QMap<QString, QByteArray> toParse = GetFilesFromZip(s);
+        const QString &s = _todo.at(archive);
+        Q_EMIT updateStatus("Extracting " + s + "… (" + QString::number(archive + 1) + " of " + QString::number(_todo.count()) + " archives)");
+        //get the list of XML files inside the STIG; only the ones used are extracted
+        std::unique_ptr<ZipArchive> zip;
+        if (archive < _contents.count() && !_contents.at(archive).isNull())
+        {
+            zip = std::make_unique<ZipArchive>(_contents.at(archive));
+            //the archive keeps its own reference to the contents
+            _contents[archive] = QByteArray();
+        }
+        else
+        {
+            zip = std::make_unique<ZipArchive>(s);
+        }
+        const QVector<ZipEntry> entries = zip->Entries();
+        QVector<ZipEntry> stigs;
+        for (const ZipEntry &entry : entries)
+        {
+            if (entry.name.endsWith(QStringLiteral("-xccdf.xml"), Qt::CaseInsensitive) || entry.name.endsWith(QStringLiteral("Manual_STIG.xml"), Qt::CaseInsensitive) || entry.name.endsWith(QStringLiteral("Manual_xccdf.xml"), Qt::CaseInsensitive))
+                stigs.append(entry);
+        }
+        //queue the STIGs in name order
+        std::sort(stigs.begin(), stigs.end(), [](const ZipEntry &left, const ZipEntry &right) { return left.name < right.name; });
+        archiveSTIGs[archive] = static_cast<int>(stigs.count());
+
+        //the supplements of a STIG are the files that have not been queued before it
+        QMap<QString, QByteArray> toSupplement;
+        if (_enableSupplements)
+        {
+            for (const ZipEntry &entry : entries)
+                toSupplement.insert(entry.name, zip->Read(entry));
+        }
+        if (stigs.isEmpty())
+            Q_EMIT progress(-1);
 
         Q_EMIT updateStatus("Parsing " + s + "…");
-        for (const QString &stig : toParse.keys())
+        for (const ZipEntry &stig : std::as_const(stigs))
         {
-            if (stig.endsWith(QStringLiteral("-xccdf.xml"), Qt::CaseInsensitive) || stig.endsWith(QStringLiteral("Manual_STIG.xml"), Qt::CaseInsensitive) || stig.endsWith(QStringLiteral("Manual_xccdf.xml"), Qt::CaseInsensitive))
+            //bounded queue: add the oldest STIGs before queuing more
+            while (numQueued - numAdded >= maxQueued)
+                addNext();
+
+            QByteArray val = _enableSupplements ? toSupplement.take(stig.name) : zip->Read(stig);
+            QVector<Supplement> supplements;
+            if (_enableSupplements)
             {
-                QByteArray val = toParse.value(stig);
-                toParse.remove(stig);
-                ParseSTIG(val, TrimFileName(stig), toParse);
+                for (auto i = toSupplement.constBegin(); i != toSupplement.constEnd(); i++)
+                {
+                    Supplement sup;
+                    sup.path = i.key();
+                    sup.contents = i.value();
+                    supplements.append(sup);
+                }
             }
+            const int position = numQueued++;
+            const QString fileName = TrimFileName(stig.name);
+            pool.start([val, fileName, supplements, archive, position, ccis, &parsed, &parsedMutex, &parsedReady, &numParsed]() {
+                ParsedSTIG result = ParseSTIG(val, fileName, *ccis);
+                result.supplements = supplements;
+                result.archive = archive;
+                numParsed++;
+                QMutexLocker locker(&parsedMutex);
+                parsed.insert(position, std::move(result));
+                parsedReady.wakeAll();
+            });
         }
-        Q_EMIT progress(-1);
     }
+    while (numAdded < numQueued)
+        addNext();
+    pool.waitForDone();
+    transaction.reset();
+
     Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
@@ -20,9 +20,25 @@
 #ifndef WORKERSTIGADD_H
 #define WORKERSTIGADD_H
 
+#include "stig.h"
+#include "stigcheck.h"
+#include "supplement.h"
 #include "worker.h"
 
 #include <QObject>
+#include <QStringView>
+#include <QVector>
+
+class CCILookup;
+
+struct ParsedSTIG
+{
+    STIG stig;
+    QVector<STIGCheck> checks;
+    QVector<QVector<int>> missingCCIs; //the CCI numbers of each check that the lookup table did not have
+    QVector<Supplement> supplements;
+    int archive{-1}; //position of the .zip file in the queue
+};
 
 class WorkerSTIGAdd : public Worker
 {
@@ -30,14 +46,19 @@ class WorkerSTIGAdd : public Worker
 
 private:
     QStringList _todo;
+    QVector<QByteArray> _contents; //archives already in memory, or null to read the file
     bool _enableSupplements;
-    void ParseSTIG(const QByteArray &stig, const QString &fileName, const QMap<QString, QByteArray> &supplements);
-    QString XMLVulnFix(const QString &xml);
+    int _parserThreads;
+    [[nodiscard]] static ParsedSTIG ParseSTIG(const QByteArray &stig, const QString &fileName, const CCILookup &ccis);
+    void AddParsedSTIG(ParsedSTIG &parsed);
 
 public:
     explicit WorkerSTIGAdd(QObject *parent = nullptr);
+    void AddSTIG(const QString &fileName, const QByteArray &contents);
     void AddSTIGs(const QStringList &stigs);
     void SetEnableSupplements(bool enableSupplements);
+    void SetParserThreads(int threads);
+    static void ParseVulnDescription(QStringView description, STIGCheck &check);
 
 public Q_SLOTS:
     void process() override;
@@ -24,8 +24,12 @@
 #include "workerstigdownload.h"
 
 #include "workerstigadd.h"
-#include <QTemporaryFile>
-#include <QMap>
+#include "ziparchive.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <QThread>
 
 /**
  * @class WorkerSTIGDownload
@@ -35,6 +39,13 @@
  * The main source of STIG and SRG information is from DISA. They
  * publish a quarterly STIG release that is downloaded and processed
  * in this worker.
+ *
+ * The release is a .zip file of .zip files. It is downloaded and
+ * read in memory, and nothing is written to the temporary directory.
+ * The inner archives are listed from the release's directory and
+ * extracted only as each batch is handed to a @a WorkerSTIGAdd, so
+ * only one batch of them (and the release itself) is held in memory
+ * at once.
  */
 
 /**
@@ -75,37 +86,50 @@ void WorkerSTIGDownload::process()
     Q_EMIT initialize(2, 1);
     Q_EMIT updateStatus(QStringLiteral("Downloading quarterly…"));
 
-    QTemporaryFile tmpFile;
-    if (tmpFile.open())
+    QByteArray quarterly;
     {
         DbManager db;
         QUrl stigs(db.GetVariable(QStringLiteral("quarterly")));
-        DownloadFile(stigs, &tmpFile);
-        //get all zip files within the master zip file
-        Q_EMIT updateStatus(QStringLiteral("Extracting and adding STIGs…"));
-        auto stigFiles = GetFilesFromZip(tmpFile.fileName(), QStringLiteral(".zip"));
-        Q_EMIT initialize(stigFiles.count() + 2, 2);
-        //assume that each zip file within the archive is its own STIG and try to process it
-        QMap<QString, QByteArray>::iterator i;
-        for (i = stigFiles.begin(); i != stigFiles.end(); ++i)
-        {
-            Q_EMIT updateStatus("Parsing " + i.key() + "…");
-            WorkerSTIGAdd tmpWorker;
-            tmpWorker.SetEnableSupplements(_enableSupplements);
-            QTemporaryFile tmpFile2;
-            if (tmpFile2.open())
-            {
-                tmpFile2.write(i.value());
-            }
-            tmpFile2.close();
-            QStringList tmpList;
-            tmpList.push_back(tmpFile2.fileName());
-            tmpWorker.AddSTIGs(tmpList);
-            tmpWorker.process();
+        DownloadFile(stigs, &quarterly);
+    }
+
+    //the inner archives are listed from the directory without extracting them
+    const ZipArchive release(quarterly);
+    QVector<ZipEntry> archives = release.Entries(QStringLiteral(".zip"));
+    std::sort(archives.begin(), archives.end(), [](const ZipEntry &left, const ZipEntry &right) { return left.name < right.name; });
+    const int numArchives = static_cast<int>(archives.count());
+    Q_EMIT initialize(numArchives + 2, 2);
+    Q_EMIT updateStatus(QStringLiteral("Extracting and adding STIGs…"));
+
+    //enough archives per batch to keep every parser thread busy
+    const int batchSize = std::max(1, QThread::idealThreadCount() * 2);
+    std::unique_ptr<WorkerSTIGAdd> batch;
+    int batchCount = 0;
+    int numDone = 0;
+    auto addBatch = [&]() {
+        if (!batch)
+            return;
+        Q_EMIT updateStatus("Parsing STIGs… (" + QString::number(numDone + batchCount) + " of " + QString::number(numArchives) + " archives)");
+        batch->process();
+        batch.reset();
+        for (; batchCount > 0; batchCount--, numDone++)
             Q_EMIT progress(-1);
+    };
+
+    //assume that each zip file within the archive is its own STIG and try to process it
+    for (const ZipEntry &archive : std::as_const(archives))
+    {
+        if (!batch)
+        {
+            batch = std::make_unique<WorkerSTIGAdd>();
+            batch->SetEnableSupplements(_enableSupplements);
         }
-        tmpFile.close();
+        batch->AddSTIG(archive.name, release.Read(archive));
+        if (++batchCount >= batchSize)
+            addBatch();
     }
+    addBatch();
+
     Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
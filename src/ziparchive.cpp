@@ -0,0 +1,292 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ziparchive.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <zip.h>
+
+/**
+ * @class ZipArchive
+ * @brief A .zip file (STIG archives, the quarterly release, and .xlsx
+ * workbooks) that is read one entry at a time.
+ *
+ * Opening the archive only reads its directory. Entries() lists the
+ * name and size of each file without decompressing anything, and an
+ * entry is decompressed only when it is asked for: Read() inflates
+ * it into a buffer that grows as data arrives, up to the size in the
+ * directory, and Open() returns a sequential QIODevice that inflates
+ * it as it is read, so that a QXmlStreamReader can parse it without
+ * the whole file in memory.
+ *
+ * The archive is either a file on disk or a QByteArray that is
+ * already in memory (such as a .zip file inside of another one),
+ * which is read in place without copying it.
+ *
+ * libzip archives are not thread-safe; an archive and the devices it
+ * opens must be used from one thread.
+ */
+
+namespace {
+    //zip bomb protection: entries larger than 4GB extracted are skipped
+    constexpr zip_uint64_t maxEntrySize = 4294967295;
+    //the most Read() allocates before any data arrives
+    constexpr qsizetype maxInitialRead = 64 * 1024 * 1024;
+
+    /**
+     * @brief The ZipEntryDevice class
+     *
+     * A read-only, sequential device that inflates one entry of a
+     * @a ZipArchive as it is read.
+     */
+    class ZipEntryDevice : public QIODevice
+    {
+    public:
+        ZipEntryDevice(zip_file_t *file, qint64 size) : _file(file), _remaining(size)
+        {
+            open(QIODevice::ReadOnly);
+        }
+
+        ~ZipEntryDevice() override
+        {
+            close();
+            zip_fclose(_file);
+        }
+
+        [[nodiscard]] bool isSequential() const override
+        {
+            return true;
+        }
+
+        [[nodiscard]] qint64 bytesAvailable() const override
+        {
+            return _remaining + QIODevice::bytesAvailable();
+        }
+
+    protected:
+        qint64 readData(char *data, qint64 maxSize) override
+        {
+            if (_remaining <= 0)
+                return 0;
+            const zip_int64_t len = zip_fread(_file, data, static_cast<zip_uint64_t>(std::min(maxSize, _remaining)));
+            if (len <= 0)
+            {
+                //truncated or corrupt entry
+                _remaining = 0;
+                return len < 0 ? -1 : 0;
+            }
+            _remaining -= len;
+            return len;
+        }
+
+        qint64 writeData(const char *data, qint64 maxSize) override
+        {
+            Q_UNUSED(data)
+            Q_UNUSED(maxSize)
+            return -1;
+        }
+
+    private:
+        zip_file_t *_file;
+        qint64 _remaining;
+    };
+}
+
+/**
+ * @brief ZipArchive::ZipArchive
+ * @param fileName
+ *
+ * Opens the .zip file at @a fileName.
+ */
+ZipArchive::ZipArchive(const QString &fileName)
+{
+    int err;
+    _za = zip_open(fileName.toStdString().c_str(), ZIP_RDONLY, &err);
+}
+
+/**
+ * @overload ZipArchive::ZipArchive(const QString &fileName)
+ * @brief ZipArchive::ZipArchive
+ * @param zipData
+ *
+ * Opens the .zip file in @a zipData in place. The archive keeps a
+ * (shared) reference to @a zipData.
+ */
+ZipArchive::ZipArchive(const QByteArray &zipData) : _zipData(zipData)
+{
+    zip_error_t error;
+    zip_error_init(&error);
+    zip_source_t *source = zip_source_buffer_create(_zipData.constData(), static_cast<zip_uint64_t>(_zipData.size()), 0, &error);
+    if (source)
+    {
+        _za = zip_open_from_source(source, ZIP_RDONLY, &error);
+        //the archive owns the source once it is open
+        if (!_za)
+            zip_source_free(source);
+    }
+    zip_error_fini(&error);
+}
+
+/**
+ * @brief ZipArchive::~ZipArchive
+ *
+ * Closes the archive. Devices returned by Open() must be destroyed
+ * first.
+ */
+ZipArchive::~ZipArchive()
+{
+    if (_za)
+        zip_discard(_za);
+}
+
+/**
+ * @brief ZipArchive::IsOpen
+ * @return @c True when the archive was opened and is a .zip file.
+ */
+bool ZipArchive::IsOpen() const
+{
+    return _za;
+}
+
+/**
+ * @brief ZipArchive::Entries
+ * @param fileNameFilter
+ * @return The files in the archive, in the order of its directory.
+ *
+ * Only the directory is read. When @a fileNameFilter is set, only
+ * the files that end with it (case-insensitive) are listed.
+ */
+QVector<ZipEntry> ZipArchive::Entries(const QString &fileNameFilter) const
+{
+    QVector<ZipEntry> ret;
+    if (!_za)
+        return ret;
+    const zip_int64_t count = zip_get_num_entries(_za, 0);
+    ret.reserve(static_cast<int>(std::max<zip_int64_t>(count, 0)));
+    for (zip_int64_t i = 0; i < count; i++)
+    {
+        ZipEntry entry = Stat(i);
+        if (!entry.IsValid())
+            continue;
+        if (!fileNameFilter.isEmpty() && !entry.name.endsWith(fileNameFilter, Qt::CaseInsensitive))
+            continue;
+        ret.append(entry);
+    }
+    return ret;
+}
+
+/**
+ * @brief ZipArchive::Entry
+ * @param name
+ * @return The file named @a name in the archive. The entry is not
+ * valid when there is no such file.
+ */
+ZipEntry ZipArchive::Entry(const QString &name) const
+{
+    if (!_za)
+        return ZipEntry();
+    const zip_int64_t index = zip_name_locate(_za, name.toStdString().c_str(), 0);
+    return index < 0 ? ZipEntry() : Stat(index);
+}
+
+/**
+ * @brief ZipArchive::Read
+ * @param entry
+ * @return The decompressed contents of @a entry.
+ *
+ * The entry is inflated directly into the buffer. The size recorded
+ * in the archive's directory is not trusted for the allocation: the
+ * buffer starts at no more than 64 MiB and doubles as data arrives,
+ * up to that size.
+ */
+QByteArray ZipArchive::Read(const ZipEntry &entry) const
+{
+    if (!_za || !entry.IsValid() || entry.size < 0 || entry.size > std::numeric_limits<qsizetype>::max())
+        return QByteArray();
+    zip_file_t *file = zip_fopen_index(_za, static_cast<zip_uint64_t>(entry.index), 0);
+    if (!file)
+        return QByteArray();
+    const auto size = static_cast<qsizetype>(entry.size);
+    QByteArray ret(std::min(size, maxInitialRead), Qt::Uninitialized);
+    qsizetype sum = 0;
+    while (sum < size)
+    {
+        if (sum == ret.size())
+            ret.resize(size - ret.size() > ret.size() ? ret.size() * 2 : size);
+        const zip_int64_t len = zip_fread(file, ret.data() + sum, static_cast<zip_uint64_t>(ret.size() - sum));
+        if (len <= 0)
+            break; //truncated or corrupt entry
+        sum += static_cast<qsizetype>(len);
+    }
+    zip_fclose(file);
+    ret.truncate(sum);
+    return ret;
+}
+
+/**
+ * @brief ZipArchive::Open
+ * @param entry
+ * @return A sequential device that decompresses @a entry as it is
+ * read, or @c nullptr when it cannot be opened.
+ */
+std::unique_ptr<QIODevice> ZipArchive::Open(const ZipEntry &entry) const
+{
+    if (!_za || !entry.IsValid())
+        return nullptr;
+    zip_file_t *file = zip_fopen_index(_za, static_cast<zip_uint64_t>(entry.index), 0);
+    if (!file)
+        return nullptr;
+    return std::make_unique<ZipEntryDevice>(file, entry.size);
+}
+
+/**
+ * @overload ZipArchive::Open(const ZipEntry &entry)
+ * @brief ZipArchive::Open
+ * @param name
+ * @return A sequential device that decompresses the file named
+ * @a name as it is read, or @c nullptr when there is no such file.
+ */
+std::unique_ptr<QIODevice> ZipArchive::Open(const QString &name) const
+{
+    return Open(Entry(name));
+}
+
+/**
+ * @brief ZipArchive::Stat
+ * @param index
+ * @return The name and sizes of the entry at @a index, or an invalid
+ * entry when it cannot be read or is too large to extract.
+ */
+ZipEntry ZipArchive::Stat(qint64 index) const
+{
+    ZipEntry ret;
+    struct zip_stat sb;
+    zip_stat_init(&sb);
+    if (zip_stat_index(_za, static_cast<zip_uint64_t>(index), 0, &sb) != 0 || !(sb.valid & ZIP_STAT_NAME) || !(sb.valid & ZIP_STAT_SIZE))
+        return ret;
+    if (sb.size > maxEntrySize)
+        return ret;
+    ret.index = index;
+    ret.name = QString::fromLatin1(sb.name);
+    ret.size = static_cast<qint64>(sb.size);
+    ret.compressedSize = (sb.valid & ZIP_STAT_COMP_SIZE) ? static_cast<qint64>(sb.comp_size) : 0;
+    return ret;
+}
@@ -0,0 +1,64 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2026 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZIPARCHIVE_H
+#define ZIPARCHIVE_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+
+struct zip;
+
+struct ZipEntry
+{
+    qint64 index{-1};
+    QString name;
+    qint64 size{0}; /**< Uncompressed size */
+    qint64 compressedSize{0};
+    [[nodiscard]] bool IsValid() const { return index >= 0; }
+};
+Q_DECLARE_TYPEINFO(ZipEntry, Q_MOVABLE_TYPE);
+
+class ZipArchive
+{
+public:
+    explicit ZipArchive(const QString &fileName);
+    explicit ZipArchive(const QByteArray &zipData);
+    ZipArchive(const ZipArchive &) = delete;
+    ZipArchive &operator=(const ZipArchive &) = delete;
+    ~ZipArchive();
+
+    [[nodiscard]] bool IsOpen() const;
+    [[nodiscard]] QVector<ZipEntry> Entries(const QString &fileNameFilter = QString()) const;
+    [[nodiscard]] ZipEntry Entry(const QString &name) const;
+    [[nodiscard]] QByteArray Read(const ZipEntry &entry) const;
+    [[nodiscard]] std::unique_ptr<QIODevice> Open(const ZipEntry &entry) const;
+    [[nodiscard]] std::unique_ptr<QIODevice> Open(const QString &name) const;
+
+private:
+    struct zip *_za{nullptr};
+    QByteArray _zipData; //an archive opened from memory reads from this
+    [[nodiscard]] ZipEntry Stat(qint64 index) const;
+};
+
+#endif // ZIPARCHIVE_H
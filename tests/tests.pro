@@ -14,21 +14,29 @@ INCLUDEPATH += ../src
 
 SOURCES += \
     tst_stigqter.cpp \
+    ../src/assessmentsnapshot.cpp \
     ../src/asset.cpp \
     ../src/assetview.cpp \
     ../src/cci.cpp \
+    ../src/ccilookup.cpp \
     ../src/cklcheck.cpp \
     ../src/common.cpp \
     ../src/control.cpp \
+    ../src/dbconnections.cpp \
     ../src/dbmanager.cpp \
+    ../src/dbquery.cpp \
+    ../src/dbtransaction.cpp \
+    ../src/entitycache.cpp \
     ../src/family.cpp \
     ../src/help.cpp \
+    ../src/logwriter.cpp \
     ../src/stig.cpp \
     ../src/stigcheck.cpp \
     ../src/stigedit.cpp \
     ../src/stigqter.cpp \
     ../src/supplement.cpp \
     ../src/tabviewwidget.cpp \
+    ../src/vulndescriptionscanner.cpp \
     ../src/worker.cpp \
     ../src/workerassetadd.cpp \
     ../src/workerassetdelete.cpp \
@@ -50,25 +58,34 @@ SOURCES += \
     ../src/workerpoamreport.cpp \
     ../src/workerstigadd.cpp \
     ../src/workerstigdelete.cpp \
-    ../src/workerstigdownload.cpp
+    ../src/workerstigdownload.cpp \
+    ../src/ziparchive.cpp
 
 HEADERS += \
     tst_stigqter.h \
+    ../src/assessmentsnapshot.h \
     ../src/asset.h \
     ../src/assetview.h \
     ../src/cci.h \
+    ../src/ccilookup.h \
     ../src/cklcheck.h \
     ../src/common.h \
     ../src/control.h \
+    ../src/dbconnections.h \
     ../src/dbmanager.h \
+    ../src/dbquery.h \
+    ../src/dbtransaction.h \
+    ../src/entitycache.h \
     ../src/family.h \
     ../src/help.h \
+    ../src/logwriter.h \
     ../src/stig.h \
     ../src/stigcheck.h \
     ../src/stigedit.h \
     ../src/stigqter.h \
     ../src/supplement.h \
     ../src/tabviewwidget.h \
+    ../src/vulndescriptionscanner.h \
     ../src/worker.h \
     ../src/workerassetadd.h \
     ../src/workerassetdelete.h \
@@ -90,7 +107,8 @@ HEADERS += \
     ../src/workerpoamreport.h \
     ../src/workerstigadd.h \
     ../src/workerstigdelete.h \
-    ../src/workerstigdownload.h
+    ../src/workerstigdownload.h \
+    ../src/ziparchive.h
 
 FORMS += \
     ../src/assetview.ui \
@@ -98,6 +116,16 @@ FORMS += \
     ../src/stigedit.ui \
     ../src/stigqter.ui
 
+# Query timing and the slow-query log (Help > Query Diagnostics).
+# The default build tests the shipped configuration; build again with
+# qmake CONFIG+=query_stats to cover the instrumentation.
+CONFIG(query_stats) {
+    DEFINES += STIGQTER_QUERY_STATS
+    SOURCES += ../src/querydiagnostics.cpp ../src/querystats.cpp
+    HEADERS += ../src/querydiagnostics.h ../src/querystats.h
+    FORMS += ../src/querydiagnostics.ui
+}
+
 LIBS += -lzip -lxlsxwriter -lz
 
 resources.files = \
@@ -19,15 +19,49 @@
 
 #include "tst_stigqter.h"
 
+#include "assessmentsnapshot.h"
+#include "ccilookup.h"
 #include "common.h"
+#include "dbconnections.h"
 #include "dbmanager.h"
+#include "dbquery.h"
+#include "dbtransaction.h"
+#include "entitycache.h"
+#include "logwriter.h"
+#include "querystats.h"
 #include "stigqter.h"
 #include "workerassetdelete.h"
+#include "workercciadd.h"
 #include "workercklimport.h"
+#include "workercmrsexport.h"
+#include "workeremassreport.h"
+#include "workerstigadd.h"
 #include "workerstigdelete.h"
+#include "ziparchive.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include <QCryptographicHash>
 #include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QSemaphore>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
 #include <QThread>
+#include <QXmlStreamReader>
 #include <QtTest>
 
 TestSTIGQter::TestSTIGQter(QObject *parent) : QObject(parent)
@@ -44,6 +78,128 @@ void TestSTIGQter::procEvents()
     QApplication::processEvents();
 }
 
+STIG TestSTIGQter::LoadBenchmarkSTIG()
+{
+    DbManager db;
+    if (db.GetCCIs().isEmpty())
+    {
+        WorkerCCIAdd wc;
+        wc.process();
+    }
+
+    const QVector<std::tuple<QString, QVariant>> variables = {std::make_tuple<QString, QVariant>(QStringLiteral(":fileName"), QStringLiteral("U_ASD_STIG_V5R1_Manual-xccdf.xml"))};
+    QVector<STIG> stigs = db.GetSTIGs(QStringLiteral("WHERE fileName = :fileName"), variables);
+    if (stigs.isEmpty())
+    {
+        WorkerSTIGAdd wa;
+        wa.AddSTIGs({QStringLiteral("tests/U_ASD_V5R1_STIG.zip")});
+        wa.process();
+        stigs = db.GetSTIGs(QStringLiteral("WHERE fileName = :fileName"), variables);
+    }
+
+    if (stigs.isEmpty())
+        return STIG();
+    return stigs.first();
+}
+
+/**
+ * Map @a stig to @a count new assets named @a prefix followed by 0,
+ * 1, …, and give each of their checks the status that @a status
+ * returns for it. Nothing is kept unless every asset is added.
+ */
+QVector<Asset> TestSTIGQter::AddBenchmarkAssets(const STIG &stig, const QString &prefix, int count, const std::function<Status (const CKLCheck &)> &status)
+{
+    DbManager db;
+    DbTransaction transaction;
+    QVector<Asset> assets;
+    for (int i = 0; i < count; i++)
+    {
+        Asset asset;
+        asset.hostName = prefix + QString::number(i);
+        bool ret = db.AddAsset(asset);
+        asset = db.GetAsset(asset.hostName);
+        ret = ret && db.AddSTIGToAsset(stig, asset);
+        if (ret && status)
+        {
+            for (CKLCheck check : db.GetCKLChecks(asset))
+            {
+                check.status = status(check);
+                ret = db.UpdateCKLCheck(check) && ret;
+            }
+        }
+        if (!ret)
+        {
+            transaction.Rollback();
+            return QVector<Asset>();
+        }
+        assets.append(asset);
+    }
+    return assets;
+}
+
+/**
+ * Remove the @a assets that AddBenchmarkAssets() added for @a stig.
+ */
+bool TestSTIGQter::DeleteBenchmarkAssets(const STIG &stig, const QVector<Asset> &assets)
+{
+    DbManager db;
+    DbTransaction transaction;
+    bool ret = true;
+    for (const Asset &asset : assets)
+        ret = db.DeleteSTIGFromAsset(stig, asset) && db.DeleteAsset(asset) && ret;
+    return ret;
+}
+
+/**
+ * The description parser that VulnDescriptionScanner replaced:
+ * escape everything but the known tags, then read the result as XML.
+ * Kept as the reference for test29_VulnDescriptionScanner.
+ */
+void TestSTIGQter::LegacyVulnDescription(const QString &description, STIGCheck &check)
+{
+    QString temp(description);
+    temp.replace(QStringLiteral("&"), QStringLiteral("&amp;"));
+    temp.replace(QStringLiteral("'"), QStringLiteral("&apos;"));
+    temp.replace(QStringLiteral("\""), QStringLiteral("&quot;"));
+    temp.replace(QStringLiteral("<"), QStringLiteral("&lt;"));
+    temp.replace(QStringLiteral(">"), QStringLiteral("&gt;"));
+    const QStringList tags = {QStringLiteral("VulnDiscussion"), QStringLiteral("FalsePositives"), QStringLiteral("FalseNegatives"), QStringLiteral("Documentable"), QStringLiteral("Mitigations"), QStringLiteral("SeverityOverrideGuidance"), QStringLiteral("PotentialImpacts"), QStringLiteral("ThirdPartyTools"), QStringLiteral("MitigationControl"), QStringLiteral("Responsibility")};
+    for (const QString &tag : tags)
+    {
+        temp.replace("&lt;" + tag + "&gt;", "<" + tag + ">");
+        temp.replace("&lt;/" + tag + "&gt;", "</" + tag + ">");
+    }
+
+    QXmlStreamReader xml("<?xml version=\"1.0\" encoding=\"UTF-8\"?><VulnDescription>" + temp + "</VulnDescription>");
+    while (!xml.atEnd() && !xml.hasError())
+    {
+        xml.readNext();
+        if (xml.isStartElement())
+        {
+            if (xml.name().compare(QStringLiteral("VulnDiscussion")) == 0)
+                check.vulnDiscussion = xml.readElementText().trimmed();
+            else if (xml.name().compare(QStringLiteral("FalsePositives")) == 0)
+                check.falsePositives = xml.readElementText().trimmed();
+            else if (xml.name().compare(QStringLiteral("FalseNegatives")) == 0)
+                check.falseNegatives = xml.readElementText().trimmed();
+            else if (xml.name().compare(QStringLiteral("Documentable")) == 0)
+                check.documentable = xml.readElementText().trimmed().startsWith(QStringLiteral("t"), Qt::CaseInsensitive);
+            else if (xml.name().compare(QStringLiteral("Mitigations")) == 0)
+                check.mitigations = xml.readElementText().trimmed();
+            else if (xml.name().compare(QStringLiteral("SeverityOverrideGuidance")) == 0)
+                check.severityOverrideGuidance = xml.readElementText().trimmed();
+            else if (xml.name().compare(QStringLiteral("PotentialImpacts")) == 0)
+                check.potentialImpact = xml.readElementText().trimmed();
+            else if (xml.name().compare(QStringLiteral("ThirdPartyTools")) == 0)
+                check.thirdPartyTools = xml.readElementText().trimmed();
+            else if (xml.name().compare(QStringLiteral("MitigationControl")) == 0)
+                check.mitigationControl = xml.readElementText().trimmed();
+            else if (xml.name().compare(QStringLiteral("Responsibility")) == 0)
+                check.responsibility = xml.readElementText().trimmed();
+        }
+    }
+}
+
 void TestSTIGQter::initTestCase()
 {
     IgnoreWarnings = true;
@@ -96,6 +252,42 @@ void TestSTIGQter::test03_IndexSTIGs()
     QVERIFY(db.GetSTIGs().count() > 0);
 }
 
+void TestSTIGQter::test03a_BenchmarkSTIGIngest()
+{
+    DbManager db;
+    const QVector<STIG> stigs = db.GetSTIGs();
+    QVERIFY(!stigs.isEmpty());
+
+    QVector<QVector<STIGCheck>> checks;
+    QVector<QVector<Supplement>> supplements;
+    qint64 rows = 0;
+    for (const STIG &stig : stigs)
+    {
+        checks.append(db.GetSTIGChecks(stig));
+        supplements.append(db.GetSupplements(stig));
+        rows += 1 + checks.last().count() + supplements.last().count();
+        for (const STIGCheck &c : checks.last())
+            rows += qMax(1, static_cast<int>(c.cciIds.count())) + c.legacyIds.count();
+    }
+
+    //ingest a copy of the library, then discard it
+    DbTransaction transaction;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < stigs.count(); i++)
+    {
+        STIG copy = stigs.at(i);
+        copy.id = -1;
+        copy.title = "Benchmark " + copy.title;
+        QVERIFY(db.AddSTIG(copy, checks.at(i), supplements.at(i)));
+    }
+    qint64 elapsed = timer.nsecsElapsed();
+    QVERIFY(transaction.Rollback());
+
+    qInfo().noquote() << stigs.count() << "STIGs," << rows << "rows in" << elapsed / 1000000.0 << "ms:" << static_cast<qint64>(rows * 1000000000.0 / qMax<qint64>(1, elapsed)) << "rows/second";
+    QCOMPARE(db.GetSTIGs().count(), stigs.count());
+}
+
 void TestSTIGQter::test04_RunInterface()
 {
     {
@@ -182,6 +374,1556 @@ void TestSTIGQter::test07_Cleanup()
     QVERIFY(w->isProcessingEnabled());
 }
 
+void TestSTIGQter::test08_QueryPlans()
+{
+    const STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    QVERIFY(db.GetVariable(QStringLiteral("version")).toInt() >= 10);
+    const QVector<STIGCheck> checks = db.GetSTIGChecks(stig);
+    QVERIFY(!checks.isEmpty());
+    const STIGCheck check = checks.first();
+    QVERIFY(!check.cciIds.isEmpty());
+    CCI cci;
+    cci.id = check.cciIds.first();
+    Asset asset;
+    asset.id = 1;
+
+    //the statements each getter actually runs must be index searches, not table scans
+    const QVector<std::tuple<QString, std::function<void()>>> getters = {
+        std::make_tuple(QStringLiteral("idx_CKLCheck_AssetId_STIGCheckId"), [&]() { db.GetCKLChecks(asset, &stig); }),
+        std::make_tuple(QStringLiteral("idx_STIGCheck_STIGId_rule"), [&]() { db.GetCKLChecks(asset, &stig); }),
+        std::make_tuple(QStringLiteral("idx_CKLCheck_STIGCheckId"), [&]() { db.GetCKLChecks(check); }),
+        std::make_tuple(QStringLiteral("idx_STIGCheck_STIGId_rule"), [&]() { db.GetSTIGCheck(stig, check.rule); }),
+        std::make_tuple(QStringLiteral("idx_STIGCheckCCI_STIGCheckId"), [&]() { db.GetCCIs(check.id); }),
+        std::make_tuple(QStringLiteral("idx_STIGCheckCCI_CCIId"), [&]() { db.GetSTIGChecks(cci); }),
+        std::make_tuple(QStringLiteral("idx_STIGCheckCCI_CCIId"), [&]() { db.GetCKLChecks(cci); }),
+        std::make_tuple(QStringLiteral("idx_STIGCheckLegacyId_STIGCheckId"), [&]() { db.GetLegacyIds(check.id); }),
+        std::make_tuple(QStringLiteral("idx_CCI_cci"), [&]() { db.GetCCIByCCI(366); }),
+        std::make_tuple(QStringLiteral("idx_AssetSTIG_AssetId_STIGId"), [&]() { db.GetSTIGs(asset); }),
+        std::make_tuple(QStringLiteral("idx_AssetSTIG_STIGId"), [&]() { db.GetAssets(stig); })
+    };
+
+    for (const auto &getter : getters)
+    {
+        QString index;
+        std::function<void()> run;
+        std::tie(index, run) = getter;
+        DbQuery::StartCapture();
+        run();
+        const QStringList statements = DbQuery::StopCapture();
+        QVERIFY2(!statements.isEmpty(), qPrintable("No statement uses " + index));
+        QStringList details;
+        for (const QString &statement : statements)
+            details.append(db.GetQueryPlan(statement));
+        QVERIFY2(details.join(QStringLiteral("\n")).contains(index), qPrintable(statements.join(QStringLiteral("; ")) + " does not use " + index + ": " + details.join(QStringLiteral("; "))));
+    }
+}
+
+void TestSTIGQter::test09_BenchmarkSTIGChecks()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    QElapsedTimer timer;
+
+    //set-based loader: a fixed number of queries
+    timer.start();
+    const QVector<STIGCheck> checks = db.GetSTIGChecks(stig);
+    const qint64 setBased = timer.nsecsElapsed();
+    QVERIFY(!checks.isEmpty());
+
+    //previous per-row loader: the same SELECT of the checks, then the
+    //CCI and legacy ID queries for each check, without the entity cache
+    //that it predates
+    const int capacity = EntityCache::CCIs().Capacity();
+    EntityCache::CCIs().SetCapacity(0);
+    QVector<int> ids;
+    QVector<QVector<int>> cciIds;
+    QVector<QStringList> legacyIds;
+    timer.restart();
+    {
+        DbQuery q(QSqlDatabase::database(QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()))));
+        q.prepare(QStringLiteral("SELECT `id`, `STIGId`, `rule`, `vulnNum`, `groupTitle`, `ruleVersion`, `severity`, `weight`, `title`, `vulnDiscussion`, `falsePositives`, `falseNegatives`, `fix`, `check`, `documentable`, `mitigations`, `severityOverrideGuidance`, `checkContentRef`, `potentialImpact`, `thirdPartyTools`, `mitigationControl`, `responsibility`, `IAControls`, `targetKey`, `isRemap` FROM STIGCheck WHERE STIGCheck.STIGId = :STIGId"));
+        q.bindValue(QStringLiteral(":STIGId"), stig.id);
+        q.exec();
+        QVector<QVariant> row;
+        while (q.next())
+        {
+            row.clear();
+            for (int i = 0; i < 25; i++)
+                row.append(q.value(i));
+            ids.append(row.at(0).toInt());
+        }
+        for (int id : std::as_const(ids))
+        {
+            QVector<int> ccis;
+            for (const CCI &cci : db.GetCCIs(id))
+                ccis.append(cci.id);
+            cciIds.append(ccis);
+            QStringList legacy;
+            for (const QString &legacyId : db.GetLegacyIds(id))
+                legacy.append(legacyId);
+            legacyIds.append(legacy);
+        }
+    }
+    const qint64 perRow = timer.nsecsElapsed();
+    EntityCache::CCIs().SetCapacity(capacity);
+
+    //both loaders return the same mappings
+    QCOMPARE(ids.count(), checks.count());
+    QHash<int, int> rows;
+    for (int i = 0; i < ids.count(); i++)
+        rows.insert(ids.at(i), i);
+    for (const STIGCheck &c : checks)
+    {
+        QVERIFY(rows.contains(c.id));
+        QCOMPARE(c.cciIds, cciIds.at(rows.value(c.id)));
+        QCOMPARE(c.legacyIds, legacyIds.at(rows.value(c.id)));
+    }
+
+    qInfo().noquote() << PrintSTIG(stig) << "-" << checks.count() << "checks; set-based:" << setBased / 1000000.0 << "ms, per-row:" << perRow / 1000000.0 << "ms";
+}
+
+void TestSTIGQter::test10_BatchLoaders()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    QVector<STIGCheck> checks = db.GetSTIGChecks(stig);
+    QVERIFY(checks.count() > 1);
+
+    //reversed, with a duplicate and an ID that does not exist
+    QVector<int> ids;
+    for (const STIGCheck &c : checks)
+        ids.prepend(c.id);
+    ids.append(checks.first().id);
+    ids.append(-1);
+
+    QVector<STIGCheck> batch = db.GetSTIGChecks(ids);
+    QCOMPARE(batch.count(), checks.count() + 1);
+    for (int i = 0; i < checks.count(); i++)
+        QCOMPARE(batch.at(i), checks.at(checks.count() - 1 - i));
+    QCOMPARE(batch.last(), checks.first());
+
+    QVector<int> cciIds;
+    QVector<CCI> ccis;
+    for (const STIGCheck &c : checks)
+    {
+        cciIds.append(c.cciIds);
+        for (int cciId : c.cciIds)
+        {
+            CCI cci = db.GetCCI(cciId);
+            if (cci.id >= 0)
+                ccis.append(cci);
+        }
+    }
+    QCOMPARE(db.GetCCIs(cciIds), ccis);
+
+    QVector<STIG> stigs = db.GetSTIGs(QVector<int>({stig.id, -1, stig.id}));
+    QCOMPARE(stigs.count(), 2);
+    QCOMPARE(stigs.first(), stig);
+}
+
+void TestSTIGQter::test11_ConcurrentReadWrite()
+{
+    constexpr int batches = 20;
+    constexpr int batchSize = 50;
+    const QString where = QStringLiteral("WHERE hostName LIKE 'STRESS-%'");
+    std::atomic<bool> writing{true};
+    std::atomic<int> reads{0};
+    std::atomic<int> partialReads{0};
+    std::atomic<int> failedWrites{0};
+    QStringList connections;
+    QMutex connectionsMutex;
+
+    //each batch of Assets is committed as one delayed-commit transaction
+    QThread *writer = QThread::create([&]() {
+        {
+            DbManager db;
+            for (int batch = 0; batch < batches; batch++)
+            {
+                db.DelayCommit(true);
+                for (int i = 0; i < batchSize; i++)
+                {
+                    Asset a;
+                    a.hostName = "STRESS-" + QString::number(batch * batchSize + i);
+                    if (!db.AddAsset(a))
+                        failedWrites++;
+                }
+                db.DelayCommit(false);
+            }
+        }
+        writing = false;
+        QMutexLocker locker(&connectionsMutex);
+        connections.append(QString::number(reinterpret_cast<quint64>(QThread::currentThreadId())));
+    });
+
+    //a reader must only ever see whole batches
+    QThread *reader = QThread::create([&]() {
+        {
+            DbManager db;
+            while (writing)
+            {
+                if (db.GetAssets(where).count() % batchSize != 0)
+                    partialReads++;
+                reads++;
+            }
+        }
+        QMutexLocker locker(&connectionsMutex);
+        connections.append(QString::number(reinterpret_cast<quint64>(QThread::currentThreadId())));
+    });
+
+    reader->start();
+    writer->start();
+    QVERIFY(writer->wait(300000));
+    QVERIFY(reader->wait(300000));
+    delete writer;
+    delete reader;
+
+    for (const QString &connection : connections)
+    {
+        DbQuery::ClearCache(connection);
+        QSqlDatabase::removeDatabase(connection);
+    }
+
+    QCOMPARE(failedWrites.load(), 0);
+    QCOMPARE(partialReads.load(), 0);
+    QVERIFY(reads > 0);
+
+    DbManager db;
+    QVector<Asset> assets = db.GetAssets(where);
+    QCOMPARE(assets.count(), batches * batchSize);
+    db.DelayCommit(true);
+    for (const Asset &a : assets)
+        QVERIFY(db.DeleteAsset(a));
+    db.DelayCommit(false);
+    QVERIFY(db.GetAssets(where).isEmpty());
+}
+
+void TestSTIGQter::test12_NestedTransactions()
+{
+    DbManager db;
+    Asset outer;
+    outer.hostName = QStringLiteral("TRANSACTION-OUTER");
+    Asset kept;
+    kept.hostName = QStringLiteral("TRANSACTION-KEPT");
+    Asset discarded;
+    discarded.hostName = QStringLiteral("TRANSACTION-DISCARDED");
+
+    QVERIFY(!DbTransaction::Active());
+    {
+        DbTransaction transaction;
+        QVERIFY(transaction.IsOpen());
+        QVERIFY(db.AddAsset(outer));
+        {
+            DbTransaction savepoint;
+            QCOMPARE(DbTransaction::Depth(), 2);
+            QVERIFY(db.AddAsset(kept));
+        }
+        {
+            DbTransaction savepoint;
+            QVERIFY(db.AddAsset(discarded));
+            QVERIFY(db.GetAsset(discarded.hostName).id > 0);
+            QVERIFY(savepoint.Rollback());
+            QVERIFY(!savepoint.IsOpen());
+        }
+        QCOMPARE(DbTransaction::Depth(), 1);
+        QVERIFY(db.GetAsset(discarded.hostName).id <= 0);
+        QVERIFY(transaction.Commit());
+    }
+    QVERIFY(!DbTransaction::Active());
+
+    //DelayCommit() nests with explicit scopes
+    {
+        DbTransaction transaction;
+        db.DelayCommit(true);
+        QCOMPARE(DbTransaction::Depth(), 2);
+        db.DelayCommit(false);
+        QVERIFY(transaction.Rollback());
+    }
+
+    QVERIFY(db.GetAsset(outer.hostName).id > 0);
+    QVERIFY(db.GetAsset(kept.hostName).id > 0);
+    QVERIFY(db.GetAsset(discarded.hostName).id <= 0);
+    QVERIFY(db.DeleteAsset(db.GetAsset(outer.hostName)));
+    QVERIFY(db.DeleteAsset(db.GetAsset(kept.hostName)));
+}
+
+void TestSTIGQter::test13_StreamingCursors()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    const QString where = QStringLiteral("WHERE STIGCheck.STIGId = :STIGId");
+    const QVector<std::tuple<QString, QVariant>> variables = {std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), stig.id)};
+
+    //the cursor crosses batch boundaries and still carries the mappings
+    QVector<STIGCheck> checks = db.GetSTIGChecks(where, variables);
+    QVector<STIGCheck> streamed;
+    QVERIFY(db.ForEachSTIGCheck([&streamed](const STIGCheck &c) {
+        streamed.append(c);
+        return true;
+    }, where, variables));
+    QCOMPARE(streamed.count(), checks.count());
+    QCOMPARE(db.CountSTIGChecks(where, variables), checks.count());
+    for (int i = 0; i < checks.count(); i++)
+    {
+        QCOMPARE(streamed.at(i), checks.at(i));
+        QCOMPARE(streamed.at(i).cciIds, checks.at(i).cciIds);
+        QCOMPARE(streamed.at(i).legacyIds, checks.at(i).legacyIds);
+    }
+
+    //returning false stops the iteration
+    int seen = 0;
+    QVERIFY(db.ForEachCCI([&seen](const CCI &) {
+        return ++seen < 10;
+    }));
+    QCOMPARE(seen, qMin(10, static_cast<int>(db.GetCCIs().count())));
+
+    QVector<CKLCheck> ckls = db.GetCKLChecks();
+    int streamedCKLs = 0;
+    QVERIFY(db.ForEachCKLCheck([&](const CKLCheck &c) {
+        return c.id == ckls.at(streamedCKLs++).id;
+    }));
+    QCOMPARE(streamedCKLs, ckls.count());
+    QCOMPARE(db.CountCKLChecks(), ckls.count());
+}
+
+void TestSTIGQter::test14_EntityCache()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    EntityCache::Clear();
+
+    //the second lookup is served from the cache
+    const quint64 hits = EntityCache::STIGs().Hits();
+    const quint64 misses = EntityCache::STIGs().Misses();
+    QCOMPARE(db.GetSTIG(stig.id), stig);
+    QCOMPARE(db.GetSTIG(stig.id).description, stig.description);
+    QCOMPARE(EntityCache::STIGs().Misses(), misses + 1);
+    QCOMPARE(EntityCache::STIGs().Hits(), hits + 1);
+    QVERIFY(EntityCache::HitRate() > 0);
+
+    //updates invalidate the cached copy
+    STIG changed = stig;
+    changed.description = QStringLiteral("Entity cache test");
+    QVERIFY(db.UpdateSTIG(changed));
+    QCOMPARE(db.GetSTIG(stig.id).description, changed.description);
+
+    //a rolled back update does not leave the uncommitted row cached
+    {
+        DbTransaction transaction;
+        QVERIFY(db.UpdateSTIG(stig));
+        QCOMPARE(db.GetSTIG(stig.id).description, stig.description);
+        QVERIFY(transaction.Rollback());
+    }
+    QCOMPARE(db.GetSTIG(stig.id).description, changed.description);
+    QVERIFY(db.UpdateSTIG(stig));
+    QCOMPARE(db.GetSTIG(stig.id).description, stig.description);
+
+    //the least recently used entities are evicted past the capacity
+    QVector<STIGCheck> checks = stig.GetSTIGChecks();
+    QVERIFY(checks.count() > 4);
+    const int capacity = EntityCache::STIGChecks().Capacity();
+    const quint64 evictions = EntityCache::STIGChecks().Evictions();
+    EntityCache::STIGChecks().SetCapacity(4);
+    for (const STIGCheck &c : checks)
+        QCOMPARE(db.GetSTIGCheck(c.id), c);
+    QCOMPARE(EntityCache::STIGChecks().Size(), 4);
+    QVERIFY(EntityCache::STIGChecks().Evictions() >= evictions + static_cast<quint64>(checks.count() - 4));
+    QCOMPARE(db.GetSTIGCheck(checks.last().id).cciIds, checks.last().cciIds);
+    EntityCache::STIGChecks().SetCapacity(capacity);
+}
+
+void TestSTIGQter::test15_LogWriter()
+{
+    DbManager db;
+    QSqlDatabase conn = QSqlDatabase::database(QString::number(reinterpret_cast<quint64>(QThread::currentThreadId())));
+    const auto countLogs = [&conn]() {
+        QSqlQuery q(conn);
+        return q.exec(QStringLiteral("SELECT COUNT(*) FROM Log WHERE location = 'test15_LogWriter'")) && q.next() ? q.value(0).toInt() : -1;
+    };
+
+    //the log level is cached and kept current by UpdateVariable()
+    const int logLevel = DbManager::GetLogLevel();
+    QVERIFY(db.UpdateVariable(QStringLiteral("loglevel"), QString::number(logLevel + 1)));
+    QCOMPARE(DbManager::GetLogLevel(), logLevel + 1);
+    QVERIFY(db.UpdateVariable(QStringLiteral("loglevel"), QString::number(logLevel)));
+
+    //records are written by the writer thread in batches
+    LogWriter *writer = LogWriter::Instance();
+    QVERIFY(writer->isRunning());
+    const int before = countLogs();
+    QVERIFY(before >= 0);
+    const quint64 batches = writer->Batches();
+    const int records = 5000;
+    for (int i = 0; i < records; i++)
+        QVERIFY(DbManager::Log(6, QStringLiteral("test15_LogWriter"), "Record " + QString::number(i)));
+    writer->Flush();
+    QCOMPARE(countLogs(), before + records);
+    QVERIFY(writer->Batches() - batches < static_cast<quint64>(records / 10));
+    QCOMPARE(writer->Unwritten(), 0ULL);
+
+    //the writer keeps its connection between batches
+    const int openConnections = DbConnections::OpenCount();
+    QThread::msleep(500);
+    QVERIFY(DbManager::Log(6, QStringLiteral("test15_LogWriter"), QStringLiteral("Idle")));
+    QVERIFY(writer->Flush());
+    QCOMPARE(DbConnections::OpenCount(), openConnections);
+
+    //a suspended writer keeps its records until resumed
+    writer->Suspend();
+    QVERIFY(DbManager::Log(6, QStringLiteral("test15_LogWriter"), QStringLiteral("Suspended")));
+    writer->Resume();
+    writer->Flush();
+    QCOMPARE(countLogs(), before + records + 2);
+}
+
+void TestSTIGQter::test16_SaveLoad()
+{
+    DbManager db;
+    const int stigs = db.GetSTIGs().count();
+    const int checks = db.CountSTIGChecks();
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    //the save file is chunked and carries the hash of the saved database
+    const QString saveFile = dir.filePath(QStringLiteral("test16.stigqter"));
+    qint64 lastDone = -1;
+    qint64 lastTotal = 0;
+    QVERIFY(db.SaveDB(saveFile, [&lastDone, &lastTotal](qint64 done, qint64 total) {
+        QVERIFY(done > lastDone);
+        lastDone = done;
+        lastTotal = total;
+    }));
+    QVERIFY(lastTotal > 0);
+    QCOMPARE(lastDone, lastTotal);
+    QFile saved(saveFile);
+    QVERIFY(saved.open(QFile::ReadOnly));
+    QCOMPARE(saved.read(4), QByteArrayLiteral("STQZ"));
+    saved.close();
+    QCOMPARE(db.GetSaveHash(saveFile), db.HashDB(true));
+
+    //the loaded copy has a different layout but the same assessment
+    QVERIFY(db.LoadDB(saveFile));
+    QCOMPARE(db.GetSTIGs().count(), stigs);
+    QCOMPARE(db.CountSTIGChecks(), checks);
+    QCOMPARE(db.GetSaveHash(saveFile), db.HashDB(true));
+
+    //files written by earlier versions are a single qCompress() block
+    db.HashDB();
+    QFile live(db.GetDBPath());
+    QVERIFY(live.open(QFile::ReadOnly));
+    const QByteArray legacy = qCompress(live.readAll(), 9);
+    live.close();
+    const QString legacyFile = dir.filePath(QStringLiteral("legacy.stigqter"));
+    QFile legacyOut(legacyFile);
+    QVERIFY(legacyOut.open(QFile::WriteOnly));
+    legacyOut.write(legacy);
+    legacyOut.close();
+    QCOMPARE(db.GetSaveHash(legacyFile), QCryptographicHash::hash(legacy, QCryptographicHash::Sha3_256));
+    QVERIFY(db.LoadDB(legacyFile));
+    QCOMPARE(db.GetSTIGs().count(), stigs);
+    QCOMPARE(db.CountSTIGChecks(), checks);
+
+    //the file is not replaced while another connection has it open
+    QSemaphore opened;
+    QSemaphore release;
+    QThread *holder = QThread::create([&opened, &release]() {
+        DbManager holderDb;
+        holderDb.GetVariable(QStringLiteral("version"));
+        opened.release();
+        release.acquire();
+    });
+    holder->start();
+    opened.acquire();
+    QVERIFY(!db.LoadDB(saveFile));
+    QCOMPARE(db.GetSTIGs().count(), stigs);
+    release.release();
+    QVERIFY(holder->wait(60000));
+    delete holder;
+    QVERIFY(db.LoadDB(saveFile));
+    QCOMPARE(db.GetSTIGs().count(), stigs);
+
+    //a damaged file leaves the database in place
+    const QString damagedFile = dir.filePath(QStringLiteral("damaged.stigqter"));
+    QFile damaged(damagedFile);
+    QVERIFY(damaged.open(QFile::WriteOnly));
+    damaged.write(QByteArrayLiteral("STQZ\0\0\0\2\0\0\0\x10not compressed.."));
+    damaged.close();
+    QVERIFY(!db.LoadDB(damagedFile));
+    QCOMPARE(db.GetSTIGs().count(), stigs);
+}
+
+void TestSTIGQter::test17_HashDB()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    Asset asset;
+    asset.hostName = QStringLiteral("HASH-ASSET");
+    QVERIFY(db.AddAsset(asset));
+    asset = db.GetAsset(asset.hostName);
+    QVERIFY(db.AddSTIGToAsset(stig, asset));
+
+    //the file hash is a plain SHA3-256 of the checkpointed file
+    const QByteArray fileHash = db.HashDB();
+    QFile live(db.GetDBPath());
+    QVERIFY(live.open(QFile::ReadOnly));
+    QCOMPARE(fileHash, QCryptographicHash::hash(live.readAll(), QCryptographicHash::Sha3_256));
+    live.close();
+
+    //the assessment hash does not depend on the page layout or on unrelated tables
+    const QByteArray assessment = db.HashDB(true);
+    QVERIFY(!assessment.isEmpty());
+    QVERIFY(DbManager::Log(6, QStringLiteral("test17_HashDB"), QStringLiteral("Not part of the assessment")));
+    QCOMPARE(db.HashDB(true), assessment);
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString saveFile = dir.filePath(QStringLiteral("test17.stigqter"));
+    QVERIFY(db.SaveDB(saveFile));
+    QVERIFY(db.LoadDB(saveFile));
+    QCOMPARE(db.HashDB(true), assessment);
+
+    //changing a finding changes the assessment hash
+    QVector<CKLCheck> checks = db.GetCKLChecks(asset);
+    QVERIFY(!checks.isEmpty());
+    CKLCheck check = checks.first();
+    //the first update may store empty text where the import stored NULL
+    QVERIFY(db.UpdateCKLCheck(check));
+    const QByteArray updated = db.HashDB(true);
+    const Status status = check.status;
+    check.status = status == Status::Open ? Status::NotAFinding : Status::Open;
+    QVERIFY(db.UpdateCKLCheck(check));
+    QVERIFY(db.HashDB(true) != updated);
+    check.status = status;
+    QVERIFY(db.UpdateCKLCheck(check));
+    QCOMPARE(db.HashDB(true), updated);
+
+    QVERIFY(db.DeleteSTIGFromAsset(stig, asset));
+    QVERIFY(db.DeleteAsset(asset));
+}
+
+void TestSTIGQter::test18_Search()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    Asset asset;
+    asset.hostName = QStringLiteral("SEARCH-ASSET");
+    QVERIFY(db.AddAsset(asset));
+    asset = db.GetAsset(asset.hostName);
+    QVERIFY(db.AddSTIGToAsset(stig, asset));
+
+    //the rule text is indexed when the STIG is imported
+    const STIGCheck rule = db.GetSTIGChecks(stig).first();
+    QElapsedTimer timer;
+    timer.start();
+    QVector<SearchHit> hits = db.Search(rule.rule);
+    const qint64 elapsed = timer.nsecsElapsed();
+    QVERIFY(std::any_of(hits.cbegin(), hits.cend(), [&rule](const SearchHit &hit) {
+        return hit.stigCheckId == rule.id && hit.cklCheckId < 0 && hit.stigId == rule.STIGId && hit.snippet.contains('[');
+    }));
+    qInfo().noquote() << hits.count() << "hits for" << rule.rule << "in" << elapsed / 1000000.0 << "ms";
+    const QVector<int> stigIds = db.SearchSTIGs(rule.rule);
+    QVERIFY(stigIds.contains(stig.id));
+    QCOMPARE(QSet<int>(stigIds.cbegin(), stigIds.cend()).count(), stigIds.count());
+
+    //operators in the user's text are matched literally
+    QVERIFY(db.Search(QStringLiteral("qzxnomatch OR rule")).isEmpty());
+    QVERIFY(db.Search(QStringLiteral("   ")).isEmpty());
+
+    //answers are indexed as they change
+    CKLCheck check = db.GetCKLChecks(asset).first();
+    check.findingDetails = QStringLiteral("Verified with qzxsearchtoken on the host.");
+    QVERIFY(db.UpdateCKLCheck(check));
+    hits = db.Search(QStringLiteral("qzxsearch"));
+    QCOMPARE(hits.count(), 1);
+    QCOMPARE(hits.first().cklCheckId, check.id);
+    QCOMPARE(hits.first().assetId, asset.id);
+    QVERIFY(hits.first().snippet.contains(QStringLiteral("[qzxsearchtoken]")));
+    QCOMPARE(db.SearchSTIGs(QStringLiteral("qzxsearch")), QVector<int>{stig.id});
+    QCOMPARE(db.SearchAssets(QStringLiteral("qzxsearch")), QVector<int>{asset.id});
+
+    //the asset search covers both the answers and the rules of its checks, once per check
+    hits = db.Search(QStringLiteral("qzxsearchtoken"), 50, &asset);
+    QCOMPARE(hits.count(), 1);
+    hits = db.Search(check.GetSTIGCheck().rule, 50, &asset);
+    QVERIFY(!hits.isEmpty());
+    QSet<int> seen;
+    for (const SearchHit &hit : std::as_const(hits))
+    {
+        QCOMPARE(hit.assetId, asset.id);
+        QVERIFY(!seen.contains(hit.cklCheckId));
+        seen.insert(hit.cklCheckId);
+    }
+
+    //a negative limit returns every matching check
+    QCOMPARE(db.Search(QStringLiteral("the"), 1, &asset).count(), 1);
+    QVERIFY(db.Search(QStringLiteral("the"), -1, &asset).count() > 1);
+
+    check.findingDetails = QStringLiteral("Replaced.");
+    QVERIFY(db.UpdateCKLCheck(check));
+    QVERIFY(db.Search(QStringLiteral("qzxsearchtoken")).isEmpty());
+    check.comments = QStringLiteral("qzxsearchtoken");
+    QVERIFY(db.UpdateCKLCheck(check));
+    QCOMPARE(db.Search(QStringLiteral("qzxsearchtoken")).count(), 1);
+
+    //removed checks leave the index
+    QVERIFY(db.DeleteSTIGFromAsset(stig, asset));
+    QVERIFY(db.Search(QStringLiteral("qzxsearchtoken")).isEmpty());
+    QVERIFY(db.DeleteAsset(asset));
+}
+
+void TestSTIGQter::test19_QueryStats()
+{
+#ifdef STIGQTER_QUERY_STATS
+    QueryStats::Reset();
+    const int threshold = QueryStats::Threshold();
+    QueryStats::SetThreshold(0); //log every statement as slow
+    DbManager db;
+    const QVector<STIG> stigs = db.GetSTIGs();
+    QueryStats::SetThreshold(threshold);
+    QVERIFY(!stigs.isEmpty());
+
+    const QJsonObject stats = QJsonDocument::fromJson(QueryStats::Dump()).object();
+    QCOMPARE(stats.value(QStringLiteral("thresholdMs")).toInt(), threshold);
+    bool found = false;
+    for (const auto &thread : stats.value(QStringLiteral("threads")).toArray())
+    {
+        if (thread.toObject().value(QStringLiteral("thread")).toString() != QStringLiteral("main"))
+            continue;
+        for (const auto &value : thread.toObject().value(QStringLiteral("statements")).toArray())
+        {
+            const QJsonObject statement = value.toObject();
+            if (!statement.value(QStringLiteral("sql")).toString().contains(QStringLiteral("FROM STIG")))
+                continue;
+            found = true;
+            QVERIFY(statement.value(QStringLiteral("executions")).toDouble() >= 1);
+            QVERIFY(statement.value(QStringLiteral("rows")).toDouble() >= stigs.count());
+            double histogram = 0;
+            for (const auto &count : statement.value(QStringLiteral("histogram")).toArray())
+                histogram += count.toDouble();
+            QCOMPARE(histogram, statement.value(QStringLiteral("executions")).toDouble());
+        }
+    }
+    QVERIFY(found);
+
+    const QJsonArray slow = stats.value(QStringLiteral("slowQueries")).toArray();
+    QVERIFY(!slow.isEmpty());
+    QVERIFY(std::any_of(slow.begin(), slow.end(), [](const QJsonValue &value) {
+        return !value.toObject().value(QStringLiteral("plan")).toArray().isEmpty();
+    }));
+
+    //finished threads are merged into one entry rather than kept one by one
+    for (int i = 0; i < 3; i++)
+    {
+        QThread *worker = QThread::create([]() {
+            DbManager workerDb;
+            workerDb.GetVariable(QStringLiteral("version"));
+        });
+        worker->setObjectName(QStringLiteral("QueryStatsWorker"));
+        worker->start();
+        QVERIFY(worker->wait(60000));
+        delete worker;
+    }
+    const auto retiredExecutions = []() {
+        double ret = -1;
+        for (const auto &value : QueryStats::ToJson().value(QStringLiteral("threads")).toArray())
+        {
+            const QJsonObject thread = value.toObject();
+            if (thread.value(QStringLiteral("thread")).toString() == QStringLiteral("QueryStatsWorker"))
+                return -1.0;
+            if (thread.value(QStringLiteral("thread")).toString() != QStringLiteral("finished threads"))
+                continue;
+            ret = 0;
+            for (const auto &statement : thread.value(QStringLiteral("statements")).toArray())
+            {
+                if (statement.toObject().value(QStringLiteral("sql")).toString().contains(QStringLiteral("FROM variables")))
+                    ret += statement.toObject().value(QStringLiteral("executions")).toDouble();
+            }
+        }
+        return ret;
+    };
+    //thread-local storage is released just after the thread reports that it finished
+    QTRY_VERIFY(retiredExecutions() >= 3);
+
+    QueryStats::Reset();
+    QVERIFY(QueryStats::ToJson().value(QStringLiteral("slowQueries")).toArray().isEmpty());
+#else
+    QSKIP("Built without CONFIG+=query_stats");
+#endif
+}
+
+void TestSTIGQter::test20_Connections()
+{
+    DbManager db;
+    const int registered = DbConnections::Count();
+    const QString mainConnection = QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()));
+    const QVector<DbConnectionInfo> infos = DbConnections::Connections();
+    QVERIFY(std::any_of(infos.cbegin(), infos.cend(), [&mainConnection](const DbConnectionInfo &info) {
+        return info.name == mainConnection && info.open && info.cacheBytes > 0;
+    }));
+
+    //a worker's connection is removed when its thread finishes
+    QString workerConnection;
+    bool workerRead = false;
+    QThread *worker = QThread::create([&workerConnection, &workerRead]() {
+        DbManager workerDb;
+        workerConnection = QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()));
+        workerRead = !workerDb.GetVariable(QStringLiteral("version")).isEmpty();
+    });
+    worker->start();
+    QVERIFY(worker->wait(60000));
+    delete worker;
+    QVERIFY(workerRead);
+    QVERIFY(!QSqlDatabase::connectionNames().contains(workerConnection));
+    QCOMPARE(DbConnections::Count(), registered);
+
+    //a connection this thread did not create (a recycled thread id) is replaced
+    bool replaced = false;
+    worker = QThread::create([&replaced, &db]() {
+        const QString name = QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()));
+        {
+            QSqlDatabase stale = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
+            Q_UNUSED(stale)
+        }
+        DbManager workerDb;
+        replaced = QSqlDatabase::database(name, false).databaseName() == db.GetDBPath() && !workerDb.GetVariable(QStringLiteral("version")).isEmpty();
+    });
+    worker->start();
+    QVERIFY(worker->wait(60000));
+    delete worker;
+    QVERIFY(replaced);
+    QCOMPARE(DbConnections::Count(), registered);
+
+    //above the cap, a worker waits for another connection to close
+    LogWriter::Instance()->Suspend(); //keep the writer's connection closed
+    const int limit = DbConnections::Limit();
+    DbConnections::SetLimit(DbConnections::OpenCount() + 1);
+    QSemaphore holding;
+    QSemaphore release;
+    std::atomic<bool> opened{false};
+    QThread *first = QThread::create([&holding, &release]() {
+        DbManager firstDb;
+        Q_UNUSED(firstDb)
+        holding.release();
+        release.acquire();
+    });
+    QThread *second = QThread::create([&opened]() {
+        DbManager secondDb;
+        Q_UNUSED(secondDb)
+        opened = true;
+    });
+    first->start();
+    holding.acquire();
+    second->start();
+    QVERIFY(!second->wait(500));
+    QVERIFY(!opened);
+    release.release();
+    QVERIFY(first->wait(60000));
+    QVERIFY(second->wait(60000));
+    QVERIFY(opened);
+    delete first;
+    delete second;
+    DbConnections::SetLimit(limit);
+    LogWriter::Instance()->Resume();
+    QCOMPARE(DbConnections::Count(), registered);
+}
+
+void TestSTIGQter::test21_ComplianceSummary()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    QCOMPARE(db.CheckComplianceSummary(), 0);
+    const QVector<Asset> assets = AddBenchmarkAssets(stig, QStringLiteral("SUMMARY-ASSET-"), 1);
+    QCOMPARE(assets.count(), 1);
+    const Asset &asset = assets.first();
+
+    //mapping the STIG adds its checks as not reviewed
+    const int checks = db.CountSTIGChecks(QStringLiteral("WHERE STIGId = :STIGId"), {std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), stig.id)});
+    ComplianceCounts counts = db.GetComplianceCounts(&asset);
+    QCOMPARE(counts.Total(), checks);
+    QCOMPARE(counts.Count(Status::NotReviewed), checks);
+    QCOMPARE(db.GetComplianceCounts(&asset, &stig).Total(), checks);
+
+    //status and severity changes move the check between counts
+    CKLCheck check = db.GetCKLChecks(asset).first();
+    const Severity severity = check.GetSTIGCheck().severity;
+    const Severity overridden = severity == Severity::high ? Severity::low : Severity::high;
+    check.status = Status::Open;
+    QVERIFY(db.UpdateCKLCheck(check));
+    counts = db.GetComplianceCounts(&asset);
+    QCOMPARE(counts.Count(Status::Open), 1);
+    QCOMPARE(counts.Count(severity, Status::Open), 1);
+    QCOMPARE(counts.Count(Status::NotReviewed), checks - 1);
+    check.severityOverride = overridden;
+    QVERIFY(db.UpdateCKLCheck(check));
+    counts = db.GetComplianceCounts(&asset);
+    QCOMPARE(counts.Count(severity, Status::Open), 0);
+    QCOMPARE(counts.Count(overridden, Status::Open), 1);
+    QCOMPARE(counts.Total(), checks);
+
+    //the summary matches a recount of the checks
+    QElapsedTimer timer;
+    timer.start();
+    int open = 0;
+    for (const CKLCheck &c : db.GetCKLChecks(asset))
+    {
+        if (c.status == Status::Open && c.GetSeverity() == overridden)
+            open++;
+    }
+    const qint64 recount = timer.nsecsElapsed();
+    timer.restart();
+    counts = db.GetComplianceCounts(&asset);
+    const qint64 summary = timer.nsecsElapsed();
+    QCOMPARE(counts.Count(overridden, Status::Open), open);
+    qInfo().noquote() << "Counting" << checks << "checks:" << recount / 1000000.0 << "ms by loading them," << summary / 1000000.0 << "ms from the summary";
+    QCOMPARE(db.CheckComplianceSummary(), 0);
+
+    //drift is detected and repaired by a rebuild
+    {
+        QSqlQuery q(QSqlDatabase::database(QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()))));
+        QVERIFY(q.exec(QStringLiteral("UPDATE ComplianceSummary SET checks = checks + 1")));
+    }
+    QVERIFY(db.CheckComplianceSummary() > 0);
+    QVERIFY(db.RebuildComplianceSummary());
+    QCOMPARE(db.CheckComplianceSummary(), 0);
+    QCOMPARE(db.GetComplianceCounts(&asset).Total(), checks);
+
+    //unmapping the STIG removes its counts
+    QVERIFY(DeleteBenchmarkAssets(stig, assets));
+    QCOMPARE(db.GetComplianceCounts(&asset).Total(), 0);
+    QCOMPARE(db.CheckComplianceSummary(), 0);
+}
+
+void TestSTIGQter::test22_BenchmarkCKLCheckSort()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    const int perAsset = db.CountSTIGChecks(QStringLiteral("WHERE STIGId = :STIGId"), {std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), stig.id)});
+    QVERIFY(perAsset > 0);
+
+    //at least 10k open findings across enough assets
+    const int count = (10000 + perAsset - 1) / perAsset;
+    const QVector<Asset> assets = AddBenchmarkAssets(stig, QStringLiteral("SORT-ASSET-"), count, [](const CKLCheck &) {
+        return Status::Open;
+    });
+    QCOMPARE(assets.count(), count);
+
+    const QString whereClause = QStringLiteral("WHERE CKLCheck.status = :status AND CKLCheck.AssetId IN (SELECT id FROM Asset WHERE hostName LIKE 'SORT-ASSET-%')");
+    QVector<CKLCheck> keyed = db.GetCKLChecks(whereClause, {std::make_tuple<QString, QVariant>(QStringLiteral(":status"), Status::Open)});
+    QCOMPARE(keyed.count(), assets.count() * perAsset);
+
+    //the same findings without the joined rule: each comparison looks up both STIGChecks
+    QVector<CKLCheck> unkeyed;
+    unkeyed.reserve(keyed.count());
+    for (const CKLCheck &c : std::as_const(keyed))
+    {
+        CKLCheck u;
+        u.id = c.id;
+        u.assetId = c.assetId;
+        u.stigCheckId = c.stigCheckId;
+        u.status = c.status;
+        u.severityOverride = c.severityOverride;
+        unkeyed.append(u);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    std::sort(unkeyed.begin(), unkeyed.end());
+    const qint64 perComparison = timer.nsecsElapsed();
+    timer.restart();
+    std::sort(keyed.begin(), keyed.end());
+    const qint64 inMemory = timer.nsecsElapsed();
+
+    //both orders agree on severity and rule (checks of one rule on different assets tie)
+    for (int i = 0; i < keyed.count(); i++)
+    {
+        const CKLCheckSortKey k = keyed.at(i).SortKey();
+        const CKLCheckSortKey u = unkeyed.at(i).SortKey();
+        QCOMPARE(k.severity, u.severity);
+        QCOMPARE(k.rule, u.rule);
+        if (i > 0)
+            QVERIFY(!(keyed.at(i) < keyed.at(i - 1)));
+    }
+    qInfo().noquote() << "Sorting" << keyed.count() << "open findings; database lookups:" << perComparison / 1000000.0 << "ms, sort keys:" << inMemory / 1000000.0 << "ms";
+
+    QVERIFY(DeleteBenchmarkAssets(stig, assets));
+}
+
+void TestSTIGQter::test23_BenchmarkEntityFootprint()
+{
+    //the entities are plain values that a QVector relocates with memmove
+    static_assert(!std::is_base_of<QObject, CKLCheck>::value, "CKLCheck must not be a QObject");
+    static_assert(!std::is_base_of<QObject, STIGCheck>::value, "STIGCheck must not be a QObject");
+    QVERIFY(QTypeInfo<Asset>::isRelocatable);
+    QVERIFY(QTypeInfo<CCI>::isRelocatable);
+    QVERIFY(QTypeInfo<CKLCheck>::isRelocatable);
+    QVERIFY(QTypeInfo<Control>::isRelocatable);
+    QVERIFY(QTypeInfo<Family>::isRelocatable);
+    QVERIFY(QTypeInfo<STIG>::isRelocatable);
+    QVERIFY(QTypeInfo<STIGCheck>::isRelocatable);
+    QVERIFY(QTypeInfo<Supplement>::isRelocatable);
+    qInfo().noquote() << "Per-object size in bytes (a QObject base added" << sizeof(QObject) << "bytes and a heap-allocated private):"
+                      << "Asset" << sizeof(Asset) << "STIG" << sizeof(STIG) << "STIGCheck" << sizeof(STIGCheck)
+                      << "CKLCheck" << sizeof(CKLCheck) << "CCI" << sizeof(CCI) << "Control" << sizeof(Control)
+                      << "Family" << sizeof(Family);
+
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+    const QVector<STIGCheck> checks = stig.GetSTIGChecks();
+    QVERIFY(!checks.isEmpty());
+
+    //copies share the rule text instead of duplicating it
+    QElapsedTimer timer;
+    timer.start();
+    QVector<STIGCheck> copies;
+    for (const STIGCheck &check : checks)
+        copies.append(check);
+    const qint64 copyNsecs = timer.nsecsElapsed();
+    qint64 textBytes = 0;
+    for (int i = 0; i < checks.count(); i++)
+    {
+        const STIGCheck &check = checks.at(i);
+        QVERIFY(copies.at(i).vulnDiscussion.constData() == check.vulnDiscussion.constData());
+        QVERIFY(copies.at(i).check.constData() == check.check.constData());
+        QVERIFY(copies.at(i).fix.constData() == check.fix.constData());
+        textBytes += static_cast<qint64>(check.title.size() + check.vulnDiscussion.size() + check.check.size() + check.fix.size()) * static_cast<qint64>(sizeof(QChar));
+    }
+
+    timer.restart();
+    const QVector<STIGCheck> moved(std::move(copies));
+    const qint64 moveNsecs = timer.nsecsElapsed();
+    QCOMPARE(moved.count(), checks.count());
+    qInfo().noquote() << "Copying" << checks.count() << "STIGChecks:" << copyNsecs / 1000000.0 << "ms, moving them:" << moveNsecs / 1000000.0
+                      << "ms; each copy adds" << sizeof(STIGCheck) << "bytes and shares" << textBytes / checks.count() << "bytes of text";
+
+    //growing a vector without reserving relocates the existing checks
+    constexpr int findings = 100000;
+    timer.restart();
+    QVector<CKLCheck> grown;
+    for (int i = 0; i < findings; i++)
+    {
+        CKLCheck c;
+        c.id = i + 1;
+        c.stigCheckId = checks.at(i % checks.count()).id;
+        grown.append(std::move(c));
+    }
+    const qint64 growNsecs = timer.nsecsElapsed();
+    QCOMPARE(grown.count(), findings);
+    QCOMPARE(grown.last().id, findings);
+    qInfo().noquote() << "Appending" << findings << "CKLChecks:" << growNsecs / 1000000.0 << "ms," << static_cast<qint64>(sizeof(CKLCheck)) * findings / 1024 << "KiB";
+}
+
+void TestSTIGQter::test24_AssessmentSnapshot()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    const QVector<Asset> assets = AddBenchmarkAssets(stig, QStringLiteral("SNAPSHOT-ASSET-"), 3, [](const CKLCheck &check) {
+        const Status statuses[] = {Status::Open, Status::NotAFinding, Status::NotApplicable};
+        return statuses[check.id % 3];
+    });
+    QCOMPARE(assets.count(), 3);
+
+    QElapsedTimer timer;
+    timer.start();
+    const std::shared_ptr<const AssessmentSnapshot> snapshot = db.GetAssessmentSnapshot();
+    const qint64 loadNsecs = timer.nsecsElapsed();
+    QCOMPARE(snapshot->cklChecks.Count(), db.CountCKLChecks());
+    //only the rules of mapped STIGs are loaded
+    QCOMPARE(snapshot->stigChecks.Count(), db.CountSTIGChecks(QStringLiteral("WHERE STIGId IN (SELECT STIGId FROM AssetSTIG)")));
+    QCOMPARE(snapshot->assets.count(), db.GetAssets().count());
+    QCOMPARE(snapshot->ccis.count(), db.GetCCIs().count());
+
+    //each asset's findings match the database, grouped by STIG
+    for (int row = 0; row < snapshot->assets.count(); row++)
+    {
+        const Asset &asset = snapshot->assets.at(row);
+        if (!asset.hostName.startsWith(QStringLiteral("SNAPSHOT-ASSET-")))
+            continue;
+        QCOMPARE(snapshot->assetSTIGs.At(row).count(), 1);
+        QMap<int, CKLCheck> expected;
+        for (const CKLCheck &c : db.GetCKLChecks(asset))
+            expected.insert(c.id, c);
+        QCOMPARE(snapshot->assetCKLChecks.At(row).count(), expected.count());
+        for (int cc : snapshot->assetCKLChecks.At(row))
+        {
+            const CKLCheck loaded = snapshot->CKLCheckAt(cc);
+            QVERIFY(expected.contains(loaded.id));
+            const CKLCheck &c = expected.value(loaded.id);
+            QCOMPARE(loaded.status, c.status);
+            QCOMPARE(loaded.GetSeverity(), c.GetSeverity());
+            QCOMPARE(loaded.SortKey().rule, c.SortKey().rule);
+            QCOMPARE(snapshot->CKLCheckSTIG(cc), *snapshot->assetSTIGs.At(row).begin());
+        }
+    }
+
+    //the CCIs of each rule keep their mapping
+    for (const STIGCheck &check : stig.GetSTIGChecks())
+    {
+        const int row = static_cast<int>(std::lower_bound(snapshot->stigChecks.id.begin(), snapshot->stigChecks.id.end(), check.id) - snapshot->stigChecks.id.begin());
+        QVERIFY(row < snapshot->stigChecks.Count());
+        QCOMPARE(snapshot->STIGCheckAt(row).cciIds, check.cciIds);
+    }
+
+    //the reports share the one snapshot across threads
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QStringList files = {dir.filePath(QStringLiteral("emass.xlsx")), dir.filePath(QStringLiteral("cmrs.xml"))};
+    QVector<QThread *> threads = {
+        QThread::create([&snapshot, &files]() {
+            WorkerEMASSReport w;
+            w.SetReportName(files.at(0));
+            w.SetSnapshot(snapshot);
+            w.process();
+        }),
+        QThread::create([&snapshot, &files]() {
+            WorkerCMRSExport w;
+            w.SetExportPath(files.at(1));
+            w.SetSnapshot(snapshot);
+            w.process();
+        })
+    };
+    timer.restart();
+    for (QThread *thread : std::as_const(threads))
+        thread->start();
+    for (QThread *thread : std::as_const(threads))
+    {
+        QVERIFY(thread->wait(300000));
+        delete thread;
+    }
+    const qint64 reportNsecs = timer.nsecsElapsed();
+    for (const QString &file : files)
+        QVERIFY(QFileInfo(file).size() > 0);
+
+    qInfo().noquote() << "Loading the snapshot of" << snapshot->cklChecks.Count() << "findings:" << loadNsecs / 1000000.0 << "ms with"
+                      << snapshot->strings.count() << "distinct strings; two reports from it:" << reportNsecs / 1000000.0 << "ms";
+
+    QVERIFY(DeleteBenchmarkAssets(stig, assets));
+}
+
+void TestSTIGQter::test25_STIGCheckHeaders()
+{
+    STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    DbManager db;
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<STIGCheck> checks = db.GetSTIGChecks(stig);
+    const qint64 fullNsecs = timer.nsecsElapsed();
+    timer.restart();
+    const QVector<STIGCheckHeader> headers = db.GetSTIGCheckHeaders(stig);
+    const qint64 headerNsecs = timer.nsecsElapsed();
+
+    //the headers carry the identifying fields of the same checks
+    QCOMPARE(headers.count(), checks.count());
+    QHash<int, STIGCheckHeader> byId;
+    qint64 headerBytes = 0;
+    for (const STIGCheckHeader &h : headers)
+    {
+        byId.insert(h.id, h);
+        headerBytes += static_cast<qint64>(sizeof(STIGCheckHeader)) + static_cast<qint64>(h.rule.size() + h.ruleVersion.size() + h.vulnNum.size() + h.title.size()) * static_cast<qint64>(sizeof(QChar));
+    }
+    qint64 fullBytes = 0;
+    for (const STIGCheck &c : checks)
+    {
+        QVERIFY(byId.contains(c.id));
+        const STIGCheckHeader h = byId.value(c.id);
+        QCOMPARE(h.stigId, c.stigId);
+        QCOMPARE(h.rule, c.rule);
+        QCOMPARE(h.ruleVersion, c.ruleVersion);
+        QCOMPARE(h.vulnNum, c.vulnNum);
+        QCOMPARE(h.title, c.title);
+        QCOMPARE(h.severity, c.severity);
+        QCOMPARE(PrintSTIGCheck(h), PrintSTIGCheck(c));
+        fullBytes += static_cast<qint64>(sizeof(STIGCheck)) + static_cast<qint64>(c.rule.size() + c.ruleVersion.size() + c.vulnNum.size() + c.title.size() + c.vulnDiscussion.size() + c.fix.size() + c.check.size()) * static_cast<qint64>(sizeof(QChar));
+    }
+    QCOMPARE(stig.GetSTIGCheckHeaders().count(), headers.count());
+    qInfo().noquote() << "Listing" << checks.count() << "STIGChecks:" << fullNsecs / 1000000.0 << "ms and" << fullBytes / 1024 << "KiB as full checks,"
+                      << headerNsecs / 1000000.0 << "ms and" << headerBytes / 1024 << "KiB as headers";
+
+    //a check's list entry is its rule, without reading the STIGCheck
+    Asset asset;
+    asset.hostName = QStringLiteral("HEADER-ASSET");
+    QVERIFY(db.AddAsset(asset));
+    asset = db.GetAsset(asset.hostName);
+    QVERIFY(db.AddSTIGToAsset(stig, asset));
+    for (const CKLCheck &c : db.GetCKLChecks(asset))
+        QCOMPARE(PrintCKLCheck(c), byId.value(c.stigCheckId).rule);
+    QVERIFY(db.DeleteSTIGFromAsset(stig, asset));
+    QVERIFY(db.DeleteAsset(asset));
+}
+
+void TestSTIGQter::test26_ParallelSTIGAdd()
+{
+    QVERIFY(LoadBenchmarkSTIG().id > 0);
+    const QStringList archives = {QStringLiteral("tests/U_ASD_V5R1_STIG.zip"), QStringLiteral("tests/U_ASD_V5R2_STIG.zip")};
+    const QString whereClause = QStringLiteral("WHERE fileName LIKE 'U_ASD_STIG_V5R_%'");
+
+    //the STIGs of the archives in insertion order, with their rules and CCIs
+    auto importArchives = [&archives, &whereClause](int threads, qint64 &nsecs) {
+        DbManager db;
+        {
+            WorkerSTIGDelete wd;
+            for (const STIG &stig : db.GetSTIGs(whereClause))
+                wd.AddId(stig.id);
+            wd.process();
+        }
+        QElapsedTimer timer;
+        timer.start();
+        WorkerSTIGAdd wa;
+        wa.SetParserThreads(threads);
+        wa.AddSTIGs(archives);
+        wa.process();
+        nsecs = timer.nsecsElapsed();
+
+        QStringList ret;
+        QVector<STIG> stigs = db.GetSTIGs(whereClause);
+        std::sort(stigs.begin(), stigs.end(), [](const STIG &left, const STIG &right) { return left.id < right.id; });
+        for (const STIG &stig : std::as_const(stigs))
+        {
+            ret.append(stig.fileName);
+            for (const STIGCheck &check : stig.GetSTIGChecks())
+            {
+                QStringList ccis;
+                for (const CCI &cci : check.GetCCIs())
+                    ccis.append(PrintCCI(cci));
+                ret.append(check.rule + ": " + ccis.join(QStringLiteral(", ")));
+            }
+        }
+        return ret;
+    };
+
+    qint64 sequentialNsecs = 0;
+    const QStringList sequential = importArchives(1, sequentialNsecs);
+    qint64 parallelNsecs = 0;
+    const QStringList parallel = importArchives(QThread::idealThreadCount(), parallelNsecs);
+
+    //both STIGs are added, in queue order, with the same checks
+    QCOMPARE(sequential.count(QStringLiteral("U_ASD_STIG_V5R1_Manual-xccdf.xml")), 1);
+    QCOMPARE(sequential.count(QStringLiteral("U_ASD_STIG_V5R2_Manual-xccdf.xml")), 1);
+    QVERIFY(sequential.indexOf(QStringLiteral("U_ASD_STIG_V5R1_Manual-xccdf.xml")) < sequential.indexOf(QStringLiteral("U_ASD_STIG_V5R2_Manual-xccdf.xml")));
+    QCOMPARE(parallel, sequential);
+    qInfo().noquote() << "Importing" << archives.count() << "archives:" << sequentialNsecs / 1000000.0 << "ms with 1 parser thread,"
+                      << parallelNsecs / 1000000.0 << "ms with" << QThread::idealThreadCount();
+}
+
+void TestSTIGQter::test27_InMemoryZip()
+{
+    const QString archive = QStringLiteral("tests/U_ASD_V5R2_STIG.zip");
+    QFile file(archive);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray zipData = file.readAll();
+    file.close();
+
+    //a zip file in memory lists and extracts the same as the file on disk
+    const ZipArchive onDisk(archive);
+    const ZipArchive inMemory(zipData);
+    QVERIFY(onDisk.IsOpen());
+    QVERIFY(inMemory.IsOpen());
+    const QVector<ZipEntry> entries = onDisk.Entries();
+    QVERIFY(!entries.isEmpty());
+    QCOMPARE(inMemory.Entries().count(), entries.count());
+    for (const ZipEntry &entry : entries)
+    {
+        const ZipEntry same = inMemory.Entry(entry.name);
+        QVERIFY(same.IsValid());
+        QCOMPARE(same.size, entry.size);
+        const QByteArray contents = onDisk.Read(entry);
+        QCOMPARE(static_cast<qint64>(contents.size()), entry.size);
+        QCOMPARE(inMemory.Read(same), contents);
+
+        //a streamed entry reads the same as the extracted one
+        std::unique_ptr<QIODevice> device = inMemory.Open(same);
+        QVERIFY(device != nullptr);
+        QVERIFY(device->isSequential());
+        QCOMPARE(device->readAll(), contents);
+        QVERIFY(device->atEnd());
+    }
+    const QVector<ZipEntry> xccdf = inMemory.Entries(QStringLiteral("-XCCDF.XML"));
+    QCOMPARE(xccdf.count(), 1);
+    QCOMPARE(onDisk.Entries(QStringLiteral("-xccdf.xml")).first().name, xccdf.first().name);
+
+    //a QXmlStreamReader parses an entry as it is decompressed
+    {
+        std::unique_ptr<QIODevice> device = inMemory.Open(xccdf.first().name);
+        QVERIFY(device != nullptr);
+        QXmlStreamReader xml(device.get());
+        int groups = 0;
+        while (!xml.atEnd() && !xml.hasError())
+        {
+            xml.readNext();
+            if (xml.isStartElement() && xml.name().compare(QStringLiteral("Group")) == 0)
+                groups++;
+        }
+        QVERIFY2(!xml.hasError(), qPrintable(xml.errorString()));
+        QVERIFY(groups > 0);
+    }
+
+    //missing entries and anything that is not a zip file
+    QVERIFY(!inMemory.Entry(QStringLiteral("missing.xml")).IsValid());
+    QVERIFY(inMemory.Open(QStringLiteral("missing.xml")) == nullptr);
+    QVERIFY(inMemory.Read(ZipEntry()).isNull());
+    const ZipArchive notZip(QByteArrayLiteral("not a zip file"));
+    QVERIFY(!notZip.IsOpen());
+    QVERIFY(notZip.Entries().isEmpty());
+    QVERIFY(!ZipArchive(QByteArray()).IsOpen());
+
+    //a STIG added from memory matches the one added from its file
+    const QString whereClause = QStringLiteral("WHERE fileName = 'U_ASD_STIG_V5R2_Manual-xccdf.xml'");
+    auto rules = [&whereClause]() {
+        DbManager db;
+        QStringList ret;
+        for (const STIG &stig : db.GetSTIGs(whereClause))
+        {
+            for (const STIGCheck &check : stig.GetSTIGChecks())
+                ret.append(check.rule);
+        }
+        return ret;
+    };
+    auto deleteSTIGs = [&whereClause]() {
+        DbManager db;
+        WorkerSTIGDelete wd;
+        for (const STIG &stig : db.GetSTIGs(whereClause))
+            wd.AddId(stig.id);
+        wd.process();
+    };
+    deleteSTIGs();
+    {
+        WorkerSTIGAdd wa;
+        wa.AddSTIGs({archive});
+        wa.process();
+    }
+    const QStringList fromFile = rules();
+    QVERIFY(!fromFile.isEmpty());
+    deleteSTIGs();
+    {
+        WorkerSTIGAdd wa;
+        wa.AddSTIG(QFileInfo(archive).fileName(), zipData);
+        wa.process();
+    }
+    QCOMPARE(rules(), fromFile);
+}
+
+void TestSTIGQter::test28_CCILookup()
+{
+    QVERIFY(LoadBenchmarkSTIG().id > 0);
+    DbManager db;
+
+    //every CCI resolves to the id the per-CCI query returns
+    const std::shared_ptr<const CCILookup> ccis = db.GetCCILookup();
+    QVERIFY(ccis != nullptr);
+    const QVector<CCI> all = db.GetCCIs();
+    QVERIFY(!all.isEmpty());
+    QCOMPARE(ccis->Count(), static_cast<int>(all.count()));
+    for (const CCI &cci : all)
+        QCOMPARE(ccis->Id(cci.cci), cci.id);
+    QCOMPARE(ccis->Id(-1), -1);
+    QCOMPARE(ccis->Id(999999), -1);
+
+    //the table is loaded once and shared until the CCIs change
+    QVERIFY(db.GetCCILookup() == ccis);
+    CCI fake;
+    fake.cci = 999999;
+    fake.controlId = all.first().controlId;
+    fake.definition = QStringLiteral("Not a real CCI");
+    {
+        DbTransaction transaction;
+        QVERIFY(db.AddCCI(fake));
+        //this thread sees its own uncommitted CCI, but it is not cached
+        const std::shared_ptr<const CCILookup> uncommitted = db.GetCCILookup();
+        QVERIFY(uncommitted != ccis);
+        QVERIFY(uncommitted->Id(fake.cci) > 0);
+        QVERIFY(db.GetCCILookup() != uncommitted);
+        QVERIFY(transaction.Rollback());
+    }
+    const std::shared_ptr<const CCILookup> reloaded = db.GetCCILookup();
+    QCOMPARE(reloaded->Id(fake.cci), -1);
+    QCOMPARE(reloaded->Count(), ccis->Count());
+    QVERIFY(db.GetCCILookup() == reloaded);
+
+    //tables already handed out are not changed
+    QVERIFY(ccis->Id(all.first().cci) == all.first().id);
+
+    //sparse CCI numbers
+    CCILookup lookup;
+    lookup.Insert(5, 50);
+    lookup.Insert(5000000, 7);
+    lookup.Insert(5, 51);
+    QCOMPARE(lookup.Count(), 2);
+    QCOMPARE(lookup.Id(5), 51);
+    QCOMPARE(lookup.Id(5000000), 7);
+    QCOMPARE(lookup.Id(4), -1);
+}
+
+void TestSTIGQter::test29_VulnDescriptionScanner()
+{
+    //both parsers start from the same check, so fields they leave alone compare equal
+    auto compare = [](const QString &description, bool documentable) {
+        STIGCheck expected;
+        expected.vulnDiscussion = expected.falsePositives = expected.falseNegatives = expected.mitigations = QStringLiteral("unset");
+        expected.severityOverrideGuidance = expected.potentialImpact = expected.thirdPartyTools = QStringLiteral("unset");
+        expected.mitigationControl = expected.responsibility = QStringLiteral("unset");
+        expected.documentable = documentable;
+        STIGCheck actual = expected;
+        LegacyVulnDescription(description, expected);
+        WorkerSTIGAdd::ParseVulnDescription(description, actual);
+        return expected.vulnDiscussion == actual.vulnDiscussion &&
+                expected.falsePositives == actual.falsePositives &&
+                expected.falseNegatives == actual.falseNegatives &&
+                expected.documentable == actual.documentable &&
+                expected.mitigations == actual.mitigations &&
+                expected.severityOverrideGuidance == actual.severityOverrideGuidance &&
+                expected.potentialImpact == actual.potentialImpact &&
+                expected.thirdPartyTools == actual.thirdPartyTools &&
+                expected.mitigationControl == actual.mitigationControl &&
+                expected.responsibility == actual.responsibility;
+    };
+
+    //a well-formed description
+    const QString wellFormed = QStringLiteral("<VulnDiscussion> Apps & \"tools\" <b>can</b> fail.\r\nTwice. </VulnDiscussion><FalsePositives></FalsePositives><Documentable>TRUE</Documentable><Mitigations>None</Mitigations><Responsibility>Admin</Responsibility>");
+    QVERIFY(compare(wellFormed, false));
+    STIGCheck check;
+    WorkerSTIGAdd::ParseVulnDescription(wellFormed, check);
+    QCOMPARE(check.vulnDiscussion, QStringLiteral("Apps & \"tools\" <b>can</b> fail.\nTwice."));
+    QVERIFY(check.falsePositives.isEmpty());
+    QVERIFY(check.documentable);
+    QCOMPARE(check.responsibility, QStringLiteral("Admin"));
+
+    //random descriptions built from tags (known, unknown, and malformed) and text
+    const QStringList tags = {QStringLiteral("VulnDiscussion"), QStringLiteral("FalsePositives"), QStringLiteral("FalseNegatives"), QStringLiteral("Documentable"), QStringLiteral("Mitigations"), QStringLiteral("SeverityOverrideGuidance"), QStringLiteral("PotentialImpacts"), QStringLiteral("ThirdPartyTools"), QStringLiteral("MitigationControl"), QStringLiteral("Responsibility")};
+    QStringList fragments = {
+        QStringLiteral("text"), QStringLiteral("true"), QStringLiteral("False"), QStringLiteral(" "), QStringLiteral("\t"), QStringLiteral("\n"), QStringLiteral("\r"), QStringLiteral("\r\n"),
+        QStringLiteral("&"), QStringLiteral("&amp;"), QStringLiteral("&lt;VulnDiscussion&gt;"), QStringLiteral("&#60;"), QStringLiteral("'"), QStringLiteral("\""),
+        QStringLiteral("<"), QStringLiteral(">"), QStringLiteral("/"), QStringLiteral("]]>"), QStringLiteral("<![CDATA[x]]>"), QStringLiteral("<!-- x -->"), QStringLiteral("<?pi x?>"),
+        QStringLiteral("<IAControls>"), QStringLiteral("</IAControls>"), QStringLiteral("<VulnDescription>"), QStringLiteral("</VulnDescription>"),
+        QStringLiteral("<VulnDiscussion/>"), QStringLiteral("<vulndiscussion>"), QStringLiteral("< VulnDiscussion>"), QStringLiteral("<VulnDiscussion >"), QStringLiteral("<Vuln"), QStringLiteral("</Mitigation>"),
+        QStringLiteral("<Mitigations"), QStringLiteral("<<Mitigations>>"), QStringLiteral("</</Mitigations>"), QStringLiteral("\u00e9"), QStringLiteral("\u65e5\u672c"), QStringLiteral("\U0001F512")
+    };
+    for (const QString &tag : tags)
+    {
+        fragments.append("<" + tag + ">");
+        fragments.append("</" + tag + ">");
+    }
+
+    QRandomGenerator random(20260101);
+    const int cases = 20000;
+    for (int i = 0; i < cases; i++)
+    {
+        QString description;
+        if (i % 2 == 0)
+        {
+            //mostly well-formed: fields with text, and an occasional stray fragment
+            const int fields = static_cast<int>(random.bounded(6));
+            for (int j = 0; j < fields; j++)
+            {
+                const QString &tag = tags.at(static_cast<int>(random.bounded(static_cast<int>(tags.count()))));
+                description.append("<" + tag + ">");
+                const int words = static_cast<int>(random.bounded(4));
+                for (int k = 0; k < words; k++)
+                    description.append(fragments.at(static_cast<int>(random.bounded(20))));
+                if (random.bounded(10) == 0)
+                    description.append(fragments.at(static_cast<int>(random.bounded(static_cast<int>(fragments.count())))));
+                if (random.bounded(20) != 0)
+                    description.append("</" + tag + ">");
+            }
+        }
+        else
+        {
+            const int length = static_cast<int>(random.bounded(24));
+            for (int j = 0; j < length; j++)
+                description.append(fragments.at(static_cast<int>(random.bounded(static_cast<int>(fragments.count())))));
+        }
+        //the descriptions are read trimmed from the STIG
+        description = description.trimmed();
+        QVERIFY2(compare(description, i % 4 < 2), qPrintable(description));
+    }
+
+    //every rule of a real STIG
+    ZipArchive archive(QStringLiteral("tests/U_ASD_V5R2_STIG.zip"));
+    const QVector<ZipEntry> xccdf = archive.Entries(QStringLiteral("-xccdf.xml"));
+    QCOMPARE(xccdf.count(), 1);
+    QStringList descriptions;
+    {
+        std::unique_ptr<QIODevice> device = archive.Open(xccdf.first());
+        QVERIFY(device != nullptr);
+        QXmlStreamReader xml(device.get());
+        bool inRule = false;
+        while (!xml.atEnd() && !xml.hasError())
+        {
+            xml.readNext();
+            if (xml.isStartElement() && xml.name().compare(QStringLiteral("Rule")) == 0)
+                inRule = true;
+            else if (xml.isEndElement() && xml.name().compare(QStringLiteral("Rule")) == 0)
+                inRule = false;
+            else if (inRule && xml.isStartElement() && xml.name().compare(QStringLiteral("description")) == 0)
+                descriptions.append(xml.readElementText().trimmed());
+        }
+        QVERIFY(!xml.hasError());
+    }
+    QVERIFY(!descriptions.isEmpty());
+    for (const QString &description : std::as_const(descriptions))
+        QVERIFY2(compare(description, false), qPrintable(description));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const QString &description : std::as_const(descriptions))
+    {
+        STIGCheck c;
+        LegacyVulnDescription(description, c);
+    }
+    const qint64 legacyNsecs = timer.nsecsElapsed();
+    timer.restart();
+    for (const QString &description : std::as_const(descriptions))
+    {
+        STIGCheck c;
+        WorkerSTIGAdd::ParseVulnDescription(description, c);
+    }
+    const qint64 scannerNsecs = timer.nsecsElapsed();
+    qInfo().noquote() << "Parsing" << descriptions.count() << "rule descriptions:" << legacyNsecs / 1000000.0 << "ms escaped and read as XML,"
+                      << scannerNsecs / 1000000.0 << "ms scanned";
+}
+
+void TestSTIGQter::test30_StatementCache()
+{
+    DbManager db;
+    QVERIFY(!db.GetVariable(QStringLiteral("version")).isEmpty());
+    const QString connection = QString::number(reinterpret_cast<quint64>(QThread::currentThreadId()));
+    const QSqlDatabase conn = QSqlDatabase::database(connection);
+    const int capacity = DbQuery::CacheCapacity();
+    const QString select = QStringLiteral("SELECT name, value FROM variables WHERE name = :name");
+    const auto selectStatement = [](int i) {
+        return "SELECT value FROM variables WHERE name = 'statement" + QString::number(i) + "'";
+    };
+
+    DbQuery::ClearCache(connection);
+    QCOMPARE(DbQuery::CacheSize(connection), 0);
+
+    //a nested query with the same SQL prepares its own statement
+    quint64 misses = DbQuery::CacheMisses();
+    {
+        DbQuery outer(conn);
+        QVERIFY(outer.prepare(select));
+        outer.bindValue(QStringLiteral(":name"), QStringLiteral("version"));
+        QVERIFY(outer.exec());
+        QVERIFY(outer.next());
+        {
+            DbQuery inner(conn);
+            QVERIFY(inner.prepare(select));
+            inner.bindValue(QStringLiteral(":name"), QStringLiteral("loglevel"));
+            QVERIFY(inner.exec());
+            QVERIFY(inner.next());
+            QCOMPARE(inner.value(0).toString(), QStringLiteral("loglevel"));
+        }
+        QCOMPARE(DbQuery::CacheMisses(), misses + 2);
+        //the outer result is unaffected by the inner one
+        QCOMPARE(outer.value(0).toString(), QStringLiteral("version"));
+        QVERIFY(!outer.next());
+    }
+    //both copies were returned, and the second one replaced the first
+    QCOMPARE(DbQuery::CacheSize(connection), 1);
+
+    //preparing other SQL resets the held statement and returns it for reuse
+    quint64 hits = DbQuery::CacheHits();
+    {
+        DbQuery q(conn);
+        QVERIFY(q.prepare(select));
+        q.bindValue(QStringLiteral(":name"), QStringLiteral("version"));
+        QVERIFY(q.exec());
+        QVERIFY(q.next());
+        QVERIFY(q.prepare(selectStatement(0)));
+        QVERIFY(q.exec());
+        QVERIFY(!q.next());
+
+        DbQuery reused(conn);
+        QVERIFY(reused.prepare(select));
+        QCOMPARE(DbQuery::CacheHits(), hits + 2);
+        QVERIFY(!reused.isActive());
+        reused.bindValue(QStringLiteral(":name"), QStringLiteral("loglevel"));
+        QVERIFY(reused.exec());
+        QVERIFY(reused.next());
+        QCOMPARE(reused.value(0).toString(), QStringLiteral("loglevel"));
+    }
+    QCOMPARE(DbQuery::CacheSize(connection), 2);
+
+    //the least recently used statements are finalized beyond the capacity
+    DbQuery::SetCacheCapacity(3);
+    for (int i = 0; i < 5; i++)
+    {
+        DbQuery q(conn);
+        QVERIFY(q.prepare(selectStatement(i)));
+        QVERIFY(q.exec());
+    }
+    QCOMPARE(DbQuery::CacheSize(connection), 3);
+    hits = DbQuery::CacheHits();
+    misses = DbQuery::CacheMisses();
+    {
+        DbQuery q(conn);
+        QVERIFY(q.prepare(selectStatement(4)));
+        QVERIFY(q.prepare(selectStatement(2)));
+        QVERIFY(q.prepare(selectStatement(1)));
+        QVERIFY(q.prepare(select));
+    }
+    QCOMPARE(DbQuery::CacheHits(), hits + 2);
+    QCOMPARE(DbQuery::CacheMisses(), misses + 2);
+    QCOMPARE(DbQuery::CacheSize(connection), 3);
+    DbQuery::SetCacheCapacity(1);
+    QCOMPARE(DbQuery::CacheSize(connection), 1);
+    DbQuery::SetCacheCapacity(capacity);
+
+    DbQuery::ClearCache(connection);
+    QCOMPARE(DbQuery::CacheSize(connection), 0);
+    QVERIFY(!db.GetVariable(QStringLiteral("version")).isEmpty());
+    QVERIFY(DbQuery::CacheSize(connection) > 0);
+}
+
+void TestSTIGQter::test31_BulkInsertPayload()
+{
+    const STIG stig = LoadBenchmarkSTIG();
+    QVERIFY(stig.id > 0);
+
+    //three 3 MiB files followed by small ones
+    QVector<QVariantList> rows;
+    for (int i = 0; i < 3; i++)
+        rows.append({stig.id, "large" + QString::number(i), QByteArray(3 * 1024 * 1024, 'x')});
+    for (int i = 0; i < 100; i++)
+        rows.append({stig.id, "small" + QString::number(i), QByteArray(16, 'y')});
+
+    DbManager db;
+    const int supplements = db.GetSupplements(stig).count();
+    DbTransaction transaction;
+    QVector<int> ids;
+    DbQuery::StartCapture();
+    QVERIFY(db.BulkInsert(QStringLiteral("Supplement"), {QStringLiteral("STIGId"), QStringLiteral("path"), QStringLiteral("contents")}, rows, &ids));
+    const QStringList statements = DbQuery::StopCapture().filter(QStringLiteral("INSERT INTO `Supplement`"));
+
+    //each large file is inserted on its own; the small ones still share a statement
+    QCOMPARE(statements.count(), 3);
+    QCOMPARE(statements.last().count(QStringLiteral("(?, ?, ?)")), 101);
+    QCOMPARE(ids.count(), rows.count());
+    QVERIFY(!ids.contains(-1));
+    QCOMPARE(db.GetSupplements(stig).count(), supplements + rows.count());
+    QVERIFY(transaction.Rollback());
+    QCOMPARE(db.GetSupplements(stig).count(), supplements);
+}
+
 void TestSTIGQter::cleanupTestCase()
 {
     w->close();
@@ -19,8 +19,15 @@
 
 #pragma once
 
+#include "cklcheck.h"
+
+#include <functional>
+
 #include <QObject>
 
+class Asset;
+class STIG;
+class STIGCheck;
 class STIGQter;
 
 class TestSTIGQter : public QObject
@@ -33,15 +40,44 @@ public:
 private:
     STIGQter *w = nullptr;
     void procEvents();
+    STIG LoadBenchmarkSTIG();
+    QVector<Asset> AddBenchmarkAssets(const STIG &stig, const QString &prefix, int count, const std::function<Status (const CKLCheck &)> &status = nullptr);
+    bool DeleteBenchmarkAssets(const STIG &stig, const QVector<Asset> &assets);
+    static void LegacyVulnDescription(const QString &description, STIGCheck &check);
 
 private Q_SLOTS:
     void initTestCase();
     void test01_IndexCCIs();
     void test02_UpdateCCI();
     void test03_IndexSTIGs();
+    void test03a_BenchmarkSTIGIngest();
     void test04_RunInterface();
     void test05_DeleteAndHash();
     void test06_CKLImport();
     void test07_Cleanup();
+    void test08_QueryPlans();
+    void test09_BenchmarkSTIGChecks();
+    void test10_BatchLoaders();
+    void test11_ConcurrentReadWrite();
+    void test12_NestedTransactions();
+    void test13_StreamingCursors();
+    void test14_EntityCache();
+    void test15_LogWriter();
+    void test16_SaveLoad();
+    void test17_HashDB();
+    void test18_Search();
+    void test19_QueryStats();
+    void test20_Connections();
+    void test21_ComplianceSummary();
+    void test22_BenchmarkCKLCheckSort();
+    void test23_BenchmarkEntityFootprint();
+    void test24_AssessmentSnapshot();
+    void test25_STIGCheckHeaders();
+    void test26_ParallelSTIGAdd();
+    void test27_InMemoryZip();
+    void test28_CCILookup();
+    void test29_VulnDescriptionScanner();
+    void test30_StatementCache();
+    void test31_BulkInsertPayload();
     void cleanupTestCase();
 };